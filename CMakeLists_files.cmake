@@ -28,13 +28,16 @@ list (APPEND MAIN_SOURCE_FILES
   opm/autodiff/GridHelpers.cpp
   opm/autodiff/ImpesTPFAAD.cpp
   opm/autodiff/LinearisedBlackoilResidual.cpp
+  opm/autodiff/LocalNewtonRegion.cpp
   opm/autodiff/multiPhaseUpwind.cpp
   opm/autodiff/NewtonIterationBlackoilCPR.cpp
   opm/autodiff/NewtonIterationBlackoilSimple.cpp
   opm/autodiff/NewtonIterationBlackoilInterleaved.cpp
   opm/autodiff/NewtonIterationUtilities.cpp
+  opm/autodiff/PropertyReuseMask.cpp
   opm/autodiff/SimulatorFullyImplicitBlackoilOutput.cpp
   opm/autodiff/SimulatorIncompTwophaseAd.cpp
+  opm/autodiff/TimingRegistry.cpp
   opm/autodiff/TransportSolverTwophaseAd.cpp
   opm/autodiff/VFPInjPropertiesLegacy.cpp
   opm/autodiff/VFPProdPropertiesLegacy.cpp
@@ -72,11 +75,15 @@ list (APPEND MAIN_SOURCE_FILES
   opm/core/props/satfunc/SaturationPropsBasic.cpp
   opm/core/simulator/TwophaseState.cpp
   opm/core/transport/TransportSolverTwophaseInterface.cpp
+  opm/core/transport/reorder/ComponentLevelSchedule.cpp
+  opm/core/transport/reorder/ReorderSequenceCache.cpp
   opm/core/transport/reorder/ReorderSolverInterface.cpp
+  opm/core/transport/reorder/ReorderWorkspace.cpp
   opm/core/transport/reorder/TransportSolverCompressibleTwophaseReorder.cpp
   opm/core/transport/reorder/TransportSolverTwophaseReorder.cpp
   opm/core/transport/reorder/reordersequence.cpp
   opm/core/transport/reorder/tarjan.c
+  opm/core/utility/IndexedLinearTable.cpp
   opm/core/utility/miscUtilities.cpp
   opm/core/utility/miscUtilitiesBlackoil.cpp
   opm/core/utility/NullStream.cpp
@@ -114,6 +121,20 @@ list (APPEND TEST_SOURCE_FILES
   tests/test_linearsolver.cpp
   tests/test_satfunc.cpp
   tests/test_anisotropiceikonal.cpp
+  tests/test_threadhandle.cpp
+  tests/test_timingregistry.cpp
+  tests/test_preconditionerreusepolicy.cpp
+  tests/test_pvtregionbatches.cpp
+  tests/test_propertyreusemask.cpp
+  tests/test_fluidinplacecache.cpp
+  tests/test_localnewtonregion.cpp
+  tests/test_scratcharena.cpp
+  tests/test_componentlevelschedule.cpp
+  tests/test_componentnewtonsolver.cpp
+  tests/test_reordersequencecache.cpp
+  tests/test_reorderworkspace.cpp
+  tests/test_indexedlineartable.cpp
+  tests/test_polymerproperties.cpp
 )
 
 if(MPI_FOUND)
@@ -144,6 +165,7 @@ list (APPEND EXAMPLE_SOURCE_FILES
   examples/compute_initial_state.cpp
   examples/compute_tof_from_files.cpp
   examples/diagnose_relperm.cpp
+  examples/benchmark_reorder_sequence.cpp
   tutorials/sim_tutorial1.cpp
 )
 
@@ -169,6 +191,7 @@ list (APPEND PROGRAM_SOURCE_FILES
 # originally generated with the command:
 # find opm -name '*.h*' -a ! -name '*-pch.hpp' -printf '\t%p\n' | sort
 list (APPEND PUBLIC_HEADER_FILES
+  opm/autodiff/AutoDiffBlockExpressions.hpp
   opm/autodiff/BlackoilLegacyDetails.hpp
   opm/autodiff/BlackoilModel.hpp
   opm/autodiff/BlackoilModelBase.hpp
@@ -195,13 +218,20 @@ list (APPEND PUBLIC_HEADER_FILES
   opm/autodiff/NewtonIterationBlackoilCPR.hpp
   opm/autodiff/NewtonIterationBlackoilInterface.hpp
   opm/autodiff/NewtonIterationBlackoilInterleaved.hpp
+  opm/autodiff/MixedPrecisionPreconditioner.hpp
   opm/autodiff/NewtonIterationBlackoilSimple.hpp
   opm/autodiff/NewtonIterationUtilities.hpp
   opm/autodiff/NonlinearSolver.hpp
   opm/autodiff/NonlinearSolver_impl.hpp
+  opm/autodiff/FluidInPlaceCache.hpp
   opm/autodiff/LinearisedBlackoilResidual.hpp
+  opm/autodiff/LocalNewtonRegion.hpp
   opm/autodiff/ParallelDebugOutput.hpp
+  opm/autodiff/PreconditionerReusePolicy.hpp
+  opm/autodiff/PropertyReuseMask.hpp
+  opm/autodiff/PvtRegionBatches.hpp
   opm/autodiff/RedistributeDataHandles.hpp
+  opm/autodiff/ScratchArena.hpp
   opm/autodiff/SimulatorBase.hpp
   opm/autodiff/SimulatorBase_impl.hpp
   opm/autodiff/SimulatorFullyImplicitBlackoil.hpp
@@ -211,6 +241,7 @@ list (APPEND PUBLIC_HEADER_FILES
   opm/autodiff/WellDensitySegmented.hpp
   opm/autodiff/SimulatorFullyImplicitBlackoilOutput.hpp
   opm/autodiff/ThreadHandle.hpp
+  opm/autodiff/TimingRegistry.hpp
   opm/autodiff/VFPHelpersLegacy.hpp
   opm/autodiff/VFPProdPropertiesLegacy.hpp
   opm/autodiff/VFPInjPropertiesLegacy.hpp
@@ -267,13 +298,18 @@ list (APPEND PUBLIC_HEADER_FILES
   opm/core/simulator/initStateEquil_impl.hpp
   opm/core/simulator/initState_impl.hpp
   opm/core/transport/TransportSolverTwophaseInterface.hpp
+  opm/core/transport/reorder/ComponentLevelSchedule.hpp
+  opm/core/transport/reorder/ComponentNewtonSolver.hpp
+  opm/core/transport/reorder/ReorderSequenceCache.hpp
   opm/core/transport/reorder/ReorderSolverInterface.hpp
+  opm/core/transport/reorder/ReorderWorkspace.hpp
   opm/core/transport/reorder/TransportSolverCompressibleTwophaseReorder.hpp
   opm/core/transport/reorder/TransportSolverTwophaseReorder.hpp
   opm/core/transport/reorder/reordersequence.h
   opm/core/transport/reorder/tarjan.h
   opm/core/utility/DataMap.hpp
   opm/core/utility/Event.hpp
+  opm/core/utility/IndexedLinearTable.hpp
   opm/core/utility/miscUtilities.hpp
   opm/core/utility/miscUtilitiesBlackoil.hpp
   opm/core/utility/miscUtilities_impl.hpp
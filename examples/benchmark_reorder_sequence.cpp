@@ -0,0 +1,250 @@
+/*
+  Copyright 2017 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Benchmark of the causal cell ordering: compute_sequence() against
+// ReorderWorkspace with and without renumbering, on two synthetic
+// graphs:
+//
+//   cartesian    nx*ny*nz box, natural cell numbering;
+//   cornerpoint  the same box with about 10% inactive cells, a fault
+//                with a half-cell throw in the middle of the x
+//                direction, and cells numbered pillar by pillar with
+//                the pillars in random order.
+//
+// The flux is the gradient of a smooth potential with a small
+// fraction of the faces reversed, which creates some loops.
+//
+// Usage: benchmark_reorder_sequence [nx] [ny] [nz] [repeats]
+
+#include <config.h>
+
+#include <opm/core/transport/reorder/ReorderWorkspace.hpp>
+#include <opm/core/transport/reorder/reordersequence.h>
+#include <opm/grid/UnstructuredGrid.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // Cell-face topology with the conventions of UnstructuredGrid.
+    struct Topology
+    {
+        int num_cells = 0;
+        std::vector<int> face_cells;
+        std::vector<int> cell_facepos;
+        std::vector<int> cell_faces;
+        std::vector<double> flux;
+
+        int numFaces() const { return static_cast<int>(face_cells.size()) / 2; }
+
+        // View as an UnstructuredGrid, with only the topology filled in.
+        UnstructuredGrid grid()
+        {
+            UnstructuredGrid g = UnstructuredGrid();
+            g.number_of_cells = num_cells;
+            g.number_of_faces = numFaces();
+            g.face_cells = face_cells.data();
+            g.cell_facepos = cell_facepos.data();
+            g.cell_faces = cell_faces.data();
+            return g;
+        }
+    };
+
+    // Build the box. Cells with cell_index[c] < 0 are inactive; the
+    // others are numbered by cell_index. With a fault, every x-face
+    // in the middle column also connects to the cell one layer down.
+    Topology buildBox(const int nx, const int ny, const int nz,
+                      const std::vector<int>& cell_index, const int num_cells,
+                      const bool fault, const double reversed_fraction)
+    {
+        Topology top;
+        top.num_cells = num_cells;
+        std::vector<double> potential(num_cells);
+        auto logical = [nx, ny](const int i, const int j, const int k) { return i + nx*(j + ny*k); };
+        for (int k = 0; k < nz; ++k) {
+            for (int j = 0; j < ny; ++j) {
+                for (int i = 0; i < nx; ++i) {
+                    const int c = cell_index[logical(i, j, k)];
+                    if (c >= 0) {
+                        potential[c] = -double(i) - 0.5*j + 0.1*k + 2.0*std::sin(0.3*i)*std::cos(0.2*j);
+                    }
+                }
+            }
+        }
+        auto connect = [&top](const int c0, const int c1) {
+            if (c0 >= 0 && c1 >= 0) {
+                top.face_cells.push_back(c0);
+                top.face_cells.push_back(c1);
+            }
+        };
+        for (int k = 0; k < nz; ++k) {
+            for (int j = 0; j < ny; ++j) {
+                for (int i = 0; i < nx; ++i) {
+                    const int c = cell_index[logical(i, j, k)];
+                    if (i + 1 < nx) {
+                        connect(c, cell_index[logical(i + 1, j, k)]);
+                        if (fault && i == nx/2 && k + 1 < nz) {
+                            connect(c, cell_index[logical(i + 1, j, k + 1)]);
+                        }
+                    }
+                    if (j + 1 < ny) {
+                        connect(c, cell_index[logical(i, j + 1, k)]);
+                    }
+                    if (k + 1 < nz) {
+                        connect(c, cell_index[logical(i, j, k + 1)]);
+                    }
+                }
+            }
+        }
+
+        // Cell to face mapping.
+        const int nf = top.numFaces();
+        top.cell_facepos.assign(num_cells + 1, 0);
+        for (int f = 0; f < nf; ++f) {
+            ++top.cell_facepos[top.face_cells[2*f] + 1];
+            ++top.cell_facepos[top.face_cells[2*f + 1] + 1];
+        }
+        for (int c = 0; c < num_cells; ++c) {
+            top.cell_facepos[c + 1] += top.cell_facepos[c];
+        }
+        top.cell_faces.resize(top.cell_facepos[num_cells]);
+        std::vector<int> pos(top.cell_facepos.begin(), top.cell_facepos.end() - 1);
+        for (int f = 0; f < nf; ++f) {
+            top.cell_faces[pos[top.face_cells[2*f]]++] = f;
+            top.cell_faces[pos[top.face_cells[2*f + 1]]++] = f;
+        }
+
+        // Potential flow, with some faces reversed.
+        std::mt19937 gen(1234);
+        std::uniform_real_distribution<double> unif(0.0, 1.0);
+        top.flux.resize(nf);
+        for (int f = 0; f < nf; ++f) {
+            const double dp = potential[top.face_cells[2*f]] - potential[top.face_cells[2*f + 1]];
+            top.flux[f] = unif(gen) < reversed_fraction ? -dp : dp;
+        }
+        return top;
+    }
+
+    Topology cartesian(const int nx, const int ny, const int nz)
+    {
+        const int n = nx*ny*nz;
+        std::vector<int> cell_index(n);
+        for (int c = 0; c < n; ++c) {
+            cell_index[c] = c;
+        }
+        return buildBox(nx, ny, nz, cell_index, n, false, 0.01);
+    }
+
+    Topology cornerPoint(const int nx, const int ny, const int nz)
+    {
+        std::mt19937 gen(4321);
+        std::uniform_real_distribution<double> unif(0.0, 1.0);
+        std::vector<int> pillars(nx*ny);
+        for (int p = 0; p < nx*ny; ++p) {
+            pillars[p] = p;
+        }
+        std::shuffle(pillars.begin(), pillars.end(), gen);
+        std::vector<int> cell_index(nx*ny*nz, -1);
+        int num_cells = 0;
+        for (const int p : pillars) {
+            for (int k = 0; k < nz; ++k) {
+                if (unif(gen) >= 0.1) {
+                    cell_index[p + nx*ny*k] = num_cells++;
+                }
+            }
+        }
+        return buildBox(nx, ny, nz, cell_index, num_cells, true, 0.01);
+    }
+
+    template <class Kernel>
+    double seconds(const Kernel& kernel, const int repeats)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < repeats; ++r) {
+            kernel();
+        }
+        const auto stop = std::chrono::steady_clock::now();
+        return std::chrono::duration<double>(stop - start).count() / repeats;
+    }
+
+    void run(const std::string& name, Topology& top, const int repeats)
+    {
+        const UnstructuredGrid grid = top.grid();
+        const int nc = top.num_cells;
+        std::vector<int> sequence(nc);
+        std::vector<int> components(nc + 1);
+        int ncomp = 0;
+        const double t_plain = seconds([&]() {
+                compute_sequence(&grid, top.flux.data(), sequence.data(), components.data(), &ncomp);
+            }, repeats);
+
+        Opm::ReorderWorkspace workspace;
+        const double t_workspace = seconds([&]() {
+                workspace.compute(grid, top.flux.data());
+            }, repeats);
+
+        // The first call has no previous sequence to renumber by.
+        Opm::ReorderWorkspace renumbered(true);
+        renumbered.compute(grid, top.flux.data());
+        const double t_renumbered = seconds([&]() {
+                renumbered.compute(grid, top.flux.data());
+            }, repeats);
+
+        if (workspace.numComponents() != ncomp || renumbered.numComponents() != ncomp) {
+            std::cerr << "Component counts differ for " << name << std::endl;
+            std::exit(EXIT_FAILURE);
+        }
+        std::cout << std::setw(12) << std::left << name << std::right
+                  << std::setw(10) << nc
+                  << std::setw(10) << ncomp
+                  << std::fixed << std::setprecision(4)
+                  << std::setw(14) << t_plain
+                  << std::setw(14) << t_workspace
+                  << std::setw(14) << t_renumbered << '\n';
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const int nx = argc > 1 ? std::atoi(argv[1]) : 100;
+    const int ny = argc > 2 ? std::atoi(argv[2]) : 100;
+    const int nz = argc > 3 ? std::atoi(argv[3]) : 50;
+    const int repeats = argc > 4 ? std::atoi(argv[4]) : 5;
+
+    std::cout << "nx = " << nx << ", ny = " << ny << ", nz = " << nz
+              << ", repeats = " << repeats << "\n\n"
+              << std::setw(12) << std::left << "graph" << std::right
+              << std::setw(10) << "cells" << std::setw(10) << "comps"
+              << std::setw(14) << "plain [s]" << std::setw(14) << "workspace [s]"
+              << std::setw(14) << "renumber [s]" << '\n';
+
+    Topology cart = cartesian(nx, ny, nz);
+    run("cartesian", cart, repeats);
+    Topology cp = cornerPoint(nx, ny, nz);
+    run("cornerpoint", cp, repeats);
+    return 0;
+}
@@ -32,6 +32,7 @@
 #include <opm/core/props/phaseUsageFromDeck.hpp>
 #include <opm/core/simulator/BlackoilState.hpp>
 #include <opm/grid/utility/compressedToCartesian.hpp>
+#include <opm/grid/utility/StopWatch.hpp>
 
 #include <opm/parser/eclipse/Parser/ParseContext.hpp>
 #include <opm/parser/eclipse/Parser/Parser.hpp>
@@ -149,7 +150,12 @@ try
 
     typedef EQUIL::DeckDependent::InitialStateComputer<FluidSystem> ISC;
 
+    // Time the equilibration.
+    Opm::time::StopWatch timer;
+    timer.start();
     ISC isc(materialLawManager, eclipseState, grid, grav);
+    timer.stop();
+    std::cout << "Equilibration took: " << timer.secsSinceStart() << " seconds." << std::endl;
 
     const bool oil = FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx);
     const int oilpos = FluidSystem::oilPhaseIdx;
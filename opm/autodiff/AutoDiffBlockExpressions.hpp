@@ -0,0 +1,460 @@
+/*
+  Copyright 2016 IRIS AS
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_AUTODIFFBLOCKEXPRESSIONS_HEADER_INCLUDED
+#define OPM_AUTODIFFBLOCKEXPRESSIONS_HEADER_INCLUDED
+
+#include <opm/autodiff/AutoDiffBlock.hpp>
+#include <opm/autodiff/AutoDiffMatrix.hpp>
+#include <opm/autodiff/ScratchArena.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <type_traits>
+#include <vector>
+
+namespace Opm
+{
+
+    /// Lazy expression templates for elementwise AutoDiffBlock arithmetic.
+    ///
+    /// Every operator of AutoDiffBlock evaluates eagerly, creating a new
+    /// value array and a new set of jacobian blocks. For a chain such as
+    /// pv_mult * b * s this means several passes over the jacobians and
+    /// several temporaries. The classes in this namespace instead record
+    /// the expression tree, and evaluateFused() computes the result in
+    /// two passes:
+    ///   - one loop over the elements computing the value and, by the
+    ///     chain rule, the elementwise partial derivative of the whole
+    ///     expression with respect to each distinct AutoDiffBlock leaf;
+    ///   - one AutoDiffMatrix::scaledSum() per jacobian block, forming
+    ///     sum_k diag(partial_k) * leaf_k.derivative()[block].
+    ///
+    /// Usage:
+    ///     const ADB accum = evaluateFused(lazy(pv_mult) * b * s);
+    ///
+    /// Only elementwise +, -, *, / and unary minus are supported, with
+    /// AutoDiffBlock, value array (V) or scalar operands. As with Eigen
+    /// expressions, leaves and constants are held by reference, so an
+    /// expression must be evaluated before its operands go out of scope,
+    /// i.e. normally within the statement that builds it.
+    namespace AdExpr
+    {
+
+        /// Tag base class identifying expression nodes.
+        struct ExprBase {};
+
+        template <class T>
+        struct IsExpr : std::is_base_of<ExprBase, T> {};
+
+
+
+        /// Expression leaf referring to an AutoDiffBlock.
+        template <typename Scalar>
+        class Leaf : public ExprBase
+        {
+        public:
+            typedef AutoDiffBlock<Scalar> ADB;
+
+            explicit Leaf(const ADB& x)
+                : x_(&x), val_(x.value().data()), slot_(-1)
+            {
+            }
+
+            int size() const { return x_->size(); }
+
+            Scalar value(const int i) const { return val_[i]; }
+
+            void derivative(const int i, const Scalar seed, Scalar* const* partials) const
+            {
+                if (slot_ >= 0) {
+                    partials[slot_][i] += seed;
+                }
+            }
+
+            /// Register this leaf with the evaluator. Leaves referring to
+            /// the same AutoDiffBlock share a slot; leaves without
+            /// jacobians get none.
+            void collect(std::vector<const ADB*>& leaves) const
+            {
+                if (x_->derivative().empty()) {
+                    slot_ = -1;
+                    return;
+                }
+                const int num_leaves = leaves.size();
+                for (int k = 0; k < num_leaves; ++k) {
+                    if (leaves[k] == x_) {
+                        slot_ = k;
+                        return;
+                    }
+                }
+                slot_ = num_leaves;
+                leaves.push_back(x_);
+            }
+
+        private:
+            const ADB* x_;
+            const Scalar* val_;
+            mutable int slot_;
+        };
+
+
+
+        /// Expression leaf referring to a constant value array.
+        template <typename Scalar>
+        class Constant : public ExprBase
+        {
+        public:
+            typedef AutoDiffBlock<Scalar> ADB;
+            typedef typename ADB::V V;
+
+            explicit Constant(const V& x)
+                : val_(x.data()), size_(x.size())
+            {
+            }
+
+            int size() const { return size_; }
+
+            Scalar value(const int i) const { return val_[i]; }
+
+            void derivative(const int, const Scalar, Scalar* const*) const {}
+
+            void collect(std::vector<const ADB*>&) const {}
+
+        private:
+            const Scalar* val_;
+            int size_;
+        };
+
+
+
+        /// Expression leaf holding a single scalar, broadcast to all elements.
+        template <typename Scalar>
+        class ScalarConstant : public ExprBase
+        {
+        public:
+            typedef AutoDiffBlock<Scalar> ADB;
+
+            explicit ScalarConstant(const Scalar x)
+                : x_(x)
+            {
+            }
+
+            /// Scalars adapt to any size; -1 signals "no size".
+            int size() const { return -1; }
+
+            Scalar value(const int) const { return x_; }
+
+            void derivative(const int, const Scalar, Scalar* const*) const {}
+
+            void collect(std::vector<const ADB*>&) const {}
+
+        private:
+            Scalar x_;
+        };
+
+
+
+        // Elementwise operations: value and partial derivatives w.r.t. the
+        // two operands, given operand values a and b.
+
+        struct AddOp
+        {
+            template <typename S> static S value(const S a, const S b) { return a + b; }
+            template <typename S> static S da(const S, const S) { return S(1); }
+            template <typename S> static S db(const S, const S) { return S(1); }
+        };
+
+        struct SubOp
+        {
+            template <typename S> static S value(const S a, const S b) { return a - b; }
+            template <typename S> static S da(const S, const S) { return S(1); }
+            template <typename S> static S db(const S, const S) { return S(-1); }
+        };
+
+        struct MulOp
+        {
+            template <typename S> static S value(const S a, const S b) { return a * b; }
+            template <typename S> static S da(const S, const S b) { return b; }
+            template <typename S> static S db(const S a, const S) { return a; }
+        };
+
+        struct DivOp
+        {
+            template <typename S> static S value(const S a, const S b) { return a / b; }
+            template <typename S> static S da(const S, const S b) { return S(1) / b; }
+            template <typename S> static S db(const S a, const S b) { return -a / (b * b); }
+        };
+
+
+
+        /// Binary elementwise expression node.
+        template <class Op, class L, class R>
+        class Binary : public ExprBase
+        {
+        public:
+            typedef typename L::ADB ADB;
+            typedef typename ADB::V::Scalar Scalar;
+
+            Binary(const L& l, const R& r)
+                : l_(l), r_(r)
+            {
+                assert(l_.size() < 0 || r_.size() < 0 || l_.size() == r_.size());
+            }
+
+            int size() const { return l_.size() >= 0 ? l_.size() : r_.size(); }
+
+            Scalar value(const int i) const
+            {
+                return Op::value(l_.value(i), r_.value(i));
+            }
+
+            void derivative(const int i, const Scalar seed, Scalar* const* partials) const
+            {
+                const Scalar a = l_.value(i);
+                const Scalar b = r_.value(i);
+                l_.derivative(i, seed * Op::da(a, b), partials);
+                r_.derivative(i, seed * Op::db(a, b), partials);
+            }
+
+            void collect(std::vector<const ADB*>& leaves) const
+            {
+                l_.collect(leaves);
+                r_.collect(leaves);
+            }
+
+        private:
+            L l_;
+            R r_;
+        };
+
+
+
+        /// Unary minus expression node.
+        template <class E>
+        class Negate : public ExprBase
+        {
+        public:
+            typedef typename E::ADB ADB;
+            typedef typename ADB::V::Scalar Scalar;
+
+            explicit Negate(const E& e)
+                : e_(e)
+            {
+            }
+
+            int size() const { return e_.size(); }
+
+            Scalar value(const int i) const { return -e_.value(i); }
+
+            void derivative(const int i, const Scalar seed, Scalar* const* partials) const
+            {
+                e_.derivative(i, -seed, partials);
+            }
+
+            void collect(std::vector<const ADB*>& leaves) const
+            {
+                e_.collect(leaves);
+            }
+
+        private:
+            E e_;
+        };
+
+
+
+        /// Maps an operand type to the expression node wrapping it.
+        template <class T, class Scalar, class Enable = void>
+        struct Operand;
+
+        template <class T, class Scalar>
+        struct Operand<T, Scalar, typename std::enable_if<IsExpr<T>::value>::type>
+        {
+            typedef T type;
+            static const T& wrap(const T& t) { return t; }
+        };
+
+        template <class Scalar>
+        struct Operand<AutoDiffBlock<Scalar>, Scalar>
+        {
+            typedef Leaf<Scalar> type;
+            static type wrap(const AutoDiffBlock<Scalar>& x) { return type(x); }
+        };
+
+        template <class Scalar>
+        struct Operand<typename AutoDiffBlock<Scalar>::V, Scalar>
+        {
+            typedef Constant<Scalar> type;
+            static type wrap(const typename AutoDiffBlock<Scalar>::V& x) { return type(x); }
+        };
+
+        template <class Scalar>
+        struct Operand<Scalar, Scalar>
+        {
+            typedef ScalarConstant<Scalar> type;
+            static type wrap(const Scalar x) { return type(x); }
+        };
+
+
+
+        /// Scalar type of a binary expression where at least one side is
+        /// an expression node.
+        template <class L, class R, class Enable = void>
+        struct BinaryScalar;
+
+        template <class L, class R>
+        struct BinaryScalar<L, R, typename std::enable_if<IsExpr<L>::value>::type>
+        {
+            typedef typename L::ADB::V::Scalar type;
+        };
+
+        template <class L, class R>
+        struct BinaryScalar<L, R, typename std::enable_if<!IsExpr<L>::value && IsExpr<R>::value>::type>
+        {
+            typedef typename R::ADB::V::Scalar type;
+        };
+
+        /// Result of a binary operation; only defined when at least one
+        /// operand is an expression node, so that the operators below drop
+        /// out of overload resolution otherwise.
+        template <class Op, class L, class R, class Enable = void>
+        struct BinaryResult {};
+
+        template <class Op, class L, class R>
+        struct BinaryResult<Op, L, R, typename std::enable_if<IsExpr<L>::value || IsExpr<R>::value>::type>
+        {
+            typedef typename BinaryScalar<L, R>::type Scalar;
+            typedef Operand<L, Scalar> LO;
+            typedef Operand<R, Scalar> RO;
+            typedef Binary<Op, typename LO::type, typename RO::type> type;
+
+            static type make(const L& l, const R& r)
+            {
+                return type(LO::wrap(l), RO::wrap(r));
+            }
+        };
+
+    } // namespace AdExpr
+
+
+
+    /// Start a lazily evaluated expression from an AutoDiffBlock.
+    template <typename Scalar>
+    AdExpr::Leaf<Scalar> lazy(const AutoDiffBlock<Scalar>& x)
+    {
+        return AdExpr::Leaf<Scalar>(x);
+    }
+
+
+
+    /// Evaluate a lazy expression in a single fused pass, see AdExpr.
+    template <class Expr>
+    typename std::enable_if<AdExpr::IsExpr<Expr>::value, typename Expr::ADB>::type
+    evaluateFused(const Expr& expr)
+    {
+        typedef typename Expr::ADB ADB;
+        typedef typename ADB::V V;
+        typedef typename ADB::M M;
+        typedef typename V::Scalar Scalar;
+
+        std::vector<const ADB*> leaves;
+        expr.collect(leaves);
+
+        const int num_elem = expr.size();
+        assert(num_elem >= 0);
+        V val(num_elem);
+
+        if (leaves.empty()) {
+            for (int i = 0; i < num_elem; ++i) {
+                val[i] = expr.value(i);
+            }
+            return ADB::constant(std::move(val));
+        }
+
+        // The partial derivatives are only needed within this call,
+        // so they live in the scratch arena of the calling thread.
+        ScratchArena& arena = ScratchArena::threadLocal();
+        const ScratchArena::Scope scope(arena);
+        const int num_leaves = leaves.size();
+        std::vector<Scalar*> partial_ptr(num_leaves);
+        std::vector<const Scalar*> partial_cptr(num_leaves);
+        for (int k = 0; k < num_leaves; ++k) {
+            partial_ptr[k] = arena.allocate<Scalar>(num_elem);
+            std::fill(partial_ptr[k], partial_ptr[k] + num_elem, Scalar(0));
+            partial_cptr[k] = partial_ptr[k];
+        }
+        Scalar* const* pp = partial_ptr.data();
+
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif // HAVE_OPENMP
+        for (int i = 0; i < num_elem; ++i) {
+            val[i] = expr.value(i);
+            expr.derivative(i, Scalar(1), pp);
+        }
+
+        const int num_blocks = leaves[0]->numBlocks();
+        std::vector<M> jac(num_blocks);
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif // HAVE_OPENMP
+        for (int block = 0; block < num_blocks; ++block) {
+            std::vector<const M*> mats(num_leaves);
+            for (int k = 0; k < num_leaves; ++k) {
+                assert(leaves[k]->numBlocks() == num_blocks);
+                mats[k] = &leaves[k]->derivative()[block];
+            }
+            jac[block] = M::scaledSum(partial_cptr, mats);
+        }
+        return ADB::function(std::move(val), std::move(jac));
+    }
+
+
+
+    // ---------  Operators building lazy expressions  ---------
+    //
+    // These only participate when at least one operand is an expression
+    // node, so plain AutoDiffBlock arithmetic is unaffected.
+
+#define OPM_AD_EXPR_BINARY_OPERATOR(OP, OPTYPE)                              \
+    template <class L, class R>                                              \
+    typename AdExpr::BinaryResult<AdExpr::OPTYPE, L, R>::type                \
+    operator OP(const L& l, const R& r)                                      \
+    {                                                                        \
+        return AdExpr::BinaryResult<AdExpr::OPTYPE, L, R>::make(l, r);       \
+    }
+
+    OPM_AD_EXPR_BINARY_OPERATOR(+, AddOp)
+    OPM_AD_EXPR_BINARY_OPERATOR(-, SubOp)
+    OPM_AD_EXPR_BINARY_OPERATOR(*, MulOp)
+    OPM_AD_EXPR_BINARY_OPERATOR(/, DivOp)
+
+#undef OPM_AD_EXPR_BINARY_OPERATOR
+
+    /// Unary minus on a lazy expression.
+    template <class E>
+    typename std::enable_if<AdExpr::IsExpr<E>::value, AdExpr::Negate<E> >::type
+    operator-(const E& e)
+    {
+        return AdExpr::Negate<E>(e);
+    }
+
+} // namespace Opm
+
+#endif // OPM_AUTODIFFBLOCKEXPRESSIONS_HEADER_INCLUDED
@@ -170,6 +170,19 @@ struct HelperOps
         } else {
             connection_cells = nbi;
         }
+
+        // Products with these are repeated in every assembly on jacobians
+        // of unchanged pattern, so they go through the sparse plan cache.
+        registerStableSparseOperator(ngrad);
+        registerStableSparseOperator(caver);
+        registerStableSparseOperator(div);
+    }
+
+    ~HelperOps()
+    {
+        unregisterStableSparseOperator(ngrad);
+        unregisterStableSparseOperator(caver);
+        unregisterStableSparseOperator(div);
     }
 };
 // -------------------- upwinding helper class --------------------
@@ -472,7 +472,7 @@ namespace Opm
             assert(lhs.type_ == Sparse);
             assert(rhs.type_ == Sparse);
             AutoDiffMatrix retval = lhs;
-            retval.sparse_ += rhs.sparse_;
+            fastSparseAdd(retval.sparse_, rhs.sparse_);
             return retval;
         }
 
@@ -530,6 +530,129 @@ namespace Opm
             return retval;
         }
 
+        // Multiply an Eigen sparse matrix with any matrix. A sparse rhs is
+        // multiplied with lhs itself rather than a copy, so that a
+        // registered stable operator (see registerStableSparseOperator())
+        // is recognised by fastSparseProduct().
+        static AutoDiffMatrix mulEigenSparse(const SparseRep& lhs, const AutoDiffMatrix& rhs)
+        {
+            if (rhs.type_ != Sparse) {
+                return AutoDiffMatrix(lhs) * rhs;
+            }
+            AutoDiffMatrix retval;
+            retval.type_ = Sparse;
+            retval.rows_ = lhs.rows();
+            retval.cols_ = rhs.cols_;
+            fastSparseProduct(lhs, rhs.sparse_, retval.sparse_);
+            return retval;
+        }
+
+
+
+
+        /**
+         * Computes the sum over k of diag(scale[k]) * mats[k] in a single pass,
+         * where scale[k] points to rows() values. Zero terms are skipped,
+         * identity and diagonal terms are accumulated into one diagonal, and
+         * sparse terms sharing a sparsity pattern are summed directly on their
+         * value arrays. This avoids forming one temporary per term as a chain
+         * of operator* and operator+ calls would.
+         */
+        static AutoDiffMatrix scaledSum(const std::vector<const double*>& scale,
+                                        const std::vector<const AutoDiffMatrix*>& mats)
+        {
+            assert(scale.size() == mats.size());
+            assert(!mats.empty());
+            const int num_terms = mats.size();
+            const int rows = mats[0]->rows_;
+            const int cols = mats[0]->cols_;
+
+            DiagRep diag;
+            std::vector<int> sparse_terms;
+            for (int k = 0; k < num_terms; ++k) {
+                const AutoDiffMatrix& m = *mats[k];
+                assert(m.rows_ == rows);
+                assert(m.cols_ == cols);
+                const double* s = scale[k];
+                switch (m.type_) {
+                case Zero:
+                    break;
+                case Identity:
+                    if (diag.empty()) {
+                        diag.assign(s, s + rows);
+                    } else {
+                        for (int r = 0; r < rows; ++r) {
+                            diag[r] += s[r];
+                        }
+                    }
+                    break;
+                case Diagonal:
+                    if (diag.empty()) {
+                        diag.resize(rows);
+                        for (int r = 0; r < rows; ++r) {
+                            diag[r] = s[r] * m.diag_[r];
+                        }
+                    } else {
+                        for (int r = 0; r < rows; ++r) {
+                            diag[r] += s[r] * m.diag_[r];
+                        }
+                    }
+                    break;
+                case Sparse:
+                    sparse_terms.push_back(k);
+                    break;
+                default:
+                    OPM_THROW(std::logic_error, "Invalid AutoDiffMatrix type encountered: " << m.type_);
+                }
+            }
+
+            if (sparse_terms.empty()) {
+                if (diag.empty()) {
+                    return AutoDiffMatrix(rows, cols);
+                }
+                return AutoDiffMatrix(Diagonal, rows, cols, std::move(diag));
+            }
+
+            AutoDiffMatrix retval;
+            retval.type_ = Sparse;
+            retval.rows_ = rows;
+            retval.cols_ = cols;
+
+            // Start from the row-scaled first sparse term.
+            const int first = sparse_terms[0];
+            fastDiagSparseProduct(scale[first], mats[first]->sparse_, retval.sparse_);
+            const int num_sparse = sparse_terms.size();
+            for (int t = 1; t < num_sparse; ++t) {
+                const int k = sparse_terms[t];
+                const SparseRep& sk = mats[k]->sparse_;
+                if (equalSparsityPattern(retval.sparse_, sk)) {
+                    // Same structure: fused scale-and-add on the value arrays.
+                    const double* s = scale[k];
+                    const int nnz = sk.nonZeros();
+                    const int* inner = sk.innerIndexPtr();
+                    const double* src = sk.valuePtr();
+                    double* dst = retval.sparse_.valuePtr();
+                    const bool parallel = detail::runSparseKernelInParallel(nnz);
+                    static_cast<void>(parallel);
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(static) if(parallel)
+#endif // HAVE_OPENMP
+                    for (int j = 0; j < nnz; ++j) {
+                        dst[j] += s[inner[j]] * src[j];
+                    }
+                } else {
+                    SparseRep scaled;
+                    fastDiagSparseProduct(scale[k], sk, scaled);
+                    retval.sparse_ += scaled;
+                }
+            }
+
+            if (!diag.empty()) {
+                retval.sparse_ += spdiag(diag);
+            }
+            return retval;
+        }
+
 
 
 
@@ -667,8 +790,8 @@ namespace Opm
             : type_(type),
               rows_(rows_arg),
               cols_(cols_arg),
-              diag_(diag),
-              sparse_(sparse)
+              diag_(std::move(diag)),
+              sparse_(std::move(sparse))
         {
         }
 
@@ -716,7 +839,7 @@ namespace Opm
      */
     inline void fastSparseProduct(const Eigen::SparseMatrix<double>& lhs, const AutoDiffMatrix& rhs, AutoDiffMatrix& res)
     {
-        res = AutoDiffMatrix(lhs) * rhs;
+        res = AutoDiffMatrix::mulEigenSparse(lhs, rhs);
     }
 
 
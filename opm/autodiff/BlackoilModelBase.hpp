@@ -31,6 +31,9 @@
 #include <opm/autodiff/LinearisedBlackoilResidual.hpp>
 #include <opm/autodiff/NewtonIterationBlackoilInterface.hpp>
 #include <opm/autodiff/BlackoilModelEnums.hpp>
+#include <opm/autodiff/FluidInPlaceCache.hpp>
+#include <opm/autodiff/LocalNewtonRegion.hpp>
+#include <opm/autodiff/PropertyReuseMask.hpp>
 #include <opm/autodiff/VFPInjPropertiesLegacy.hpp>
 #include <opm/autodiff/VFPProdPropertiesLegacy.hpp>
 #include <opm/autodiff/VFPProperties.hpp>
@@ -366,6 +369,21 @@ namespace Opm {
         // rate converter between the surface volume rates and reservoir voidage rates
         RateConverterType rate_converter_;
 
+        // Cells whose fluid properties must be re-evaluated in this
+        // assembly, and the properties of the last evaluation (per
+        // active phase) used for the other cells.
+        PropertyReuseMask property_reuse_;
+        bool reuse_properties_;
+        std::vector<ADB> cached_b_;
+        std::vector<ADB> cached_mu_;
+        std::vector<ADB> cached_kr_;
+
+        // Reciprocal FVFs of the converged state, for computeFluidInPlace().
+        FluidInPlaceCache fip_cache_;
+
+        // Cells updated by a local Newton iteration.
+        LocalNewtonRegion local_newton_region_;
+
         // ---------  Protected methods  ---------
 
         /// Access the most-derived class used for
@@ -420,6 +438,17 @@ namespace Opm {
         void
         assembleMassBalanceEq(const SolutionState& state);
 
+        /// Find the cells whose fluid properties must be re-evaluated
+        /// in this assembly, see BlackoilModelParameters::property_reuse_tolerance_.
+        void
+        updatePropertyReuse(const ReservoirState& reservoir_state,
+                            const bool initial_assembly);
+
+        /// Evaluate b, mu and kr in the cells marked by updatePropertyReuse(),
+        /// and combine them with the cached values for the other cells.
+        void
+        evaluateReusedProperties(const SolutionState& state);
+
 
         SimulatorReport
         solveWellEq(const std::vector<ADB>& mob_perfcells,
@@ -435,6 +464,15 @@ namespace Opm {
 
         bool getWellConvergence(const int iteration);
 
+        /// Select the cells for a local Newton iteration from the
+        /// local residuals, see BlackoilModelParameters::use_local_newton_.
+        /// \return true if the update should be restricted to those cells.
+        bool selectLocalNewtonRegion(const SimulatorTimerInterface& timer);
+
+        /// Solve the linearized system restricted to the cells selected
+        /// by selectLocalNewtonRegion(), with zero increments elsewhere.
+        V solveLocalJacobianSystem() const;
+
         bool isVFPActive() const;
 
         std::vector<ADB>
@@ -452,6 +490,12 @@ namespace Opm {
         std::vector<ADB>
         computeRelPerm(const SolutionState& state) const;
 
+        /// Relative permeabilities in the given cells, with the
+        /// saturations of state given for those cells only.
+        std::vector<ADB>
+        computeRelPerm(const SolutionState& state,
+                       const std::vector<int>& cells) const;
+
         void
         computeMassFlux(const int               actph ,
                         const V&                transi,
@@ -471,6 +515,15 @@ namespace Opm {
                        const ADB&              rv   ,
                        const std::vector<PhasePresence>& cond) const;
 
+        ADB
+        fluidViscosity(const int               phase,
+                       const ADB&              p    ,
+                       const ADB&              temp ,
+                       const ADB&              rs   ,
+                       const ADB&              rv   ,
+                       const std::vector<PhasePresence>& cond,
+                       const std::vector<int>& cells) const;
+
         ADB
         fluidReciprocFVF(const int               phase,
                          const ADB&              p    ,
@@ -479,6 +532,15 @@ namespace Opm {
                          const ADB&              rv   ,
                          const std::vector<PhasePresence>& cond) const;
 
+        ADB
+        fluidReciprocFVF(const int               phase,
+                         const ADB&              p    ,
+                         const ADB&              temp ,
+                         const ADB&              rs   ,
+                         const ADB&              rv   ,
+                         const std::vector<PhasePresence>& cond,
+                         const std::vector<int>& cells) const;
+
         ADB
         fluidDensity(const int  phase,
                      const ADB& b,
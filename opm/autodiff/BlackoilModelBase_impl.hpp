@@ -29,6 +29,7 @@
 #include <opm/autodiff/BlackoilLegacyDetails.hpp>
 
 #include <opm/autodiff/AutoDiffBlock.hpp>
+#include <opm/autodiff/AutoDiffBlockExpressions.hpp>
 #include <opm/autodiff/AutoDiffHelpers.hpp>
 #include <opm/autodiff/GridHelpers.hpp>
 #include <opm/autodiff/WellHelpers.hpp>
@@ -38,6 +39,7 @@
 #include <opm/autodiff/VFPProperties.hpp>
 #include <opm/autodiff/VFPProdPropertiesLegacy.hpp>
 #include <opm/autodiff/VFPInjPropertiesLegacy.hpp>
+#include <opm/autodiff/TimingRegistry.hpp>
 
 #include <opm/grid/UnstructuredGrid.h>
 #include <opm/core/linalg/LinearSolverInterface.hpp>
@@ -146,6 +148,12 @@ typedef Eigen::Array<double,
         // TODO: more delicate implementation will be required if we want to handle different
         // FIP regions specified from the well specifications.
         , rate_converter_(fluid_.phaseUsage(), std::vector<int>(AutoDiffGrid::numCells(grid_),0))
+        , property_reuse_(param.property_reuse_tolerance_)
+        , reuse_properties_(false)
+        , cached_b_(fluid.numPhases(), ADB::null())
+        , cached_mu_(fluid.numPhases(), ADB::null())
+        , cached_kr_(fluid.numPhases(), ADB::null())
+        , local_newton_region_(AutoDiffGrid::numCells(grid_), ops_.connection_cells)
     {
         if (active_[Water]) {
             material_name_.push_back("Water");
@@ -226,6 +234,7 @@ typedef Eigen::Array<double,
         const double dt = timer.currentStepLength();
 
         pvdt_ = geo_.poreVolume() / dt;
+        fip_cache_.invalidate();
         if (active_[Gas]) {
             updatePrimalVariableFromState(reservoir_state);
         }
@@ -286,7 +295,11 @@ typedef Eigen::Array<double,
             // Compute the nonlinear update.
             V dx;
             try {
-                dx = asImpl().solveJacobianSystem();
+                if (iteration > 0 && asImpl().selectLocalNewtonRegion(timer)) {
+                    dx = asImpl().solveLocalJacobianSystem();
+                } else {
+                    dx = asImpl().solveJacobianSystem();
+                }
                 report.linear_solve_time += perfTimer.stop();
                 report.total_linear_iterations += linearIterationsLastSolve();
             }
@@ -320,6 +333,9 @@ typedef Eigen::Array<double,
             // limitations and chopping of the update.
             asImpl().updateState(dx, reservoir_state, well_state);
             report.update_time += perfTimer.stop();
+        } else {
+            // Converged in the assembled state.
+            fip_cache_.converged(sd_.rq, fluid_.numPhases());
         }
 
         return report;
@@ -712,6 +728,7 @@ typedef Eigen::Array<double,
     computeAccum(const SolutionState& state,
                  const int            aix  )
     {
+        ScopedTiming timing("computeAccum");
         const Opm::PhaseUsage& pu = fluid_.phaseUsage();
 
         const ADB&              press = state.pressure;
@@ -728,8 +745,12 @@ typedef Eigen::Array<double,
         for (int phase = 0; phase < maxnp; ++phase) {
             if (active_[ phase ]) {
                 const int pos = pu.phase_pos[ phase ];
-                sd_.rq[pos].b = asImpl().fluidReciprocFVF(phase, state.canonical_phase_pressures[phase], temp, rs, rv, cond);
-                sd_.rq[pos].accum[aix] = pv_mult * sd_.rq[pos].b * sat[pos];
+                if (aix == 1 && reuse_properties_) {
+                    sd_.rq[pos].b = cached_b_[pos];
+                } else {
+                    sd_.rq[pos].b = asImpl().fluidReciprocFVF(phase, state.canonical_phase_pressures[phase], temp, rs, rv, cond);
+                }
+                sd_.rq[pos].accum[aix] = evaluateFused(lazy(pv_mult) * sd_.rq[pos].b * sat[pos]);
                 // OPM_AD_DUMP(sd_.rq[pos].b);
                 // OPM_AD_DUMP(sd_.rq[pos].accum[aix]);
             }
@@ -744,8 +765,8 @@ typedef Eigen::Array<double,
             // when both dissolved gas and vaporized oil are present.
             const ADB accum_gas_copy =sd_.rq[pg].accum[aix];
 
-            sd_.rq[pg].accum[aix] += state.rs * sd_.rq[po].accum[aix];
-            sd_.rq[po].accum[aix] += state.rv * accum_gas_copy;
+            sd_.rq[pg].accum[aix] = evaluateFused(lazy(state.rs) * sd_.rq[po].accum[aix] + sd_.rq[pg].accum[aix]);
+            sd_.rq[po].accum[aix] = evaluateFused(lazy(state.rv) * accum_gas_copy + sd_.rq[po].accum[aix]);
             // OPM_AD_DUMP(sd_.rq[pg].accum[aix]);
         }
     }
@@ -761,6 +782,7 @@ typedef Eigen::Array<double,
              WellState& well_state,
              const bool initial_assembly)
     {
+        ScopedTiming timing("assemble");
         using namespace Opm::AutoDiffGrid;
 
         SimulatorReport report;
@@ -814,7 +836,11 @@ typedef Eigen::Array<double,
         // OPM_AD_DISKVAL(state.bhp);
 
         // -------- Mass balance equations --------
+        asImpl().updatePropertyReuse(reservoir_state, initial_assembly);
         asImpl().assembleMassBalanceEq(state);
+        // With property reuse, the b of some cells belong to an earlier iterate.
+        fip_cache_.assembled(!reuse_properties_);
+        reuse_properties_ = false;
 
         // -------- Well equations ----------
         if ( ! wellsActive() ) {
@@ -847,12 +873,16 @@ typedef Eigen::Array<double,
     BlackoilModelBase<Grid, WellModel, Implementation>::
     assembleMassBalanceEq(const SolutionState& state)
     {
+        ScopedTiming timing("assembleMassBalanceEq");
         // Compute b_p and the accumulation term b_p*s_p for each phase,
         // except gas. For gas, we compute b_g*s_g + Rs*b_o*s_o.
         // These quantities are stored in sd_.rq[phase].accum[1].
         // The corresponding accumulation terms from the start of
         // the timestep (b^0_p*s^0_p etc.) were already computed
         // on the initial call to assemble() and stored in sd_.rq[phase].accum[0].
+        if (reuse_properties_) {
+            asImpl().evaluateReusedProperties(state);
+        }
         asImpl().computeAccum(state, 1);
 
         // Set up the common parts of the mass balance equations
@@ -863,7 +893,11 @@ typedef Eigen::Array<double,
         trans_all << transi, trans_nnc;
 
 
-        {
+        if (reuse_properties_) {
+            for (int phaseIdx = 0; phaseIdx < fluid_.numPhases(); ++phaseIdx) {
+                sd_.rq[phaseIdx].kr = cached_kr_[phaseIdx];
+            }
+        } else {
             const std::vector<ADB> kr = asImpl().computeRelPerm(state);
             for (int phaseIdx = 0; phaseIdx < fluid_.numPhases(); ++phaseIdx) {
                 sd_.rq[phaseIdx].kr = kr[canph_[phaseIdx]];
@@ -872,12 +906,16 @@ typedef Eigen::Array<double,
 #pragma omp parallel for schedule(static)
         for (int phaseIdx = 0; phaseIdx < fluid_.numPhases(); ++phaseIdx) {
             const std::vector<PhasePresence>& cond = phaseCondition();
-            sd_.rq[phaseIdx].mu = asImpl().fluidViscosity(canph_[phaseIdx], state.canonical_phase_pressures[canph_[phaseIdx]], state.temperature, state.rs, state.rv, cond);
+            if (reuse_properties_) {
+                sd_.rq[phaseIdx].mu = cached_mu_[phaseIdx];
+            } else {
+                sd_.rq[phaseIdx].mu = asImpl().fluidViscosity(canph_[phaseIdx], state.canonical_phase_pressures[canph_[phaseIdx]], state.temperature, state.rs, state.rv, cond);
+            }
             sd_.rq[phaseIdx].rho = asImpl().fluidDensity(canph_[phaseIdx], sd_.rq[phaseIdx].b, state.rs, state.rv);
             asImpl().computeMassFlux(phaseIdx, trans_all, sd_.rq[phaseIdx].kr, sd_.rq[phaseIdx].mu, sd_.rq[phaseIdx].rho, state.canonical_phase_pressures[canph_[phaseIdx]], state);
 
             residual_.material_balance_eq[ phaseIdx ] =
-                pvdt_ * (sd_.rq[phaseIdx].accum[1] - sd_.rq[phaseIdx].accum[0])
+                evaluateFused(pvdt_ * (lazy(sd_.rq[phaseIdx].accum[1]) - sd_.rq[phaseIdx].accum[0]))
                 + ops_.div*sd_.rq[phaseIdx].mflux;
         }
 
@@ -916,6 +954,112 @@ typedef Eigen::Array<double,
 
 
 
+    template <class Grid, class WellModel, class Implementation>
+    void
+    BlackoilModelBase<Grid, WellModel, Implementation>::
+    updatePropertyReuse(const ReservoirState& reservoir_state,
+                        const bool initial_assembly)
+    {
+        reuse_properties_ = false;
+        if (!property_reuse_.enabled()) {
+            return;
+        }
+        // The hysteresis parameters, maximum oil saturation and the
+        // well variables may all have changed since the last step.
+        if (initial_assembly) {
+            property_reuse_.invalidate();
+        }
+
+        const int nc = Opm::AutoDiffGrid::numCells(grid_);
+        std::vector<int> variable_set(nc);
+        for (int c = 0; c < nc; ++c) {
+            variable_set[c] = (isRs_[c] != 0.0) + 2*(isRv_[c] != 0.0) + 4*(isSg_[c] != 0.0);
+        }
+        const std::vector<double> none;
+        property_reuse_.update(reservoir_state.pressure(),
+                               reservoir_state.saturation(),
+                               fluid_.numPhases(),
+                               has_disgas_ ? reservoir_state.gasoilratio() : none,
+                               has_vapoil_ ? reservoir_state.rv() : none,
+                               variable_set);
+        reuse_properties_ = true;
+    }
+
+
+
+
+
+    template <class Grid, class WellModel, class Implementation>
+    void
+    BlackoilModelBase<Grid, WellModel, Implementation>::
+    evaluateReusedProperties(const SolutionState& state)
+    {
+        ScopedTiming timing("evaluateReusedProperties");
+        const int np = fluid_.numPhases();
+        const int nc = Opm::AutoDiffGrid::numCells(grid_);
+
+        // Cached values from another set of primary variables (the
+        // number of well variables may differ) cannot be combined with
+        // the current ones.
+        bool all_cells = property_reuse_.allDirty();
+        if (!all_cells && cached_b_[0].blockPattern() != state.pressure.blockPattern()) {
+            property_reuse_.invalidate();
+            all_cells = true;
+        }
+        if (!all_cells && property_reuse_.dirtyCells().empty()) {
+            return;
+        }
+        const std::vector<int>& cells = all_cells ? cells_ : property_reuse_.dirtyCells();
+
+        // The state restricted to the cells to evaluate.
+        SolutionState sub(np);
+        std::vector<PhasePresence> sub_cond;
+        if (!all_cells) {
+            auto subsetOf = [&cells, nc](const ADB& x) {
+                return x.size() == nc ? subset(x, cells) : x;
+            };
+            sub.pressure = subsetOf(state.pressure);
+            sub.temperature = subsetOf(state.temperature);
+            for (int phaseIdx = 0; phaseIdx < np; ++phaseIdx) {
+                sub.saturation[phaseIdx] = subsetOf(state.saturation[phaseIdx]);
+            }
+            sub.rs = subsetOf(state.rs);
+            sub.rv = subsetOf(state.rv);
+            for (int phase = 0; phase < MaxNumPhases; ++phase) {
+                if (active_[phase]) {
+                    sub.canonical_phase_pressures[phase] = subsetOf(state.canonical_phase_pressures[phase]);
+                }
+            }
+            sub_cond.reserve(cells.size());
+            for (const int cell : cells) {
+                sub_cond.push_back(phaseCondition_[cell]);
+            }
+        }
+        const SolutionState& s = all_cells ? state : sub;
+        const std::vector<PhasePresence>& cond = all_cells ? phaseCondition_ : sub_cond;
+
+        const std::vector<ADB> kr = asImpl().computeRelPerm(s, cells);
+        for (int phaseIdx = 0; phaseIdx < np; ++phaseIdx) {
+            const int phase = canph_[phaseIdx];
+            const ADB& p = s.canonical_phase_pressures[phase];
+            const ADB b = asImpl().fluidReciprocFVF(phase, p, s.temperature, s.rs, s.rv, cond, cells);
+            const ADB mu = asImpl().fluidViscosity(phase, p, s.temperature, s.rs, s.rv, cond, cells);
+            if (all_cells) {
+                cached_b_[phaseIdx] = b;
+                cached_mu_[phaseIdx] = mu;
+                cached_kr_[phaseIdx] = kr[phase];
+            } else {
+                cached_b_[phaseIdx] = property_reuse_.merge(cached_b_[phaseIdx], b);
+                cached_mu_[phaseIdx] = property_reuse_.merge(cached_mu_[phaseIdx], mu);
+                cached_kr_[phaseIdx] = property_reuse_.merge(cached_kr_[phaseIdx], kr[phase]);
+            }
+        }
+    }
+
+
+
+
+
     template <class Grid, class WellModel, class Implementation>
     void
     BlackoilModelBase<Grid, WellModel, Implementation>::
@@ -1023,6 +1167,7 @@ typedef Eigen::Array<double,
                 SolutionState& state,
                 WellState& well_state)
     {
+        ScopedTiming timing("solveWellEq");
         V aliveWells;
         const int np = wells().number_of_phases;
         std::vector<ADB> cq_s(np, ADB::null());
@@ -1144,6 +1289,62 @@ typedef Eigen::Array<double,
         return linsolver_.computeNewtonIncrement(residual_);
     }
 
+    template <class Grid, class WellModel, class Implementation>
+    bool
+    BlackoilModelBase<Grid, WellModel, Implementation>::
+    selectLocalNewtonRegion(const SimulatorTimerInterface& timer)
+    {
+        if (!param_.use_local_newton_) {
+            return false;
+        }
+#if HAVE_MPI
+        // The restricted system has no parallel index information.
+        if ( linsolver_.parallelInformation().type() == typeid(ParallelISTLInformation) ) {
+            return false;
+        }
+#endif
+        const double dt = timer.currentStepLength();
+        const int nc = Opm::AutoDiffGrid::numCells(grid_);
+        const int nm = asImpl().numMaterials();
+        const V& pv = geo_.poreVolume();
+
+        // Same local measure as the CNV criterion in getConvergence().
+        std::vector<bool> flagged(nc, false);
+        for (int idx = 0; idx < nm; ++idx) {
+            const V B = 1.0 / sd_.rq[idx].b.value();
+            const double scale = B.mean() * dt;
+            const V& R = residual_.material_balance_eq[idx].value();
+            for (int c = 0; c < nc; ++c) {
+                if (scale * std::abs(R[c]) / pv[c] > param_.tolerance_cnv_) {
+                    flagged[c] = true;
+                }
+            }
+        }
+        local_newton_region_.select(flagged, param_.local_newton_halo_layers_);
+
+        const int num_local = local_newton_region_.cells().size();
+        const bool use_local = num_local > 0 && num_local <= param_.local_newton_max_fraction_ * nc;
+        if (use_local && terminalOutputEnabled()) {
+            OpmLog::debug("Local Newton update in " + std::to_string(num_local)
+                          + " of " + std::to_string(nc) + " cells");
+        }
+        return use_local;
+    }
+
+
+
+
+
+    template <class Grid, class WellModel, class Implementation>
+    V
+    BlackoilModelBase<Grid, WellModel, Implementation>::
+    solveLocalJacobianSystem() const
+    {
+        const LinearisedBlackoilResidual local_residual = local_newton_region_.restrict(residual_);
+        const V dx = linsolver_.computeNewtonIncrement(local_residual);
+        return local_newton_region_.expand(dx, residual_.material_balance_eq.size());
+    }
+
     template <class Grid, class WellModel, class Implementation>
     void
     BlackoilModelBase<Grid, WellModel, Implementation>::
@@ -1151,7 +1352,9 @@ typedef Eigen::Array<double,
                 ReservoirState& reservoir_state,
                 WellState& well_state)
     {
+        ScopedTiming timing("updateState");
         using namespace Opm::AutoDiffGrid;
+        fip_cache_.invalidate();
         const int np = fluid_.numPhases();
         const int nc = numCells(grid_);
         const V null;
@@ -1397,8 +1600,20 @@ typedef Eigen::Array<double,
     BlackoilModelBase<Grid, WellModel, Implementation>::
     computeRelPerm(const SolutionState& state) const
     {
-        using namespace Opm::AutoDiffGrid;
-        const int               nc   = numCells(grid_);
+        return computeRelPerm(state, cells_);
+    }
+
+
+
+
+
+    template <class Grid, class WellModel, class Implementation>
+    std::vector<ADB>
+    BlackoilModelBase<Grid, WellModel, Implementation>::
+    computeRelPerm(const SolutionState& state,
+                   const std::vector<int>& cells) const
+    {
+        const int nc = cells.size();
 
         const ADB zero = ADB::constant(V::Zero(nc));
 
@@ -1415,7 +1630,7 @@ typedef Eigen::Array<double,
                          ? state.saturation[ pu.phase_pos[ Gas ] ]
                          : zero);
 
-        return fluid_.relperm(sw, so, sg, cells_);
+        return fluid_.relperm(sw, so, sg, cells);
     }
 
 
@@ -1963,14 +2178,32 @@ typedef Eigen::Array<double,
                    const ADB&              rs   ,
                    const ADB&              rv   ,
                    const std::vector<PhasePresence>& cond) const
+    {
+        return fluidViscosity(phase, p, temp, rs, rv, cond, cells_);
+    }
+
+
+
+
+
+    template <class Grid, class WellModel, class Implementation>
+    ADB
+    BlackoilModelBase<Grid, WellModel, Implementation>::
+    fluidViscosity(const int               phase,
+                   const ADB&              p    ,
+                   const ADB&              temp ,
+                   const ADB&              rs   ,
+                   const ADB&              rv   ,
+                   const std::vector<PhasePresence>& cond,
+                   const std::vector<int>& cells) const
     {
         switch (phase) {
         case Water:
-            return fluid_.muWat(p, temp, cells_);
+            return fluid_.muWat(p, temp, cells);
         case Oil:
-            return fluid_.muOil(p, temp, rs, cond, cells_);
+            return fluid_.muOil(p, temp, rs, cond, cells);
         case Gas:
-            return fluid_.muGas(p, temp, rv, cond, cells_);
+            return fluid_.muGas(p, temp, rv, cond, cells);
         default:
             OPM_THROW(std::runtime_error, "Unknown phase index " << phase);
         }
@@ -1989,14 +2222,32 @@ typedef Eigen::Array<double,
                      const ADB&              rs   ,
                      const ADB&              rv   ,
                      const std::vector<PhasePresence>& cond) const
+    {
+        return fluidReciprocFVF(phase, p, temp, rs, rv, cond, cells_);
+    }
+
+
+
+
+
+    template <class Grid, class WellModel, class Implementation>
+    ADB
+    BlackoilModelBase<Grid, WellModel, Implementation>::
+    fluidReciprocFVF(const int               phase,
+                     const ADB&              p    ,
+                     const ADB&              temp ,
+                     const ADB&              rs   ,
+                     const ADB&              rv   ,
+                     const std::vector<PhasePresence>& cond,
+                     const std::vector<int>& cells) const
     {
         switch (phase) {
         case Water:
-            return fluid_.bWat(p, temp, cells_);
+            return fluid_.bWat(p, temp, cells);
         case Oil:
-            return fluid_.bOil(p, temp, rs, cond, cells_);
+            return fluid_.bOil(p, temp, rs, cond, cells);
         case Gas:
-            return fluid_.bGas(p, temp, rv, cond, cells_);
+            return fluid_.bGas(p, temp, rv, cond, cells);
         default:
             OPM_THROW(std::runtime_error, "Unknown phase index " << phase);
         }
@@ -2274,18 +2525,30 @@ typedef Eigen::Array<double,
         saturation[Gas] = active_[Gas] ? ADB::constant(s.col(Gas)) : ADB::constant(V::Zero(nc));
         const ADB rs =  ADB::constant(Eigen::Map<const V>(& x.gasoilratio()[0], nc, 1));
         const ADB rv = ADB::constant(Eigen::Map<const V>(& x.rv()[0], nc, 1));
-        const auto canonical_phase_pressures = computePressures(pressure, saturation[Water], saturation[Oil], saturation[Gas]);
         const Opm::PhaseUsage& pu = fluid_.phaseUsage();
-        const std::vector<PhasePresence> cond = phaseCondition();
 
         const ADB pv_mult = poroMult(pressure);
         const V& pv = geo_.poreVolume();
         const int maxnp = Opm::BlackoilPhases::MaxNumPhases;
-        for (int phase = 0; phase < maxnp; ++phase) {
-            if (active_[ phase ]) {
-                const int pos = pu.phase_pos[ phase ];
-                const auto& b = asImpl().fluidReciprocFVF(phase, canonical_phase_pressures[phase], temperature, rs, rv, cond);
-                sd_.fip[phase] = ((pv_mult * b * saturation[pos] * pv).value());
+        if (fip_cache_.valid()) {
+            // x is the state in which the last nonlinear solve
+            // converged: use its reciprocal FVFs instead of evaluating
+            // the PVT properties again.
+            for (int phase = 0; phase < maxnp; ++phase) {
+                if (active_[ phase ]) {
+                    const int pos = pu.phase_pos[ phase ];
+                    sd_.fip[phase] = fip_cache_.fluidInPlace(pos, pv_mult, saturation[pos], pv);
+                }
+            }
+        } else {
+            const auto canonical_phase_pressures = computePressures(pressure, saturation[Water], saturation[Oil], saturation[Gas]);
+            const std::vector<PhasePresence> cond = phaseCondition();
+            for (int phase = 0; phase < maxnp; ++phase) {
+                if (active_[ phase ]) {
+                    const int pos = pu.phase_pos[ phase ];
+                    const auto& b = asImpl().fluidReciprocFVF(phase, canonical_phase_pressures[phase], temperature, rs, rv, cond);
+                    sd_.fip[phase] = ((pv_mult * b * saturation[pos] * pv).value());
+                }
             }
         }
 
@@ -65,6 +65,10 @@ namespace Opm
         solve_welleq_initially_ = param.getDefault("solve_welleq_initially",solve_welleq_initially_);
         update_equations_scaling_ = param.getDefault("update_equations_scaling", update_equations_scaling_);
         use_update_stabilization_ = param.getDefault("use_update_stabilization", use_update_stabilization_);
+        property_reuse_tolerance_ = param.getDefault("property_reuse_tolerance", property_reuse_tolerance_);
+        use_local_newton_ = param.getDefault("use_local_newton", use_local_newton_);
+        local_newton_halo_layers_ = param.getDefault("local_newton_halo_layers", local_newton_halo_layers_);
+        local_newton_max_fraction_ = param.getDefault("local_newton_max_fraction", local_newton_max_fraction_);
         deck_file_name_ = param.template get<std::string>("deck_filename");
         matrix_add_well_contributions_ = param.getDefault("matrix_add_well_contributions", matrix_add_well_contributions_);
         preconditioner_add_well_contributions_ = param.getDefault("preconditioner_add_well_contributions", preconditioner_add_well_contributions_);
@@ -96,6 +100,10 @@ namespace Opm
         solve_welleq_initially_ = true;
         update_equations_scaling_ = false;
         use_update_stabilization_ = true;
+        property_reuse_tolerance_ = 0.0;
+        use_local_newton_ = false;
+        local_newton_halo_layers_ = 2;
+        local_newton_max_fraction_ = 0.5;
         use_multisegment_well_ = false;
         matrix_add_well_contributions_ = false;
         preconditioner_add_well_contributions_ = false;
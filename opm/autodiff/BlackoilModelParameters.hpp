@@ -83,6 +83,25 @@ namespace Opm
         /// Try to detect oscillation or stagnation.
         bool use_update_stabilization_;
 
+        /// Reuse fluid properties between Newton iterations in cells where
+        /// pressure, rs and rv changed less than this relative amount and
+        /// saturations less than this absolute amount since the properties
+        /// were last evaluated. Zero disables reuse.
+        double property_reuse_tolerance_;
+
+        /// After the first iteration, solve only for the cells that are not
+        /// locally converged (CNV) and a halo of neighbours around them,
+        /// keeping the other cells fixed for that iteration.
+        bool use_local_newton_;
+
+        /// Number of layers of neighbouring cells added around the cells
+        /// that are not converged in a local Newton iteration.
+        int local_newton_halo_layers_;
+
+        /// Largest fraction of the cells for which a local Newton iteration
+        /// is used; with more cells to update the full system is solved.
+        double local_newton_max_fraction_;
+
         /// Whether to use MultisegmentWell to handle multisegment wells
         /// it is something temporary before the multisegment well model is considered to be
         /// well developed and tested.
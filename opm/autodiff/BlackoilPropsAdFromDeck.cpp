@@ -38,6 +38,9 @@
 
 #include <opm/common/ErrorMacros.hpp>
 
+#include <algorithm>
+#include <numeric>
+
 namespace Opm
 {
     // Making these typedef to make the code more readable.
@@ -45,6 +48,38 @@ namespace Opm
     typedef BlackoilPropsAdFromDeck::V V;
     typedef Eigen::Array<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> Block;
 
+    namespace
+    {
+        // Property with values and derivatives dv/dx, as a function
+        // of x: the jacobian is diag(dv/dx) * jac(x), block by block.
+        ADB chainRule(V&& value, const V& dvdx, const ADB& x)
+        {
+            const ADB::M dvdx_diag(dvdx.matrix().asDiagonal());
+            const int num_blocks = x.numBlocks();
+            std::vector<ADB::M> jacs(num_blocks);
+            for (int block = 0; block < num_blocks; ++block) {
+                fastSparseProduct(dvdx_diag, x.derivative()[block], jacs[block]);
+            }
+            return ADB::function(std::move(value), std::move(jacs));
+        }
+
+        // As above, for a function of x and y.
+        ADB chainRule(V&& value, const V& dvdx, const ADB& x, const V& dvdy, const ADB& y)
+        {
+            const ADB::M dvdx_diag(dvdx.matrix().asDiagonal());
+            const ADB::M dvdy_diag(dvdy.matrix().asDiagonal());
+            const int num_blocks = x.numBlocks();
+            std::vector<ADB::M> jacs(num_blocks);
+            ADB::M temp;
+            for (int block = 0; block < num_blocks; ++block) {
+                fastSparseProduct(dvdx_diag, x.derivative()[block], jacs[block]);
+                fastSparseProduct(dvdy_diag, y.derivative()[block], temp);
+                jacs[block] += temp;
+            }
+            return ADB::function(std::move(value), std::move(jacs));
+        }
+    }
+
     /// Constructor wrapping an opm-core black oil interface.
     BlackoilPropsAdFromDeck::BlackoilPropsAdFromDeck(const Opm::Deck& deck,
                                                      const Opm::EclipseState& eclState,
@@ -152,6 +187,7 @@ BlackoilPropsAdFromDeck::BlackoilPropsAdFromDeck(const BlackoilPropsAdFromDeck&
         // retrieve the cell specific PVT table index from the deck
         // and using the grid...
         extractPvtTableIndex(cellPvtRegionIdx_, eclState, number_of_cells, global_cell);
+        initPvtRegionBatches();
 
         if (init_rock){
             rock_.init(eclState, number_of_cells, global_cell, cart_dims);
@@ -187,6 +223,42 @@ BlackoilPropsAdFromDeck::BlackoilPropsAdFromDeck(const BlackoilPropsAdFromDeck&
         vap_satmax_guard_ = 0.01;
     }
 
+    void BlackoilPropsAdFromDeck::initPvtRegionBatches()
+    {
+        allCellsByRegion_ = PvtRegionBatches();
+        const int n = cellPvtRegionIdx_.size();
+        if (n == 0) {
+            return;
+        }
+        const auto minmax = std::minmax_element(cellPvtRegionIdx_.begin(), cellPvtRegionIdx_.end());
+        if (*minmax.first == *minmax.second) {
+            return;
+        }
+        std::vector<int> all_cells(n);
+        std::iota(all_cells.begin(), all_cells.end(), 0);
+        allCellsByRegion_ = PvtRegionBatches(cellPvtRegionIdx_, all_cells);
+    }
+
+    template <class Kernel>
+    void BlackoilPropsAdFromDeck::forEachPvtRegion(const Cells& cells, const Kernel& kernel) const
+    {
+        const int n = cells.size();
+        // Only the full cell array of the model is batched. Subsets such
+        // as well cells or the cells of a partial update are few and
+        // evaluated in order, as is everything with a single region.
+        bool all_cells = allCellsByRegion_.size() == n;
+        for (int i = 0; all_cells && i < n; ++i) {
+            all_cells = cells[i] == i;
+        }
+        if (all_cells) {
+            allCellsByRegion_.forEach(kernel);
+            return;
+        }
+        for (int i = 0; i < n; ++i) {
+            kernel(cellPvtRegionIdx_[cells[i]], i);
+        }
+    }
+
     ////////////////////////////
     //      Rock interface    //
     ////////////////////////////
@@ -281,8 +353,7 @@ BlackoilPropsAdFromDeck::BlackoilPropsAdFromDeck(const BlackoilPropsAdFromDeck&
 
         pEval.setDerivative(0, 1.0);
 
-        for (int i = 0; i < n; ++i) {
-            unsigned pvtRegionIdx = cellPvtRegionIdx_[cells[i]];
+        forEachPvtRegion(cells, [&](const unsigned pvtRegionIdx, const int i) {
             pEval.setValue(pw.value()[i]);
             TEval.setValue(T.value()[i]);
 
@@ -290,18 +361,12 @@ BlackoilPropsAdFromDeck::BlackoilPropsAdFromDeck(const BlackoilPropsAdFromDeck&
 
             mu[i] = muEval.value();
             dmudp[i] = muEval.derivative(0);
-        }
+        });
 
         if (pw.derivative().empty()) {
             return ADB::constant(std::move(mu));
         } else {
-            ADB::M dmudp_diag(dmudp.matrix().asDiagonal());
-            const int num_blocks = pw.numBlocks();
-            std::vector<ADB::M> jacs(num_blocks);
-            for (int block = 0; block < num_blocks; ++block) {
-                fastSparseProduct(dmudp_diag, pw.derivative()[block], jacs[block]);
-            }
-            return ADB::function(std::move(mu), std::move(jacs));
+            return chainRule(std::move(mu), dmudp, pw);
         }
     }
 
@@ -337,8 +402,7 @@ BlackoilPropsAdFromDeck::BlackoilPropsAdFromDeck(const BlackoilPropsAdFromDeck&
         RsEval.setDerivative(1, 1.0);
 
         Eval muEval;
-        for (int i = 0; i < n; ++i) {
-            unsigned pvtRegionIdx = cellPvtRegionIdx_[cells[i]];
+        forEachPvtRegion(cells, [&](const unsigned pvtRegionIdx, const int i) {
             pEval.setValue(po.value()[i]);
             TEval.setValue(T.value()[i]);
 
@@ -355,21 +419,12 @@ BlackoilPropsAdFromDeck::BlackoilPropsAdFromDeck(const BlackoilPropsAdFromDeck&
             mu[i] = muEval.value();
             dmudp[i] = muEval.derivative(0);
             dmudr[i] = muEval.derivative(1);
-        }
+        });
 
-        ADB::M dmudp_diag(dmudp.matrix().asDiagonal());
-        ADB::M dmudr_diag(dmudr.matrix().asDiagonal());
-        const int num_blocks = po.numBlocks();
-        std::vector<ADB::M> jacs(num_blocks);
-        for (int block = 0; block < num_blocks; ++block) {
-            fastSparseProduct(dmudp_diag, po.derivative()[block], jacs[block]);
-            if (phase_usage_.phase_used[Gas]) {
-                ADB::M temp;
-                fastSparseProduct(dmudr_diag, rs.derivative()[block], temp);
-                jacs[block] += temp;
-            }
+        if (phase_usage_.phase_used[Gas]) {
+            return chainRule(std::move(mu), dmudp, po, dmudr, rs);
         }
-        return ADB::function(std::move(mu), std::move(jacs));
+        return chainRule(std::move(mu), dmudp, po);
     }
 
     /// Gas viscosity.
@@ -404,8 +459,7 @@ BlackoilPropsAdFromDeck::BlackoilPropsAdFromDeck(const BlackoilPropsAdFromDeck&
         pEval.setDerivative(0, 1.0);
         RvEval.setDerivative(1, 1.0);
 
-        for (int i = 0; i < n; ++i) {
-            unsigned pvtRegionIdx = cellPvtRegionIdx_[cells[i]];
+        forEachPvtRegion(cells, [&](const unsigned pvtRegionIdx, const int i) {
             pEval.setValue(pg.value()[i]);
             TEval.setValue(T.value()[i]);
 
@@ -420,19 +474,9 @@ BlackoilPropsAdFromDeck::BlackoilPropsAdFromDeck(const BlackoilPropsAdFromDeck&
             mu[i] = muEval.value();
             dmudp[i] = muEval.derivative(0);
             dmudr[i] = muEval.derivative(1);
-        }
+        });
 
-        ADB::M dmudp_diag(dmudp.matrix().asDiagonal());
-        ADB::M dmudr_diag(dmudr.matrix().asDiagonal());
-        const int num_blocks = pg.numBlocks();
-        std::vector<ADB::M> jacs(num_blocks);
-        for (int block = 0; block < num_blocks; ++block) {
-            fastSparseProduct(dmudp_diag, pg.derivative()[block], jacs[block]);
-            ADB::M temp;
-            fastSparseProduct(dmudr_diag, rv.derivative()[block], temp);
-            jacs[block] += temp;
-        }
-        return ADB::function(std::move(mu), std::move(jacs));
+        return chainRule(std::move(mu), dmudp, pg, dmudr, rv);
     }
 
 
@@ -464,8 +508,7 @@ BlackoilPropsAdFromDeck::BlackoilPropsAdFromDeck(const BlackoilPropsAdFromDeck&
         Eval TEval = 0.0;
 
         pEval.setDerivative(0, 1.0);
-        for (int i = 0; i < n; ++i) {
-            unsigned pvtRegionIdx = cellPvtRegionIdx_[cells[i]];
+        forEachPvtRegion(cells, [&](const unsigned pvtRegionIdx, const int i) {
             pEval.setValue(pw.value()[i]);
             TEval.setValue(T.value()[i]);
 
@@ -473,15 +516,9 @@ BlackoilPropsAdFromDeck::BlackoilPropsAdFromDeck(const BlackoilPropsAdFromDeck&
 
             b[i] = bEval.value();
             dbdp[i] = bEval.derivative(0);
-        }
+        });
 
-        ADB::M dbdp_diag(dbdp.matrix().asDiagonal());
-        const int num_blocks = pw.numBlocks();
-        std::vector<ADB::M> jacs(num_blocks);
-        for (int block = 0; block < num_blocks; ++block) {
-            fastSparseProduct(dbdp_diag, pw.derivative()[block], jacs[block]);
-        }
-        return ADB::function(std::move(b), std::move(jacs));
+        return chainRule(std::move(b), dbdp, pw);
     }
 
     /// Oil formation volume factor.
@@ -517,8 +554,7 @@ BlackoilPropsAdFromDeck::BlackoilPropsAdFromDeck(const BlackoilPropsAdFromDeck&
         pEval.setDerivative(0, 1.0);
         RsEval.setDerivative(1, 1.0);
 
-        for (int i = 0; i < n; ++i) {
-            unsigned pvtRegionIdx = cellPvtRegionIdx_[cells[i]];
+        forEachPvtRegion(cells, [&](const unsigned pvtRegionIdx, const int i) {
             pEval.setValue(po.value()[i]);
             TEval.setValue(T.value()[i]);
 
@@ -539,22 +575,12 @@ BlackoilPropsAdFromDeck::BlackoilPropsAdFromDeck(const BlackoilPropsAdFromDeck&
             b[i] = bEval.value();
             dbdp[i] = bEval.derivative(0);
             dbdr[i] = bEval.derivative(1);
-        }
+        });
 
-        ADB::M dbdp_diag(dbdp.matrix().asDiagonal());
-        ADB::M dbdr_diag(dbdr.matrix().asDiagonal());
-        const int num_blocks = po.numBlocks();
-        std::vector<ADB::M> jacs(num_blocks);
-
-        for (int block = 0; block < num_blocks; ++block) {
-            fastSparseProduct(dbdp_diag, po.derivative()[block], jacs[block]);
-            if (phase_usage_.phase_used[Gas]) {
-                ADB::M temp;
-                fastSparseProduct(dbdr_diag, rs.derivative()[block], temp);
-                jacs[block] += temp;
-            }
+        if (phase_usage_.phase_used[Gas]) {
+            return chainRule(std::move(b), dbdp, po, dbdr, rs);
         }
-        return ADB::function(std::move(b), std::move(jacs));
+        return chainRule(std::move(b), dbdp, po);
     }
 
     /// Gas formation volume factor.
@@ -590,8 +616,7 @@ BlackoilPropsAdFromDeck::BlackoilPropsAdFromDeck(const BlackoilPropsAdFromDeck&
         pEval.setDerivative(0, 1.0);
         RvEval.setDerivative(1, 1.0);
 
-        for (int i = 0; i < n; ++i) {
-            unsigned pvtRegionIdx = cellPvtRegionIdx_[cells[i]];
+        forEachPvtRegion(cells, [&](const unsigned pvtRegionIdx, const int i) {
             pEval.setValue(pg.value()[i]);
             TEval.setValue(T.value()[i]);
 
@@ -606,19 +631,9 @@ BlackoilPropsAdFromDeck::BlackoilPropsAdFromDeck(const BlackoilPropsAdFromDeck&
             b[i] = bEval.value();
             dbdp[i] = bEval.derivative(0);
             dbdr[i] = bEval.derivative(1);
-        }
+        });
 
-        ADB::M dbdp_diag(dbdp.matrix().asDiagonal());
-        ADB::M dbdr_diag(dbdr.matrix().asDiagonal());
-        const int num_blocks = pg.numBlocks();
-        std::vector<ADB::M> jacs(num_blocks);
-        for (int block = 0; block < num_blocks; ++block) {
-            fastSparseProduct(dbdp_diag, pg.derivative()[block], jacs[block]);
-            ADB::M temp;
-            fastSparseProduct(dbdr_diag, rv.derivative()[block], temp);
-            jacs[block] += temp;
-        }
-        return ADB::function(std::move(b), std::move(jacs));
+        return chainRule(std::move(b), dbdp, pg, dbdr, rv);
     }
 
 
@@ -647,23 +662,16 @@ BlackoilPropsAdFromDeck::BlackoilPropsAdFromDeck(const BlackoilPropsAdFromDeck&
 
         pEval.setDerivative(0, 1.0);
 
-        for (int i = 0; i < n; ++i) {
-            unsigned pvtRegionIdx = cellPvtRegionIdx_[cells[i]];
+        forEachPvtRegion(cells, [&](const unsigned pvtRegionIdx, const int i) {
             pEval.setValue(po.value()[i]);
 
             const Eval& RsEval = FluidSystem::oilPvt().saturatedGasDissolutionFactor(pvtRegionIdx, TEval, pEval);
 
             rbub[i] = RsEval.value();
             drbubdp[i] = RsEval.derivative(0);
-        }
+        });
 
-        ADB::M drbubdp_diag(drbubdp.matrix().asDiagonal());
-        const int num_blocks = po.numBlocks();
-        std::vector<ADB::M> jacs(num_blocks);
-        for (int block = 0; block < num_blocks; ++block) {
-            fastSparseProduct(drbubdp_diag, po.derivative()[block], jacs[block]);
-        }
-        return ADB::function(std::move(rbub), std::move(jacs));
+        return chainRule(std::move(rbub), drbubdp, po);
     }
 
     /// Bubble point curve for Rs as function of oil pressure.
@@ -704,23 +712,16 @@ BlackoilPropsAdFromDeck::BlackoilPropsAdFromDeck(const BlackoilPropsAdFromDeck&
 
         pEval.setDerivative(0, 1.0);
 
-        for (int i = 0; i < n; ++i) {
-            unsigned pvtRegionIdx = cellPvtRegionIdx_[cells[i]];
+        forEachPvtRegion(cells, [&](const unsigned pvtRegionIdx, const int i) {
             pEval.setValue(pg.value()[i]);
 
             const Eval& RvEval = FluidSystem::gasPvt().saturatedOilVaporizationFactor(pvtRegionIdx, TEval, pEval);
 
             rv[i] = RvEval.value();
             drvdp[i] = RvEval.derivative(0);
-        }
+        });
 
-        ADB::M drvdp_diag(drvdp.matrix().asDiagonal());
-        const int num_blocks = pg.numBlocks();
-        std::vector<ADB::M> jacs(num_blocks);
-        for (int block = 0; block < num_blocks; ++block) {
-            fastSparseProduct(drvdp_diag, pg.derivative()[block], jacs[block]);
-        }
-        return ADB::function(std::move(rv), std::move(jacs));
+        return chainRule(std::move(rv), drvdp, pg);
     }
 
     /// Condensation curve for Rv as function of oil pressure.
@@ -966,15 +967,14 @@ BlackoilPropsAdFromDeck::BlackoilPropsAdFromDeck(const BlackoilPropsAdFromDeck&
         const int n = cells.size();
         std::vector<double> Pb(n, 0.0);
 
-        for (int i = 0; i < n; ++i) {
-            unsigned pvtRegionIdx = cellPvtRegionIdx_[cells[i]];
+        forEachPvtRegion(cells, [&](const unsigned pvtRegionIdx, const int i) {
             try {
                 Pb[i] = FluidSystem::oilPvt().saturationPressure(pvtRegionIdx, T[i], rs[i]);
             }
             catch (const NumericalIssue&) {
                 // Ignore
             }
-        }
+        });
 
         return Pb;
     }
@@ -990,15 +990,14 @@ BlackoilPropsAdFromDeck::BlackoilPropsAdFromDeck(const BlackoilPropsAdFromDeck&
         const int n = cells.size();
         std::vector<double> Pd(n, 0.0);
 
-        for (int i = 0; i < n; ++i) {
-            unsigned pvtRegionIdx = cellPvtRegionIdx_[cells[i]];
+        forEachPvtRegion(cells, [&](const unsigned pvtRegionIdx, const int i) {
             try {
                 Pd[i] = FluidSystem::gasPvt().saturationPressure(pvtRegionIdx, T[i], rv[i]);
             }
             catch (const NumericalIssue&) {
                 // Ignore
             }
-        }
+        });
 
         return Pd;
     }
@@ -24,6 +24,7 @@
 
 #include <opm/autodiff/AutoDiffBlock.hpp>
 #include <opm/autodiff/BlackoilModelEnums.hpp>
+#include <opm/autodiff/PvtRegionBatches.hpp>
 
 #include <opm/core/props/satfunc/SaturationPropsFromDeck.hpp>
 #include <opm/core/props/rock/RockFromDeck.hpp>
@@ -479,6 +480,16 @@ namespace Opm
                       const std::vector<int>& cells,
                       const double vap) const;
 
+        /// Groups all cells by PVT region. Called whenever
+        /// cellPvtRegionIdx_ has been set.
+        void initPvtRegionBatches();
+
+        /// Calls kernel(region, i) for every entry i of cells. When cells
+        /// are all cells in order and there are several PVT regions, the
+        /// entries are visited one region at a time, otherwise in order.
+        template <class Kernel>
+        void forEachPvtRegion(const std::vector<int>& cells, const Kernel& kernel) const;
+
         RockFromDeck rock_;
 
         // This has to be a shared pointer as we must
@@ -492,6 +503,8 @@ namespace Opm
 
         // The PVT region which is to be used for each cell
         std::vector<int> cellPvtRegionIdx_;
+        // All cells grouped by PVT region, empty with a single region
+        PvtRegionBatches allCellsByRegion_;
 
         // VAPPARS
         double vap1_;
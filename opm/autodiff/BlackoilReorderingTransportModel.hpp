@@ -26,11 +26,16 @@
 #include <opm/autodiff/DebugTimeReport.hpp>
 #include <opm/autodiff/multiPhaseUpwind.hpp>
 #include <opm/grid/UnstructuredGrid.h>
-#include <opm/core/transport/reorder/reordersequence.h>
+#include <opm/core/transport/reorder/ComponentLevelSchedule.hpp>
+#include <opm/core/transport/reorder/ReorderSequenceCache.hpp>
+#include <opm/core/transport/reorder/ComponentNewtonSolver.hpp>
 #include <opm/core/simulator/BlackoilState.hpp>
 
 #include <opm/autodiff/BlackoilTransportModel.hpp>
 
+#include <algorithm>
+#include <vector>
+
 namespace Opm {
 
 
@@ -82,6 +87,22 @@ namespace Opm {
 
 
 
+        inline double scalarValue(const double x)
+        {
+            return x;
+        }
+
+
+
+        template <typename Scalar>
+        double scalarValue(const Scalar& x)
+        {
+            return x.value();
+        }
+
+
+
+
         struct Connection
         {
             Connection(const int ind, const double s) : index(ind), sign(s) {}
@@ -442,14 +463,19 @@ namespace Opm {
         V total_wellflux_cell_;
         V oil_wellflux_cell_;
         V gas_wellflux_cell_;
-        std::vector<int> sequence_;
-        std::vector<int> components_;
+        ReorderSequenceCache ordering_;
         V trans_all_;
         V gdz_;
         DataBlock rhos_;
 
-        std::array<double, 2> max_abs_dx_;
-        std::array<int, 2> max_abs_dx_cell_;
+        // Largest update seen by a thread in solveComponents().
+        struct MaxChange
+        {
+            std::array<double, 2> dx = {{ 0.0, 0.0 }};
+            std::array<int, 2> cell = {{ -1, -1 }};
+        };
+        std::vector<MaxChange> max_change_;
+        ComponentLevelSchedule schedule_;
 
         // TODO: remove this, for debug only.
         BlackoilTransportModel<Grid, WellModel> tr_model_;
@@ -585,19 +611,14 @@ namespace Opm {
             static_assert(std::is_same<Grid, UnstructuredGrid>::value,
                           "compute_sequence() is written in C and therefore requires an UnstructuredGrid, "
                           "it must be rewritten to use other grid classes such as CpGrid");
-            using namespace Opm::AutoDiffGrid;
-            const int num_cells = numCells(grid_);
-            sequence_.resize(num_cells);
-            components_.resize(num_cells + 1); // max possible size
-            int num_components = -1;
-
-
             using namespace Opm::AutoDiffGrid;
             const int num_faces = numFaces(grid_);
             V flux_on_all_faces = superset(total_flux_, ops_.internal_faces, num_faces);
-            compute_sequence(&grid_, flux_on_all_faces.data(), sequence_.data(), components_.data(), &num_components);
-            OpmLog::debug(std::string("Number of components: ") + std::to_string(num_components));
-            components_.resize(num_components + 1); // resize to fit actually used part
+            const auto update = ordering_.update(grid_, flux_on_all_faces.data());
+            const char* how = update == ReorderSequenceCache::Reused ? "reused"
+                : (update == ReorderSequenceCache::Repaired ? "repaired" : "computed");
+            OpmLog::debug(std::string("Number of components: ") + std::to_string(ordering_.numComponents())
+                          + " (ordering " + how + ")");
         }
 
 
@@ -605,28 +626,49 @@ namespace Opm {
 
         void solveComponents()
         {
-            // Zero the max changed.
-            max_abs_dx_[0] = 0.0;
-            max_abs_dx_[1] = 0.0;
-            max_abs_dx_cell_[0] = -1;
-            max_abs_dx_cell_[1] = -1;
-
-            // Solve the equations.
-            const int num_components = components_.size() - 1;
-            for (int comp = 0; comp < num_components; ++comp) {
-                const int comp_size = components_[comp + 1] - components_[comp];
+            // Zero the max changed, one record per thread.
+#if HAVE_OPENMP
+            max_change_.assign(omp_get_max_threads(), MaxChange());
+#else
+            max_change_.assign(1, MaxChange());
+#endif // HAVE_OPENMP
+
+            // Solve the equations. Components that do not touch each
+            // other are solved concurrently, one level at a time.
+            const std::vector<int>& sequence = ordering_.sequence();
+            const std::vector<int>& components = ordering_.components();
+            const int num_components = ordering_.numComponents();
+            auto solveComponent = [this, &sequence, &components](const int comp) {
+                const int comp_size = components[comp + 1] - components[comp];
                 if (comp_size == 1) {
-                    solveSingleCell(sequence_[components_[comp]]);
+                    solveSingleCell(sequence[components[comp]]);
                 } else {
-                    solveMultiCell(comp_size, &sequence_[components_[comp]]);
+                    solveMultiCell(comp_size, &sequence[components[comp]]);
+                }
+            };
+            if (ComponentLevelSchedule::parallelRunAvailable()) {
+                schedule_.compute(grid_, sequence.data(), components.data(), num_components);
+                schedule_.run(solveComponent);
+            } else {
+                for (int comp = 0; comp < num_components; ++comp) {
+                    solveComponent(comp);
                 }
             }
 
             // Log the max change.
             {
+                MaxChange max_change;
+                for (const MaxChange& mc : max_change_) {
+                    for (int i = 0; i < 2; ++i) {
+                        if (mc.dx[i] > max_change.dx[i]) {
+                            max_change.dx[i] = mc.dx[i];
+                            max_change.cell[i] = mc.cell[i];
+                        }
+                    }
+                }
                 std::ostringstream os;
-                os << "===  Max abs dx[0]: " << max_abs_dx_[0] << " (cell " << max_abs_dx_cell_[0]
-                   <<")  dx[1]: " << max_abs_dx_[1] << " (cell " << max_abs_dx_cell_[1] << ")";
+                os << "===  Max abs dx[0]: " << max_change.dx[0] << " (cell " << max_change.cell[0]
+                   <<")  dx[1]: " << max_change.dx[1] << " (cell " << max_change.cell[1] << ")";
                 OpmLog::debug(os.str());
             }
         }
@@ -681,6 +723,9 @@ namespace Opm {
                 os << "Failed to converge in cell " << cell << ", residual = " << res
                    << ", cell values { s = ( " << cstate_[cell].s[Water] << ", " << cstate_[cell].s[Oil] << ", " << cstate_[cell].s[Gas]
                    << " ), rs = " << cstate_[cell].rs << ", rv = " << cstate_[cell].rv << " }";
+#if HAVE_OPENMP
+#pragma omp critical(BlackoilReorderingTransportModelLog)
+#endif // HAVE_OPENMP
                 OpmLog::debug(os.str());
             }
         }
@@ -689,9 +734,96 @@ namespace Opm {
 
 
 
+        /// The coupled equations of all cells in a strongly connected
+        /// component, in the form required by ComponentNewtonSolver.
+        struct MultiCellProblem
+        {
+            BlackoilReorderingTransportModel& model;
+
+            void assemble(const int cell, ComponentNewtonSolver<2>::System& sys)
+            {
+                Vec2 res;
+                Mat22 jac;
+                model.assembleSingleCell(cell, res, jac);
+                double* r = sys.residual(cell);
+                r[0] = res[0];
+                r[1] = res[1];
+                const double diag[4] = { jac[0][0], jac[0][1], jac[1][0], jac[1][1] };
+                sys.addJacobian(cell, cell, diag);
+
+                // Derivatives with respect to the neighbours in the
+                // component, with the state of this cell held constant.
+                for (auto conn : model.graph_.cellConnections(cell)) {
+                    const int other = model.connectionNeighbour(cell, conn);
+                    if (other < 0 || !sys.contains(other)) {
+                        continue;
+                    }
+                    CellState<Eval> ost;
+                    model.computeCellState(other, model.state_, ost);
+                    Eval oilflux = Eval::createConstant(0.0);
+                    Eval gasflux = Eval::createConstant(0.0);
+                    model.addConnectionFlux(conn, model.cstate_[cell], ost, oilflux, gasflux);
+                    const double offdiag[4] = { oilflux.derivative(0), oilflux.derivative(1),
+                                                gasflux.derivative(0), gasflux.derivative(1) };
+                    sys.addJacobian(cell, other, offdiag);
+                }
+            }
+
+            bool converged(const int cell, const double* residual)
+            {
+                Vec2 res;
+                res[0] = residual[0];
+                res[1] = residual[1];
+                return model.getConvergence(cell, res);
+            }
+
+            void update(const int cell, const double* dx)
+            {
+                Vec2 neg_dx;
+                neg_dx[0] = -dx[0];
+                neg_dx[1] = -dx[1];
+                model.updateState(cell, neg_dx);
+                // Neighbours in the component read this cell's state.
+                model.computeCellState(cell, model.state_, model.cstate_[cell]);
+            }
+        };
+
+
+
+
         void solveMultiCell(const int comp_size, const int* cell_array)
         {
-            // OpmLog::warning("solveMultiCell", "solveMultiCell() called with component size " + std::to_string(comp_size));
+            // Save the state of the component, and make sure the cell
+            // states seen by the coupled assembly are up to date.
+            auto& rstate = state_.reservoir_state;
+            std::vector<double> sat0(3*comp_size);
+            std::vector<double> rs0(comp_size);
+            std::vector<double> rv0(comp_size);
+            std::vector<HydroCarbonState> hcstate0(comp_size);
+            for (int ii = 0; ii < comp_size; ++ii) {
+                const int cell = cell_array[ii];
+                std::copy_n(rstate.saturation().data() + 3*cell, 3, sat0.data() + 3*ii);
+                rs0[ii] = rstate.gasoilratio()[cell];
+                rv0[ii] = rstate.rv()[cell];
+                hcstate0[ii] = rstate.hydroCarbonState()[cell];
+                computeCellState(cell, state_, cstate_[cell]);
+            }
+
+            // Solve the component as one coupled system.
+            MultiCellProblem problem{ *this };
+            if (ComponentNewtonSolver<2>().solve(problem, comp_size, cell_array) >= 0) {
+                return;
+            }
+
+            // Restore and fall back to a single sweep of cell solves.
+            for (int ii = 0; ii < comp_size; ++ii) {
+                const int cell = cell_array[ii];
+                std::copy_n(sat0.data() + 3*ii, 3, rstate.saturation().data() + 3*cell);
+                rstate.gasoilratio()[cell] = rs0[ii];
+                rstate.rv()[cell] = rv0[ii];
+                rstate.hydroCarbonState()[cell] = hcstate0[ii];
+                computeCellState(cell, state_, cstate_[cell]);
+            }
             for (int ii = 0; ii < comp_size; ++ii) {
                 solveSingleCell(cell_array[ii]);
             }
@@ -731,6 +863,88 @@ namespace Opm {
 
 
 
+        /// The cell on the other side of a connection, or -1 on the boundary.
+        int connectionNeighbour(const int cell, const detail::Connection& conn) const
+        {
+            auto conn_cells = graph_.connectionCells(conn.index);
+            const int from = conn_cells[0];
+            const int to = conn_cells[1];
+            if (from < 0 || to < 0) {
+                return -1;
+            }
+            assert((from == cell) == (conn.sign > 0.0));
+            return from == cell ? to : from;
+        }
+
+
+
+
+        /// Add the oil and gas fluxes over a connection to div_oilflux
+        /// and div_gasflux. Everything about the connection is treated
+        /// as going from the cell of st to the cell of ost. One of the
+        /// two states is expected to be constant (Scalar = double), the
+        /// derivatives are then those with respect to the other one.
+        template <typename S1, typename S2>
+        void addConnectionFlux(const detail::Connection& conn,
+                               const CellState<S1>& st,
+                               const CellState<S2>& ost,
+                               Eval& div_oilflux,
+                               Eval& div_gasflux)
+        {
+            const double vt = conn.sign * total_flux_[conn.index];
+            const double gdz = conn.sign * gdz_[conn.index];
+
+            Eval dh[3];
+            Eval dh_sat[3];
+            const Eval grad_oil_press = ost.p[Oil] - st.p[Oil];
+            for (int phase : { Water, Oil, Gas }) {
+                const Eval gradp = ost.p[phase] - st.p[phase];
+                const Eval rhoavg = 0.5 * (st.rho[phase] + ost.rho[phase]);
+                dh[phase] = gradp - rhoavg * gdz;
+                if (Base::use_threshold_pressure_) {
+                    applyThresholdPressure(conn.index, dh[phase]);
+                }
+                dh_sat[phase] = grad_oil_press - dh[phase];
+            }
+            const double tran = trans_all_[conn.index]; // TODO: include tr_mult effect.
+            const auto& m1 = st.lambda;
+            const auto& m2 = ost.lambda;
+            using detail::scalarValue;
+            const auto upw = connectionMultiPhaseUpwind({{ dh_sat[Water].value(), dh_sat[Oil].value(), dh_sat[Gas].value() }},
+                                                        {{ scalarValue(m1[Water]), scalarValue(m1[Oil]), scalarValue(m1[Gas]) }},
+                                                        {{ scalarValue(m2[Water]), scalarValue(m2[Oil]), scalarValue(m2[Gas]) }},
+                                                        tran, vt);
+            // if (upw[0] != upw[1] || upw[1] != upw[2]) {
+            //     OpmLog::debug("Detected countercurrent flow over connection " + std::to_string(conn.index));
+            // }
+            Eval b[3];
+            Eval mob[3];
+            Eval tot_mob = Eval::createConstant(0.0);
+            for (int phase : { Water, Oil, Gas }) {
+                b[phase] = upw[phase] > 0.0 ? Eval(st.b[phase]) : Eval(ost.b[phase]);
+                mob[phase] = upw[phase] > 0.0 ? Eval(m1[phase]) : Eval(m2[phase]);
+                tot_mob += mob[phase];
+            }
+            Eval rs = upw[Oil] > 0.0 ? Eval(st.rs) : Eval(ost.rs);
+            Eval rv = upw[Gas] > 0.0 ? Eval(st.rv) : Eval(ost.rv);
+
+            Eval flux[3];
+            for (int phase : { Oil, Gas }) {
+                Eval gflux = Eval::createConstant(0.0);
+                for (int other_phase : { Water, Oil, Gas }) {
+                    if (phase != other_phase) {
+                        gflux += mob[other_phase] * (dh_sat[phase] - dh_sat[other_phase]);
+                    }
+                }
+                flux[phase] = b[phase] * (mob[phase] / tot_mob) * (vt + tran*gflux);
+            }
+            div_oilflux += flux[Oil] + rv*flux[Gas];
+            div_gasflux += flux[Gas] + rs*flux[Oil];
+        }
+
+
+
+
         void assembleSingleCell(const int cell, Vec2& res, Mat22& jac)
         {
             assert(numPhases() == 3); // I apologize for this to my future self, that will have to fix it.
@@ -751,67 +965,14 @@ namespace Opm {
             Eval div_oilflux = Eval::createConstant(0.0);
             Eval div_gasflux = Eval::createConstant(0.0);
             for (auto conn : graph_.cellConnections(cell)) {
-                auto conn_cells = graph_.connectionCells(conn.index);
-                const int from = conn_cells[0];
-                const int to = conn_cells[1];
-                if (from < 0 || to < 0) {
+                const int other = connectionNeighbour(cell, conn);
+                if (other < 0) {
                     continue; // Boundary.
                 }
-                assert((from == cell) == (conn.sign > 0.0));
-                const int other = from == cell ? to : from;
-                const double vt = conn.sign * total_flux_[conn.index];
-                const double gdz = conn.sign * gdz_[conn.index];
-
-                // From this point, we treat everything about this
-                // connection as going from 'cell' to 'other'. Since
-                // we don't want derivatives from the 'other' cell to
-                // participate in the solution, we use the constant
-                // values from cstate_[other].
-                Eval dh[3];
-                Eval dh_sat[3];
-                const Eval grad_oil_press = cstate_[other].p[Oil] - st.p[Oil];
-                for (int phase : { Water, Oil, Gas }) {
-                    const Eval gradp = cstate_[other].p[phase] - st.p[phase];
-                    const Eval rhoavg = 0.5 * (st.rho[phase] + cstate_[other].rho[phase]);
-                    dh[phase] = gradp - rhoavg * gdz;
-                    if (Base::use_threshold_pressure_) {
-                        applyThresholdPressure(conn.index, dh[phase]);
-                    }
-                    dh_sat[phase] = grad_oil_press - dh[phase];
-                }
-                const double tran = trans_all_[conn.index]; // TODO: include tr_mult effect.
-                const auto& m1 = st.lambda;
-                const auto& m2 = cstate_[other].lambda;
-                const auto upw = connectionMultiPhaseUpwind({{ dh_sat[Water].value(), dh_sat[Oil].value(), dh_sat[Gas].value() }},
-                                                            {{ m1[Water].value(), m1[Oil].value(), m1[Gas].value() }},
-                                                            {{ m2[Water], m2[Oil], m2[Gas] }},
-                                                            tran, vt);
-                // if (upw[0] != upw[1] || upw[1] != upw[2]) {
-                //     OpmLog::debug("Detected countercurrent flow between cells " + std::to_string(from) + " and " + std::to_string(to));
-                // }
-                Eval b[3];
-                Eval mob[3];
-                Eval tot_mob = Eval::createConstant(0.0);
-                for (int phase : { Water, Oil, Gas }) {
-                    b[phase] = upw[phase] > 0.0 ? st.b[phase] : cstate_[other].b[phase];
-                    mob[phase] = upw[phase] > 0.0 ? m1[phase] : m2[phase];
-                    tot_mob += mob[phase];
-                }
-                Eval rs = upw[Oil] > 0.0 ? st.rs : cstate_[other].rs;
-                Eval rv = upw[Gas] > 0.0 ? st.rv : cstate_[other].rv;
-
-                Eval flux[3];
-                for (int phase : { Oil, Gas }) {
-                    Eval gflux = Eval::createConstant(0.0);
-                    for (int other_phase : { Water, Oil, Gas }) {
-                        if (phase != other_phase) {
-                            gflux += mob[other_phase] * (dh_sat[phase] - dh_sat[other_phase]);
-                        }
-                    }
-                    flux[phase] = b[phase] * (mob[phase] / tot_mob) * (vt + tran*gflux);
-                }
-                div_oilflux += flux[Oil] + rv*flux[Gas];
-                div_gasflux += flux[Gas] + rs*flux[Oil];
+                // Since we don't want derivatives from the 'other'
+                // cell to participate in the solution, we use the
+                // constant values from cstate_[other].
+                addConnectionFlux(conn, st, cstate_[other], div_oilflux, div_gasflux);
             }
 
             // Well fluxes.
@@ -860,14 +1021,17 @@ namespace Opm {
         void updateState(const int cell,
                          const Vec2& dx)
         {
-            if (std::fabs(dx[0]) > max_abs_dx_[0]) {
-                max_abs_dx_cell_[0] = cell;
-            }
-            if (std::fabs(dx[1]) > max_abs_dx_[1]) {
-                max_abs_dx_cell_[1] = cell;
+#if HAVE_OPENMP
+            MaxChange& max_change = max_change_[omp_get_thread_num()];
+#else
+            MaxChange& max_change = max_change_[0];
+#endif // HAVE_OPENMP
+            for (int i = 0; i < 2; ++i) {
+                if (std::fabs(dx[i]) > max_change.dx[i]) {
+                    max_change.dx[i] = std::fabs(dx[i]);
+                    max_change.cell[i] = cell;
+                }
             }
-            max_abs_dx_[0] = std::max(max_abs_dx_[0], std::fabs(dx[0]));
-            max_abs_dx_[1] = std::max(max_abs_dx_[1], std::fabs(dx[1]));
 
             // Get saturation updates.
             const double dsw = dx[0];
@@ -37,6 +37,9 @@
 
 #include <opm/common/utility/platform_dependent/reenable_warnings.h>
 
+#include <algorithm>
+#include <cassert>
+
 namespace Opm
 {
 
@@ -62,6 +65,41 @@ namespace Opm
             init( rows, cols, ia, ja, sa );
         }
 
+        /// \brief overwrite the entries with those of an Eigen::SparseMatrix,
+        ///        if it has the sparsity structure of this matrix
+        ///
+        /// The structure is compared row by row while copying, so that the
+        /// check costs no extra pass over the matrix. The storage is reused,
+        /// so that objects referring to this matrix stay valid.
+        /// \return false if the structure differs, the values are then undefined
+        bool updateValuesIfSameStructure( const Eigen::SparseMatrix<double, Eigen::RowMajor>& matrix )
+        {
+            if( int(this->N()) != matrix.rows() || int(this->M()) != matrix.cols() ||
+                int(this->nonzeroes()) != matrix.nonZeros() ) {
+                return false;
+            }
+            const int* ia = matrix.outerIndexPtr();
+            const int* ja = matrix.innerIndexPtr();
+            const double* sa = matrix.valuePtr();
+            double* a = reinterpret_cast<double*>(this->a);
+            for (int row = 0; row < matrix.rows(); ++row) {
+                const auto& r = (*this)[row];
+                const int begin = ia[row];
+                const int end = ia[row+1];
+                if( int(r.getsize()) != end - begin ) {
+                    return false;
+                }
+                const auto* cols = r.getindexptr();
+                for (int k = begin; k < end; ++k) {
+                    if( int(cols[k - begin]) != ja[k] ) {
+                        return false;
+                    }
+                    a[k] = sa[k];
+                }
+            }
+            return true;
+        }
+
     protected:
         void init(const int rows, const int cols, const int* ia, const int* ja, const double* sa)
         {
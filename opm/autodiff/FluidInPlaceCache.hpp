@@ -0,0 +1,106 @@
+/*
+  Copyright 2017 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_FLUIDINPLACECACHE_HEADER_INCLUDED
+#define OPM_FLUIDINPLACECACHE_HEADER_INCLUDED
+
+#include <opm/autodiff/AutoDiffBlock.hpp>
+
+#include <cassert>
+#include <vector>
+
+namespace Opm
+{
+
+    /// Reciprocal formation volume factors of the state in which a
+    /// nonlinear solve converged, kept for computing the fluid in place
+    /// of that state without evaluating the PVT properties again.
+    ///
+    /// The owner calls assembled() on every assembly, converged() when
+    /// the nonlinear solve stops in the state of the last assembly, and
+    /// invalidate() whenever its state changes. The cache is valid from
+    /// converged() to the next invalidate() or assembled(), provided
+    /// the last assembly evaluated the FVFs in all cells and the state
+    /// did not change since.
+    class FluidInPlaceCache
+    {
+    public:
+        typedef AutoDiffBlock<double> ADB;
+        typedef ADB::V V;
+
+        FluidInPlaceCache()
+            : assembled_all_cells_(false)
+            , valid_(false)
+        {
+        }
+
+        /// A new assembly started.
+        /// \param[in] all_cells  whether the reciprocal FVFs of this
+        ///                       assembly are evaluated in all cells,
+        ///                       i.e. none are carried over from an
+        ///                       earlier iterate
+        void assembled(const bool all_cells)
+        {
+            assembled_all_cells_ = all_cells;
+            valid_ = false;
+        }
+
+        /// The nonlinear solve converged in the state of the last
+        /// assembly. Stores rq[pos].b.value() for pos = 0, ..., np - 1.
+        template <class RateQuantities>
+        void converged(const RateQuantities& rq, const int np)
+        {
+            valid_ = assembled_all_cells_;
+            if (!valid_) {
+                return;
+            }
+            b_.resize(np);
+            for (int pos = 0; pos < np; ++pos) {
+                b_[pos] = rq[pos].b.value();
+            }
+        }
+
+        /// The state changed since the last assembly.
+        void invalidate()
+        {
+            assembled_all_cells_ = false;
+            valid_ = false;
+        }
+
+        /// Whether the stored FVFs belong to the converged state.
+        bool valid() const { return valid_; }
+
+        /// Fluid in place of phase pos in each cell, from the stored
+        /// reciprocal FVFs. Same as (pv_mult * b * s * pv).value()
+        /// with b evaluated in the converged state.
+        V fluidInPlace(const int pos, const ADB& pv_mult, const ADB& s, const V& pv) const
+        {
+            assert(valid_);
+            return pv_mult.value() * b_[pos] * s.value() * pv;
+        }
+
+    private:
+        bool assembled_all_cells_;
+        bool valid_;
+        std::vector<V> b_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_FLUIDINPLACECACHE_HEADER_INCLUDED
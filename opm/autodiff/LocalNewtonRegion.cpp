@@ -0,0 +1,174 @@
+/*
+  Copyright 2017 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+#include <opm/autodiff/LocalNewtonRegion.hpp>
+
+#include <cassert>
+
+namespace Opm
+{
+
+    namespace
+    {
+        /// Matrix with one unit entry per column, in row cells[col].
+        Eigen::SparseMatrix<double> selector(const int num_cells, const std::vector<int>& cells)
+        {
+            const int m = cells.size();
+            Eigen::SparseMatrix<double> s(num_cells, m);
+            s.reserve(Eigen::VectorXi::Constant(m, 1));
+            for (int i = 0; i < m; ++i) {
+                s.insert(cells[i], i) = 1.0;
+            }
+            s.makeCompressed();
+            return s;
+        }
+    }
+
+
+    LocalNewtonRegion::LocalNewtonRegion(const int num_cells, const TwoColInt& connection_cells)
+        : num_cells_(num_cells),
+          neighbour_start_(num_cells + 1, 0)
+    {
+        const int nconn = connection_cells.rows();
+        for (int conn = 0; conn < nconn; ++conn) {
+            const int c0 = connection_cells(conn, 0);
+            const int c1 = connection_cells(conn, 1);
+            if (c0 >= 0 && c1 >= 0) {
+                ++neighbour_start_[c0 + 1];
+                ++neighbour_start_[c1 + 1];
+            }
+        }
+        for (int c = 0; c < num_cells; ++c) {
+            neighbour_start_[c + 1] += neighbour_start_[c];
+        }
+        neighbours_.resize(neighbour_start_[num_cells]);
+        std::vector<int> pos(neighbour_start_.begin(), neighbour_start_.end() - 1);
+        for (int conn = 0; conn < nconn; ++conn) {
+            const int c0 = connection_cells(conn, 0);
+            const int c1 = connection_cells(conn, 1);
+            if (c0 >= 0 && c1 >= 0) {
+                neighbours_[pos[c0]++] = c1;
+                neighbours_[pos[c1]++] = c0;
+            }
+        }
+    }
+
+
+    void LocalNewtonRegion::select(const std::vector<bool>& flagged, const int halo_layers)
+    {
+        assert(static_cast<int>(flagged.size()) == num_cells_);
+        std::vector<bool> in_region(flagged);
+        std::vector<int> front;
+        for (int c = 0; c < num_cells_; ++c) {
+            if (flagged[c]) {
+                front.push_back(c);
+            }
+        }
+        std::vector<int> next;
+        for (int layer = 0; layer < halo_layers && !front.empty(); ++layer) {
+            next.clear();
+            for (const int c : front) {
+                for (int k = neighbour_start_[c]; k < neighbour_start_[c + 1]; ++k) {
+                    const int nb = neighbours_[k];
+                    if (!in_region[nb]) {
+                        in_region[nb] = true;
+                        next.push_back(nb);
+                    }
+                }
+            }
+            front.swap(next);
+        }
+
+        cells_.clear();
+        for (int c = 0; c < num_cells_; ++c) {
+            if (in_region[c]) {
+                cells_.push_back(c);
+            }
+        }
+    }
+
+
+    LinearisedBlackoilResidual
+    LocalNewtonRegion::restrict(const LinearisedBlackoilResidual& residual) const
+    {
+        const int num_cell_vars = residual.material_balance_eq.size();
+        LinearisedBlackoilResidual local = residual;
+        for (int eq = 0; eq < num_cell_vars; ++eq) {
+            local.material_balance_eq[eq] = restrictEquation(residual.material_balance_eq[eq], num_cell_vars, true);
+        }
+        local.well_flux_eq = restrictEquation(residual.well_flux_eq, num_cell_vars, false);
+        local.well_eq = restrictEquation(residual.well_eq, num_cell_vars, false);
+        return local;
+    }
+
+
+    LocalNewtonRegion::ADB
+    LocalNewtonRegion::restrictEquation(const ADB& eq, const int num_cell_vars, const bool restrict_rows) const
+    {
+        const int num_blocks = eq.numBlocks();
+        if (num_blocks == 0) {
+            return eq;
+        }
+        assert(num_blocks >= num_cell_vars);
+        const Eigen::SparseMatrix<double> s = selector(num_cells_, cells_);
+        const Eigen::SparseMatrix<double> st = s.transpose();
+
+        std::vector<ADB::M> jacs(num_blocks);
+        for (int block = 0; block < num_blocks; ++block) {
+            Eigen::SparseMatrix<double> jac;
+            eq.derivative()[block].toSparse(jac);
+            if (block < num_cell_vars) {
+                assert(jac.cols() == num_cells_);
+                jac = jac * s;
+            }
+            if (restrict_rows) {
+                jac = st * jac;
+            }
+            jacs[block] = ADB::M(std::move(jac));
+        }
+        V val = eq.value();
+        if (restrict_rows) {
+            V local_val(cells_.size());
+            for (int i = 0; i < local_val.size(); ++i) {
+                local_val[i] = val[cells_[i]];
+            }
+            val = std::move(local_val);
+        }
+        return ADB::function(std::move(val), std::move(jacs));
+    }
+
+
+    LocalNewtonRegion::V
+    LocalNewtonRegion::expand(const V& dx, const int num_cell_vars) const
+    {
+        const int m = cells_.size();
+        const int num_well_vars = dx.size() - num_cell_vars*m;
+        assert(num_well_vars >= 0);
+        V full = V::Zero(num_cell_vars*num_cells_ + num_well_vars);
+        for (int var = 0; var < num_cell_vars; ++var) {
+            for (int i = 0; i < m; ++i) {
+                full[var*num_cells_ + cells_[i]] = dx[var*m + i];
+            }
+        }
+        full.tail(num_well_vars) = dx.tail(num_well_vars);
+        return full;
+    }
+
+} // namespace Opm
@@ -0,0 +1,90 @@
+/*
+  Copyright 2017 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_LOCALNEWTONREGION_HEADER_INCLUDED
+#define OPM_LOCALNEWTONREGION_HEADER_INCLUDED
+
+#include <opm/autodiff/AutoDiffBlock.hpp>
+#include <opm/autodiff/LinearisedBlackoilResidual.hpp>
+
+#include <vector>
+
+namespace Opm
+{
+
+    /// The set of cells updated by a localised Newton iteration.
+    ///
+    /// After the first iterations of a step, the residual is often
+    /// large only in a small part of the domain (near wells or a
+    /// moving front). Instead of solving the linear system for all
+    /// cells, the Newton update can be restricted to the cells that
+    /// are not converged plus a few layers of neighbours, keeping the
+    /// other cells fixed for this iteration. The convergence check is
+    /// still done on the full residual, so cells outside the region
+    /// are brought into it again as soon as their residual grows.
+    ///
+    /// The restricted system keeps the rows of the material balance
+    /// equations in the region and the columns of the cell variables
+    /// in the region, while all well equations and well variables are
+    /// kept.
+    class LocalNewtonRegion
+    {
+    public:
+        typedef AutoDiffBlock<double> ADB;
+        typedef ADB::V V;
+        typedef Eigen::Array<int, Eigen::Dynamic, 2, Eigen::RowMajor> TwoColInt;
+
+        /// Construct the cell neighbourship from the cell pairs of
+        /// all connections (faces and non-neighbouring connections).
+        LocalNewtonRegion(const int num_cells, const TwoColInt& connection_cells);
+
+        /// Select the cells with flagged[cell] true, together with
+        /// halo_layers layers of neighbouring cells.
+        void select(const std::vector<bool>& flagged, const int halo_layers);
+
+        /// Selected cells, in increasing order.
+        const std::vector<int>& cells() const { return cells_; }
+
+        /// Number of cells of the full system.
+        int numCells() const { return num_cells_; }
+
+        /// Restrict the residual to the selected cells. The first
+        /// material_balance_eq.size() jacobian blocks are taken to be
+        /// the cell variables, the rest the well variables.
+        LinearisedBlackoilResidual restrict(const LinearisedBlackoilResidual& residual) const;
+
+        /// Expand an increment of the restricted system to the full
+        /// system, with zero increments outside the region.
+        /// \param[in] dx              increment of the restricted system
+        /// \param[in] num_cell_vars   number of cell variables
+        V expand(const V& dx, const int num_cell_vars) const;
+
+    private:
+        ADB restrictEquation(const ADB& eq, const int num_cell_vars, const bool restrict_rows) const;
+
+        int num_cells_;
+        // Neighbours of each cell, in compressed row format.
+        std::vector<int> neighbour_start_;
+        std::vector<int> neighbours_;
+        std::vector<int> cells_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_LOCALNEWTONREGION_HEADER_INCLUDED
@@ -0,0 +1,163 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_MIXEDPRECISIONPRECONDITIONER_HEADER_INCLUDED
+#define OPM_MIXEDPRECISIONPRECONDITIONER_HEADER_INCLUDED
+
+#include <opm/common/utility/platform_dependent/disable_warnings.h>
+#include <dune/common/version.hh>
+#include <dune/istl/preconditioner.hh>
+#include <dune/istl/solvercategory.hh>
+#include <opm/common/utility/platform_dependent/reenable_warnings.h>
+
+#include <cassert>
+
+namespace Opm
+{
+
+    namespace detail
+    {
+        /// Copy a block vector into a block vector with another field type.
+        template <class From, class To>
+        void convertBlockVector(const From& from, To& to)
+        {
+            assert(from.size() == to.size());
+            const int n = from.size();
+            for (int i = 0; i < n; ++i) {
+                const int bs = from[i].size();
+                for (int k = 0; k < bs; ++k) {
+                    to[i][k] = static_cast<typename To::field_type>(from[i][k]);
+                }
+            }
+        }
+
+        /// Copy the entries of a block matrix into a block matrix with
+        /// another field type and the same sparsity structure.
+        template <class From, class To>
+        void convertBlockMatrixValues(const From& from, To& to)
+        {
+            assert(from.N() == to.N() && from.nonzeroes() == to.nonzeroes());
+            auto toRow = to.begin();
+            for (auto row = from.begin(); row != from.end(); ++row, ++toRow) {
+                auto toCol = toRow->begin();
+                for (auto col = row->begin(); col != row->end(); ++col, ++toCol) {
+                    assert(col.index() == toCol.index());
+                    const int rows = col->N();
+                    const int cols = col->M();
+                    for (int i = 0; i < rows; ++i) {
+                        for (int j = 0; j < cols; ++j) {
+                            (*toCol)[i][j] = static_cast<typename To::field_type>((*col)[i][j]);
+                        }
+                    }
+                }
+            }
+        }
+
+        /// Build the sparsity structure of to as a copy of that of from.
+        template <class From, class To>
+        void copyBlockMatrixStructure(const From& from, To& to)
+        {
+            to.setSize(from.N(), from.M(), from.nonzeroes());
+            to.setBuildMode(To::row_wise);
+            auto row = from.begin();
+            for (auto create = to.createbegin(); create != to.createend(); ++create, ++row) {
+                for (auto col = row->begin(); col != row->end(); ++col) {
+                    create.insert(col.index());
+                }
+            }
+        }
+    } // namespace detail
+
+
+
+    /// Applies a preconditioner set up in a lower precision (e.g. float) to
+    /// vectors of a higher precision (e.g. double).
+    ///
+    /// The defect is rounded to the lower precision, the preconditioner is
+    /// applied, and the correction is converted back. The outer Krylov
+    /// solver keeps working with the higher precision vectors and matrix,
+    /// so the accuracy of the solution is unchanged; only the quality of
+    /// the preconditioner is affected by the rounding.
+    ///
+    /// The pre() and post() steps of the wrapped preconditioner are called
+    /// with temporaries, so it must not use them to modify the iterate or
+    /// right hand side. This holds for ILU and for AMG with ILU smoothers.
+    template <class X, class Y, class LowX, class LowY = LowX>
+    class MixedPrecisionPreconditioner : public Dune::Preconditioner<X, Y>
+    {
+    public:
+        typedef X domain_type;
+        typedef Y range_type;
+        typedef typename X::field_type field_type;
+        typedef Dune::Preconditioner<LowX, LowY> LowPreconditioner;
+
+        /// \param precond  preconditioner in the lower precision, must outlive this object
+        explicit MixedPrecisionPreconditioner(LowPreconditioner& precond)
+            : precond_(precond)
+        {
+        }
+
+#if DUNE_VERSION_NEWER(DUNE_ISTL, 2, 6)
+        Dune::SolverCategory::Category category() const override
+        {
+            return Dune::SolverCategory::sequential;
+        }
+#else
+        enum {
+            //! \brief The category the preconditioner is part of.
+            category = Dune::SolverCategory::sequential
+        };
+#endif
+
+        virtual void pre(X& x, Y& b)
+        {
+            LowX lx(x.size());
+            LowY lb(b.size());
+            detail::convertBlockVector(x, lx);
+            detail::convertBlockVector(b, lb);
+            precond_.pre(lx, lb);
+        }
+
+        virtual void apply(X& v, const Y& d)
+        {
+            if (lowv_.size() != v.size()) {
+                lowv_.resize(v.size());
+                lowd_.resize(d.size());
+            }
+            detail::convertBlockVector(d, lowd_);
+            lowv_ = 0.0;
+            precond_.apply(lowv_, lowd_);
+            detail::convertBlockVector(lowv_, v);
+        }
+
+        virtual void post(X& x)
+        {
+            LowX lx(x.size());
+            detail::convertBlockVector(x, lx);
+            precond_.post(lx);
+        }
+
+    private:
+        LowPreconditioner& precond_;
+        // Work vectors in the lower precision.
+        LowX lowv_;
+        LowY lowd_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_MIXEDPRECISIONPRECONDITIONER_HEADER_INCLUDED
@@ -26,6 +26,7 @@
 
 #include <opm/autodiff/NewtonIterationBlackoilCPR.hpp>
 #include <opm/autodiff/NewtonIterationUtilities.hpp>
+#include <opm/autodiff/TimingRegistry.hpp>
 #include <opm/autodiff/AutoDiffHelpers.hpp>
 #include <opm/parser/eclipse/Units/Units.hpp>
 #include <opm/common/Exceptions.hpp>
@@ -56,6 +57,7 @@ namespace Opm
     NewtonIterationBlackoilCPR::NewtonIterationBlackoilCPR(const ParameterGroup& param,
                                                            const boost::any& parallelInformation_arg)
       : cpr_param_( param ),
+        cpr_reuse_( param ),
         iterations_( 0 ),
         parallelInformation_(parallelInformation_arg),
         newton_use_gmres_( param.getDefault("newton_use_gmres", false ) ),
@@ -79,6 +81,7 @@ namespace Opm
     NewtonIterationBlackoilCPR::SolutionVector
     NewtonIterationBlackoilCPR::computeNewtonIncrement(const LinearisedBlackoilResidual& residual) const
     {
+        ScopedTiming timing("computeNewtonIncrement");
         // Build the vector of equations.
         const int np = residual.material_balance_eq.size();
         std::vector<ADB> eqs;
@@ -124,23 +127,23 @@ namespace Opm
         // Solve reduced system.
         SolutionVector dx(SolutionVector::Zero(b.size()));
 
-        // Create ISTL matrix.
-        DuneMatrix istlA( A );
-
-        // Create ISTL matrix for elliptic part.
-        DuneMatrix istlAe( A.topLeftCorner(nc, nc) );
-
         // Right hand side.
-        Vector istlb(istlA.N());
+        Vector istlb(A.rows());
         std::copy_n(b.data(), istlb.size(), istlb.begin());
         // System solution
-        Vector x(istlA.M());
+        Vector x(A.cols());
         x = 0.0;
 
         Dune::InverseOperatorResult result;
 #if HAVE_MPI
         if(parallelInformation_.type()==typeid(ParallelISTLInformation))
         {
+            // Create ISTL matrix.
+            DuneMatrix istlA( A );
+
+            // Create ISTL matrix for elliptic part.
+            DuneMatrix istlAe( A.topLeftCorner(nc, nc) );
+
             typedef Dune::OwnerOverlapCopyCommunication<int,int> Comm;
             const ParallelISTLInformation& info =
                 boost::any_cast<const ParallelISTLInformation&>( parallelInformation_);
@@ -157,11 +160,8 @@ namespace Opm
         else
 #endif
         {
-            // Construct operator, scalar product and vectors needed.
-            typedef Dune::MatrixAdapter<Mat,Vector,Vector> Operator;
-            Operator opA(istlA);
-            Dune::Amg::SequentialInformation info;
-            constructPreconditionerAndSolve(opA, istlAe, x, istlb, info, info, result);
+            const Eigen::SparseMatrix<double, Eigen::RowMajor> Ae = A.topLeftCorner(nc, nc);
+            solveSequential(A, Ae, x, istlb, result);
         }
 
         // store number of iterations
@@ -188,6 +188,65 @@ namespace Opm
 
 
 
+    void NewtonIterationBlackoilCPR::solveSequential(const Eigen::SparseMatrix<double, Eigen::RowMajor>& A,
+                                                     const Eigen::SparseMatrix<double, Eigen::RowMajor>& Ae,
+                                                     Vector& x, Vector& istlb,
+                                                     Dune::InverseOperatorResult& result) const
+    {
+        // Keep the ISTL matrices if the structure is unchanged, since the
+        // preconditioner refers to them. The AMG inside CPRPreconditioner
+        // is not accessible, so ReuseAggregation reuses the complete
+        // preconditioner like ReuseAll.
+        const bool structureChanged = !istlA_
+            || !istlA_->updateValuesIfSameStructure(A)
+            || !istlAe_->updateValuesIfSameStructure(Ae);
+        if (structureChanged) {
+            seqPrecond_.reset();
+            istlA_.reset(new DuneMatrix(A));
+            istlAe_.reset(new DuneMatrix(Ae));
+        }
+
+        typedef Dune::MatrixAdapter<Mat,Vector,Vector> Operator;
+        Operator opA(*istlA_);
+        const Vector b = istlb;
+        bool reused = false;
+        if (cpr_reuse_.needsSetup(structureChanged) || !seqPrecond_) {
+            // Release the old hierarchy before building the new one.
+            seqPrecond_.reset();
+            seqPrecond_.reset(new SeqPreconditioner(cpr_param_, *istlA_, *istlAe_, seqInfo_, seqInfo_));
+            cpr_reuse_.setupDone();
+        }
+        else {
+            reused = true;
+        }
+
+        solve(opA, *seqPrecond_, x, istlb, seqInfo_, result);
+        cpr_reuse_.solveDone(result.iterations, result.converged);
+
+        if (reused && !result.converged) {
+            // A reused preconditioner must not cause a failure: retry with a fresh one.
+            const int iterationsReused = result.iterations;
+            seqPrecond_.reset();
+            seqPrecond_.reset(new SeqPreconditioner(cpr_param_, *istlA_, *istlAe_, seqInfo_, seqInfo_));
+            cpr_reuse_.setupDone();
+            x = 0.0;
+            istlb = b;
+            solve(opA, *seqPrecond_, x, istlb, seqInfo_, result);
+            cpr_reuse_.solveDone(result.iterations, result.converged);
+            result.iterations += iterationsReused;
+        }
+        else if (cpr_reuse_.mode() == PreconditionerReusePolicy::Rebuild) {
+            // Do not keep the hierarchy and matrices in memory if they will not be reused.
+            seqPrecond_.reset();
+            istlAe_.reset();
+            istlA_.reset();
+        }
+    }
+
+
+
+
+
     const boost::any& NewtonIterationBlackoilCPR::parallelInformation() const
     {
         return parallelInformation_;
@@ -27,6 +27,7 @@
 #include <opm/autodiff/DuneMatrix.hpp>
 #include <opm/autodiff/NewtonIterationBlackoilInterface.hpp>
 #include <opm/autodiff/CPRPreconditioner.hpp>
+#include <opm/autodiff/PreconditionerReusePolicy.hpp>
 #include <opm/common/utility/parameters/ParameterGroup.hpp>
 #include <opm/core/linalg/LinearSolverInterface.hpp>
 #include <dune/istl/scalarproducts.hh>
@@ -61,6 +62,8 @@ namespace Opm
         ///                        cpr_ilu_n        (default 0) use ILU(n) for preconditioning of the linear system
         ///                        cpr_use_amg      (default false) if true, use AMG preconditioner for elliptic part
         ///                        cpr_use_bicgstab (default true)  if true, use BiCGStab (else use CG) for elliptic part
+        ///                        cpr_reuse_setup  (default 0) if 1 or 2, reuse the preconditioner for later
+        ///                                         sequential solves, see PreconditionerReusePolicy
         /// \param[in] parallelInformation In the case of a parallel run
         ///                               with dune-istl the information about the parallelization.
         NewtonIterationBlackoilCPR(const ParameterGroup& param,
@@ -96,20 +99,33 @@ namespace Opm
                                              const P& parallelInformationAe,
                                              Dune::InverseOperatorResult& result) const
         {
-#if DUNE_VERSION_NEWER(DUNE_ISTL, 2, 6)
-            auto sp = Dune::createScalarProduct<Vector,P>(parallelInformation_arg, category);
-#else
-            typedef Dune::ScalarProductChooser<Vector,P,category> ScalarProductChooser;
-            std::unique_ptr<typename ScalarProductChooser::ScalarProduct>
-                sp(ScalarProductChooser::construct(parallelInformation_arg));
-#endif
             // Construct preconditioner.
             // typedef Dune::SeqILU0<Mat,Vector,Vector> Preconditioner;
            typedef Opm::CPRPreconditioner<Mat,Vector,Vector,P> Preconditioner;
             parallelInformation_arg.copyOwnerToAll(istlb, istlb);
             Preconditioner precond(cpr_param_, opA.getmat(), istlAe, parallelInformation_arg,
                                    parallelInformationAe);
+            solve<category>(opA, precond, x, istlb, parallelInformation_arg, result);
+        }
 
+        /// \brief solve with the given preconditioner.
+#if DUNE_VERSION_NEWER(DUNE_ISTL, 2, 6)
+        template<Dune::SolverCategory::Category category=Dune::SolverCategory::sequential,
+                 class O, class Precond, class P>
+#else
+        template<int category=Dune::SolverCategory::sequential, class O, class Precond, class P>
+#endif
+        void solve(O& opA, Precond& precond, Vector& x, Vector& istlb,
+                   const P& parallelInformation_arg,
+                   Dune::InverseOperatorResult& result) const
+        {
+#if DUNE_VERSION_NEWER(DUNE_ISTL, 2, 6)
+            auto sp = Dune::createScalarProduct<Vector,P>(parallelInformation_arg, category);
+#else
+            typedef Dune::ScalarProductChooser<Vector,P,category> ScalarProductChooser;
+            std::unique_ptr<typename ScalarProductChooser::ScalarProduct>
+                sp(ScalarProductChooser::construct(parallelInformation_arg));
+#endif
             // TODO: Revise when linear solvers interface opm-core is done
             // Construct linear solver.
             // GMRes solver
@@ -127,7 +143,23 @@ namespace Opm
             }
         }
 
+        /// \brief solve the sequential system, reusing the matrices and the
+        /// CPR preconditioner of earlier calls as allowed by cpr_reuse_.
+        void solveSequential(const Eigen::SparseMatrix<double, Eigen::RowMajor>& A,
+                             const Eigen::SparseMatrix<double, Eigen::RowMajor>& Ae,
+                             Vector& x, Vector& istlb,
+                             Dune::InverseOperatorResult& result) const;
+
         CPRParameter cpr_param_;
+        mutable PreconditionerReusePolicy cpr_reuse_;
+
+        // State kept between sequential solves for reusing the preconditioner.
+        // The preconditioner refers to the matrices and the parallel information.
+        typedef Opm::CPRPreconditioner<Mat,Vector,Vector,Dune::Amg::SequentialInformation> SeqPreconditioner;
+        mutable std::unique_ptr<DuneMatrix> istlA_;
+        mutable std::unique_ptr<DuneMatrix> istlAe_;
+        mutable Dune::Amg::SequentialInformation seqInfo_;
+        mutable std::unique_ptr<SeqPreconditioner> seqPrecond_;
 
         mutable int iterations_;
         boost::any parallelInformation_;
@@ -29,8 +29,11 @@
 #include <opm/autodiff/CPRPreconditioner.hpp>
 #include <opm/autodiff/NewtonIterationBlackoilInterleaved.hpp>
 #include <opm/autodiff/NewtonIterationUtilities.hpp>
+#include <opm/autodiff/MixedPrecisionPreconditioner.hpp>
+#include <opm/autodiff/PreconditionerReusePolicy.hpp>
 #include <opm/autodiff/ParallelRestrictedAdditiveSchwarz.hpp>
 #include <opm/autodiff/ParallelOverlappingILU0.hpp>
+#include <opm/autodiff/TimingRegistry.hpp>
 #include <opm/autodiff/AutoDiffHelpers.hpp>
 #include <opm/autodiff/DuneMatrix.hpp>
 #include <opm/common/Exceptions.hpp>
@@ -47,6 +50,13 @@
 #endif
 #include <opm/common/utility/platform_dependent/reenable_warnings.h>
 
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
+
 namespace Opm
 {
 
@@ -81,16 +91,37 @@ namespace Opm
 
         typedef Opm::ISTLSolver< MatrixBlockType, VectorBlockType > ISTLSolverType;
 
+        // Types of the single precision copy of the system used by the
+        // mixed precision preconditioner.
+        typedef Dune::FieldVector<float, np >           LowVectorBlockType;
+        typedef Dune::MatrixBlock<float, np, np >       LowMatrixBlockType;
+        typedef Dune::BCRSMatrix <LowMatrixBlockType>   LowMat;
+        typedef Dune::BlockVector<LowVectorBlockType>   LowVector;
+        typedef Dune::Preconditioner<LowVector, LowVector> LowPreconditioner;
+#if FLOW_SUPPORT_AMG
+        typedef ISTLUtility::CPRSelector< LowMat, LowVector, LowVector, Dune::Amg::SequentialInformation > LowCPRSelector;
+        typedef typename LowCPRSelector::Operator LowOperator;
+        typedef typename LowCPRSelector::AMG LowAMG;
+#endif
+
     public:
         typedef NewtonIterationBlackoilInterface :: SolutionVector  SolutionVector;
         /// Construct a system solver.
         /// \param[in] param   parameters controlling the behaviour of the linear solvers
         /// \param[in] parallelInformation In the case of a parallel run
          ///                               with dune-istl the information about the parallelization.
+        /// \param[in] mixedPrecision  if true, the preconditioner is set up and applied in
+        ///                            single precision while the Krylov solver uses Scalar
+        /// \param[in] reuse           when to recompute the single precision preconditioner
         NewtonIterationBlackoilInterleavedImpl(const NewtonIterationBlackoilInterleavedParameters& param,
-                                               const boost::any& parallelInformation_arg=boost::any())
+                                               const boost::any& parallelInformation_arg=boost::any(),
+                                               const bool mixedPrecision = false,
+                                               const PreconditionerReusePolicy& reuse = PreconditionerReusePolicy())
         : istlSolver_( param, parallelInformation_arg ),
-          parameters_( param )
+          parameters_( param ),
+          mixedPrecision_( mixedPrecision && ! std::is_same< Scalar, float >::value ),
+          iterations_( 0 ),
+          lowReuse_( reuse )
         {
         }
 
@@ -101,16 +132,31 @@ namespace Opm
         /// \return               the solution x
 
         /// \copydoc NewtonIterationBlackoilInterface::iterations
-        int iterations () const { return istlSolver_.iterations(); }
+        int iterations () const { return iterations_; }
 
         /// \copydoc NewtonIterationBlackoilInterface::parallelInformation
         const boost::any& parallelInformation() const { return istlSolver_.parallelInformation(); }
 
     public:
-        void formInterleavedSystem(const std::vector<LinearisedBlackoilResidual::ADB>& eqs,
+        /// \return true if the block structure of istlA has been (re)built
+        bool formInterleavedSystem(const std::vector<LinearisedBlackoilResidual::ADB>& eqs,
                                    Mat& istlA) const
         {
             assert( np == int(eqs.size()) );
+            const int size = eqs[0].size();
+
+            // The block structure only changes with the well topology, so
+            // first try to scatter the jacobians into the matrix of the last
+            // call. The scatter detects both entries the matrix lacks and
+            // blocks no jacobian entry falls in any more, e.g. after a well
+            // was shut, in which case the structure is built anew.
+            if (int(istlA.N()) == size && int(istlA.M()) == size) {
+                istlA = 0.0;
+                if (scatterJacobians(eqs, istlA, true)) {
+                    return false;
+                }
+            }
+
             // Find sparsity structure as union of basic block sparsity structures,
             // corresponding to the jacobians with respect to pressure.
             // Use our custom PointOneOp to get to the union structure.
@@ -136,45 +182,63 @@ namespace Opm
             // Automatically convert the column major structure to a row-major structure
             Eigen::SparseMatrix<double, Eigen::RowMajor> row_major = col_major;
 
-            const int size = row_major.rows();
+            assert(size == row_major.rows());
             assert(size == row_major.cols());
 
-            {
-                // Create ISTL matrix with interleaved rows and columns (block structured).
-                istlA.setSize(row_major.rows(), row_major.cols(), row_major.nonZeros());
-                istlA.setBuildMode(Mat::row_wise);
-                const int* ia = row_major.outerIndexPtr();
-                const int* ja = row_major.innerIndexPtr();
-                const typename Mat::CreateIterator endrow = istlA.createend();
-                for (typename Mat::CreateIterator row = istlA.createbegin(); row != endrow; ++row) {
-                    const int ri = row.index();
-                    for (int i = ia[ri]; i < ia[ri + 1]; ++i) {
-                        row.insert(ja[i]);
-                    }
+            // Create ISTL matrix with interleaved rows and columns (block structured).
+            // Note that MatrixBlock zeros all elements during construction.
+            istlA.setSize(row_major.rows(), row_major.cols(), row_major.nonZeros());
+            istlA.setBuildMode(Mat::row_wise);
+            const int* ia = row_major.outerIndexPtr();
+            const int* ja = row_major.innerIndexPtr();
+            const typename Mat::CreateIterator endrow = istlA.createend();
+            for (typename Mat::CreateIterator row = istlA.createbegin(); row != endrow; ++row) {
+                const int ri = row.index();
+                for (int i = ia[ri]; i < ia[ri + 1]; ++i) {
+                    row.insert(ja[i]);
                 }
             }
 
-            /*
-            // not neeeded since MatrixBlock initially zeros all elements during construction
-            // Set all blocks to zero.
-            for (auto row = istlA.begin(), rowend = istlA.end(); row != rowend; ++row ) {
-                for (auto col = row->begin(), colend = row->end(); col != colend; ++col ) {
-                    *col = 0.0;
+            scatterJacobians(eqs, istlA, false);
+            return true;
+        }
+
+        /// Add the jacobians of eqs to the blocks of istlA.
+        ///
+        /// Go through all jacobians, and insert in correct spot
+        ///
+        /// The straight forward way to do this would be to run through each
+        /// element in the output matrix, and set all block entries by gathering
+        /// from all "input matrices" (derivatives).
+        ///
+        /// A faster alternative is to instead run through each "input matrix" and
+        /// insert its elements in the correct spot in the output matrix.
+        ///
+        /// \param[in] check   if true, stop and return false at the first
+        ///                    entry that is not in the structure of istlA,
+        ///                    and return false if some block of istlA
+        ///                    received no entry
+        /// \return            false if the structure of istlA does not
+        ///                    match the union of the jacobians
+        bool scatterJacobians(const std::vector<LinearisedBlackoilResidual::ADB>& eqs,
+                              Mat& istlA,
+                              const bool check) const
+        {
+            const int size = eqs[0].size();
+
+            // When checking, mark the blocks that receive an entry. Block
+            // k of row r has position rowStart[r] + k.
+            std::vector<int> rowStart;
+            std::vector<char> used;
+            int numUsed = 0;
+            if (check) {
+                rowStart.assign(size + 1, 0);
+                for (int row = 0; row < size; ++row) {
+                    rowStart[row + 1] = rowStart[row] + istlA[row].size();
                 }
+                used.assign(rowStart[size], 0);
             }
-            */
-
-            /**
-             * Go through all jacobians, and insert in correct spot
-             *
-             * The straight forward way to do this would be to run through each
-             * element in the output matrix, and set all block entries by gathering
-             * from all "input matrices" (derivatives).
-             *
-             * A faster alternative is to instead run through each "input matrix" and
-             * insert its elements in the correct spot in the output matrix.
-             *
-             */
+
             for (int p1 = 0; p1 < np; ++p1) {
                 for (int p2 = 0; p2 < np; ++p2) {
                     // Note that that since these are CSC and not CSR matrices,
@@ -186,11 +250,26 @@ namespace Opm
                     for (int col = 0; col < size; ++col) {
                         for (int elem_ix = ia[col]; elem_ix < ia[col + 1]; ++elem_ix) {
                             const int row = ja[elem_ix];
-                            istlA[row][col][p1][p2] = sa[elem_ix];
+                            if (check) {
+                                auto& istlRow = istlA[row];
+                                const auto entry = istlRow.find(col);
+                                if (entry == istlRow.end()) {
+                                    return false;
+                                }
+                                const int block = rowStart[row] + std::distance(istlRow.begin(), entry);
+                                if (!used[block]) {
+                                    used[block] = 1;
+                                    ++numUsed;
+                                }
+                                (*entry)[p1][p2] = sa[elem_ix];
+                            } else {
+                                istlA[row][col][p1][p2] = sa[elem_ix];
+                            }
                         }
                     }
                 }
             }
+            return !check || numUsed == rowStart[size];
         }
 
 
@@ -253,8 +332,10 @@ namespace Opm
             assert(pos == size_b);
 
             // Create ISTL matrix with interleaved rows and columns (block structured).
-            Mat istlA;
-            formInterleavedSystem(eqs, istlA);
+            // The matrix is kept between calls so that its allocation and
+            // block structure can be reused by subsequent Newton iterations.
+            Mat& istlA = istlA_;
+            const bool structureRebuilt = formInterleavedSystem(eqs, istlA);
 
             // Solve reduced system.
             SolutionVector dx(SolutionVector::Zero(b.size()));
@@ -273,7 +354,17 @@ namespace Opm
             x = 0.0;
 
             // solve linear system using ISTL methods
-            istlSolver_.solve( istlA, x, istlb );
+            bool parallel = false;
+#if HAVE_MPI
+            parallel = istlSolver_.parallelInformation().type() == typeid(ParallelISTLInformation);
+#endif
+            if ( mixedPrecision_ && ! parallel ) {
+                solveMixedPrecision( istlA, structureRebuilt, x, istlb );
+            }
+            else {
+                istlSolver_.solve( istlA, x, istlb );
+                iterations_ = istlSolver_.iterations();
+            }
 
             // Copy solver output to dx.
             for (int i = 0; i < size; ++i) {
@@ -292,23 +383,165 @@ namespace Opm
         }
 
     protected:
+        /// Solve the sequential system with a Krylov solver working on istlA
+        /// and a preconditioner set up on a single precision copy of istlA.
+        /// This halves the memory traffic of the preconditioner application.
+        /// The copy and the preconditioner are kept between calls and the
+        /// preconditioner is recomputed as decided by lowReuse_.
+        void solveMixedPrecision(const Mat& istlA, const bool structureRebuilt,
+                                 Vector& x, Vector& istlb) const
+        {
+            // Single precision copy of the system matrix. The preconditioner
+            // refers to it, so it goes first if the structure is rebuilt.
+            const bool structureChanged = structureRebuilt
+                || istlALow_.N() != istlA.N() || istlALow_.nonzeroes() != istlA.nonzeroes();
+            if (structureChanged) {
+                releaseLowPreconditioner();
+                detail::copyBlockMatrixStructure(istlA, istlALow_);
+            }
+            detail::convertBlockMatrixValues(istlA, istlALow_);
+
+            // The ILU0 has no aggregation to keep, so ReuseAggregation
+            // reuses it like ReuseAll.
+            bool reused = false;
+            if (lowReuse_.needsSetup(structureChanged) || !hasLowPreconditioner()) {
+                setupLowPreconditioner();
+            }
+            else {
+                reused = true;
+#if FLOW_SUPPORT_AMG && DUNE_VERSION_NEWER(DUNE_ISTL, 2, 6)
+                if (lowAmg_ && lowReuse_.mode() == PreconditionerReusePolicy::ReuseAggregation) {
+                    // Keep the aggregates, recompute the coarse level matrices.
+                    lowAmg_->recalculateHierarchy();
+                }
+#endif
+            }
+
+            const Vector b = istlb;
+            Dune::InverseOperatorResult result;
+            applyMixedPrecisionSolver(istlA, x, istlb, result);
+            lowReuse_.solveDone(result.iterations, result.converged);
+
+            if (reused && !result.converged) {
+                // A reused preconditioner must not cause a failure: retry with a fresh one.
+                const int iterationsReused = result.iterations;
+                setupLowPreconditioner();
+                x = 0.0;
+                istlb = b;
+                applyMixedPrecisionSolver(istlA, x, istlb, result);
+                lowReuse_.solveDone(result.iterations, result.converged);
+                result.iterations += iterationsReused;
+            }
+            else if (lowReuse_.mode() == PreconditionerReusePolicy::Rebuild) {
+                // Do not keep the preconditioner in memory if it will not be reused.
+                releaseLowPreconditioner();
+            }
+
+            iterations_ = result.iterations;
+            if ( ! parameters_.ignoreConvergenceFailure_ && ! result.converged ) {
+                const std::string msg("Convergence failure for linear solver.");
+                OPM_THROW_NOLOG(LinearSolverProblem, msg);
+            }
+        }
+
+        /// Set up the single precision preconditioner on istlALow_ with
+        /// the same AMG and ILU settings as ISTLSolver.
+        void setupLowPreconditioner() const
+        {
+            // Release the old preconditioner before building the new one.
+            releaseLowPreconditioner();
+            const double relax = parameters_.ilu_relaxation_;
+            const MILU_VARIANT ilu_milu = parameters_.ilu_milu_;
+#if FLOW_SUPPORT_AMG
+            if ( parameters_.linear_solver_use_amg_ ) {
+                Dune::Amg::SequentialInformation info;
+                lowOp_.reset( LowCPRSelector::makeOperator( istlALow_, info ) );
+                ISTLUtility::template createAMGPreconditionerPointer<0>( *lowOp_, relax, ilu_milu, info, lowAmg_ );
+            }
+            else
+#endif
+            {
+                typedef ParallelOverlappingILU0< LowMat, LowVector, LowVector > LowILU;
+                lowILU_.reset( new LowILU( istlALow_, parameters_.ilu_fillin_level_, relax, ilu_milu,
+                                           parameters_.ilu_redblack_, parameters_.ilu_reorder_sphere_ ) );
+            }
+            lowReuse_.setupDone();
+        }
+
+        void releaseLowPreconditioner() const
+        {
+#if FLOW_SUPPORT_AMG
+            // The AMG refers to the operator.
+            lowAmg_.reset();
+            lowOp_.reset();
+#endif
+            lowILU_.reset();
+        }
+
+        bool hasLowPreconditioner() const
+        {
+#if FLOW_SUPPORT_AMG
+            if ( lowAmg_ ) {
+                return true;
+            }
+#endif
+            return bool( lowILU_ );
+        }
+
+        void applyMixedPrecisionSolver(const Mat& istlA, Vector& x, Vector& istlb,
+                                       Dune::InverseOperatorResult& result) const
+        {
+#if FLOW_SUPPORT_AMG
+            LowPreconditioner& low = lowAmg_ ? static_cast< LowPreconditioner& >( *lowAmg_ ) : *lowILU_;
+#else
+            LowPreconditioner& low = *lowILU_;
+#endif
+            MixedPrecisionPreconditioner< Vector, Vector, LowVector > precond( low );
+
+            typedef Dune::MatrixAdapter< Mat, Vector, Vector > Operator;
+            Operator opA( istlA );
+            Dune::SeqScalarProduct< Vector > sp;
+            // The preconditioner is a fixed linear operator, so the standard
+            // (right preconditioned) restarted GMRes and BiCGStab apply.
+            if ( parameters_.newton_use_gmres_ ) {
+                Dune::RestartedGMResSolver< Vector > linsolve( opA, sp, precond,
+                          parameters_.linear_solver_reduction_,
+                          parameters_.linear_solver_restart_,
+                          parameters_.linear_solver_maxiter_,
+                          parameters_.linear_solver_verbosity_ );
+                linsolve.apply( x, istlb, result );
+            }
+            else {
+                Dune::BiCGSTABSolver< Vector > linsolve( opA, sp, precond,
+                          parameters_.linear_solver_reduction_,
+                          parameters_.linear_solver_maxiter_,
+                          parameters_.linear_solver_verbosity_ );
+                linsolve.apply( x, istlb, result );
+            }
+        }
+
         ISTLSolverType istlSolver_;
         NewtonIterationBlackoilInterleavedParameters parameters_;
+        const bool mixedPrecision_;
+        mutable int iterations_;
+
+        // System matrix of the previous call of computeNewtonIncrement(),
+        // whose block structure is reused.
+        mutable Mat istlA_;
+        // Single precision copy of istlA_ for the mixed precision preconditioner.
+        mutable LowMat istlALow_;
+        // Single precision preconditioner set up on istlALow_, kept between
+        // calls as allowed by lowReuse_.
+        mutable PreconditionerReusePolicy lowReuse_;
+#if FLOW_SUPPORT_AMG
+        mutable std::unique_ptr< LowOperator > lowOp_;
+        mutable std::unique_ptr< LowAMG > lowAmg_;
+#endif
+        mutable std::unique_ptr< LowPreconditioner > lowILU_;
     }; // end NewtonIterationBlackoilInterleavedImpl
 
 
 
-    /// Construct a system solver.
-    NewtonIterationBlackoilInterleaved::NewtonIterationBlackoilInterleaved(const ParameterGroup& param,
-                                                                           const boost::any& parallelInformation_arg)
-      : newtonIncrementDoublePrecision_(),
-        newtonIncrementSinglePrecision_(),
-        parameters_( param ),
-        parallelInformation_(parallelInformation_arg),
-        iterations_( 0 )
-    {
-    }
-
     namespace detail {
 
         template< int NP, class Scalar >
@@ -319,6 +552,8 @@ namespace Opm
             get( NewtonIncVector& newtonIncrements,
                  const NewtonIterationBlackoilInterleavedParameters& param,
                  const boost::any& parallelInformation,
+                 const bool mixedPrecision,
+                 const PreconditionerReusePolicy& mixedPrecisionReuse,
                  const int np )
             {
                 if( np == NP )
@@ -326,12 +561,12 @@ namespace Opm
                     assert( np < int(newtonIncrements.size()) );
                     // create NewtonIncrement with fixed np
                     if( ! newtonIncrements[ NP ] )
-                        newtonIncrements[ NP ].reset( new NewtonIterationBlackoilInterleavedImpl< NP, Scalar >( param, parallelInformation ) );
+                        newtonIncrements[ NP ].reset( new NewtonIterationBlackoilInterleavedImpl< NP, Scalar >( param, parallelInformation, mixedPrecision, mixedPrecisionReuse ) );
                     return *(newtonIncrements[ NP ]);
                 }
                 else
                 {
-                    return NewtonIncrement< NP-1, Scalar >::get(newtonIncrements, param, parallelInformation, np );
+                    return NewtonIncrement< NP-1, Scalar >::get(newtonIncrements, param, parallelInformation, mixedPrecision, mixedPrecisionReuse, np );
                 }
             }
         };
@@ -344,6 +579,8 @@ namespace Opm
             get( NewtonIncVector&,
                  const NewtonIterationBlackoilInterleavedParameters&,
                  const boost::any&,
+                 const bool,
+                 const PreconditionerReusePolicy&,
                  const int np )
             {
                 OPM_THROW(std::runtime_error,"NewtonIncrement::get: number of variables not supported yet. Adjust maxNumberEquations appropriately to cover np = " << np);
@@ -354,8 +591,64 @@ namespace Opm
 
 
 
+        /// State kept between calls of computePressureIncrement() for
+        /// reusing the AMG hierarchy. The AMG refers to the operator,
+        /// which refers to the matrix.
+        struct PressureSolverCache
+        {
+            typedef Dune::BlockVector<Dune::FieldVector<double, 1> > Vector1;
+            typedef Dune::BCRSMatrix<Dune::FieldMatrix<double, 1, 1> > Mat;
+            typedef Dune::MatrixAdapter<Mat, Vector1, Vector1> Operator;
+            typedef Dune::Amg::SequentialInformation ParallelInformation;
+            typedef Dune::SeqILU0<Mat,Vector1,Vector1> EllipticPreconditioner;
+            typedef EllipticPreconditioner Smoother;
+            typedef Dune::Amg::AMG<Operator, Vector1, Smoother, ParallelInformation> AMG;
+
+            explicit PressureSolverCache(const ParameterGroup& param)
+                : reuse(param)
+            {
+            }
+
+            void buildAMG()
+            {
+                typedef Dune::Amg::FirstDiagonal CouplingMetric;
+                typedef Dune::Amg::SymmetricCriterion<Mat, CouplingMetric> CritBase;
+                typedef Dune::Amg::CoarsenCriterion<CritBase> Criterion;
+
+                // TODO: revise choice of parameters
+                const int coarsenTarget = 1200;
+                Criterion criterion(15, coarsenTarget);
+                criterion.setDebugLevel(0); // no debug information, 1 for printing hierarchy information
+                criterion.setDefaultValuesIsotropic(2);
+                criterion.setNoPostSmoothSteps(1);
+                criterion.setNoPreSmoothSteps(1);
+
+                // for DUNE 2.2 we also need to pass the smoother args
+                typedef typename AMG::Smoother Smoother;
+                typedef typename Dune::Amg::SmootherTraits<Smoother>::Arguments  SmootherArgs;
+                SmootherArgs  smootherArgs;
+                smootherArgs.iterations = 1;
+                smootherArgs.relaxationFactor = 1.0;
+
+                // Release the old hierarchy before building the new one.
+                amg.reset();
+                amg.reset(new AMG(*op, criterion, smootherArgs));
+                reuse.setupDone();
+            }
+
+            PreconditionerReusePolicy reuse;
+            std::unique_ptr<DuneMatrix> matrix;
+            std::unique_ptr<Operator> op;
+            std::unique_ptr<AMG> amg;
+        };
+
+
+
+
+
         std::pair<NewtonIterationBlackoilInterleaved::SolutionVector, Dune::InverseOperatorResult>
-        computePressureIncrement(const LinearisedBlackoilResidual& residual)
+        computePressureIncrement(const LinearisedBlackoilResidual& residual,
+                                 PressureSolverCache& cache)
         {
             typedef LinearisedBlackoilResidual::ADB ADB;
 
@@ -384,11 +677,19 @@ namespace Opm
                 assert(int(eqs.size()) == np);
             }
 
-            // Solve the linearised oil equation.
+            // Solve the linearised oil equation. The matrix is only
+            // reallocated if its structure has changed.
             Eigen::SparseMatrix<double, Eigen::RowMajor> eigenA = eqs[0].derivative()[0].getSparse();
-            DuneMatrix opA(eigenA);
+            const bool structureChanged = !cache.matrix || !cache.matrix->updateValuesIfSameStructure(eigenA);
+            if (structureChanged) {
+                cache.amg.reset();
+                cache.op.reset();
+                cache.matrix.reset(new DuneMatrix(eigenA));
+                cache.op.reset(new PressureSolverCache::Operator(*cache.matrix));
+            }
+
             const int size = eqs[0].size();
-            typedef Dune::BlockVector<Dune::FieldVector<double, 1> > Vector1;
+            typedef PressureSolverCache::Vector1 Vector1;
             Vector1 x;
             x.resize(size);
             x = 0.0;
@@ -396,47 +697,52 @@ namespace Opm
             b.resize(size);
             b = 0.0;
             std::copy_n(eqs[0].value().data(), size, b.begin());
+            const Vector1 b0 = b;
 
             // Solve with AMG solver.
-            typedef Dune::BCRSMatrix<Dune::FieldMatrix<double, 1, 1> > Mat;
-            typedef Dune::MatrixAdapter<Mat, Vector1, Vector1> Operator;
-            Operator sOpA(opA);
-
-            typedef Dune::Amg::SequentialInformation ParallelInformation;
-            typedef Dune::SeqILU0<Mat,Vector1,Vector1> EllipticPreconditioner;
-            typedef EllipticPreconditioner Smoother;
-            typedef Dune::Amg::AMG<Operator, Vector1, Smoother, ParallelInformation> AMG;
-            typedef Dune::Amg::FirstDiagonal CouplingMetric;
-            typedef Dune::Amg::SymmetricCriterion<Mat, CouplingMetric> CritBase;
-            typedef Dune::Amg::CoarsenCriterion<CritBase> Criterion;
-
-            // TODO: revise choice of parameters
-            const int coarsenTarget = 1200;
-            Criterion criterion(15, coarsenTarget);
-            criterion.setDebugLevel(0); // no debug information, 1 for printing hierarchy information
-            criterion.setDefaultValuesIsotropic(2);
-            criterion.setNoPostSmoothSteps(1);
-            criterion.setNoPreSmoothSteps(1);
-
-            // for DUNE 2.2 we also need to pass the smoother args
-            typedef typename AMG::Smoother Smoother;
-            typedef typename Dune::Amg::SmootherTraits<Smoother>::Arguments  SmootherArgs;
-            SmootherArgs  smootherArgs;
-            smootherArgs.iterations = 1;
-            smootherArgs.relaxationFactor = 1.0;
-
-            AMG precond(sOpA, criterion, smootherArgs);
+            bool reused = false;
+            if (cache.reuse.needsSetup(structureChanged) || !cache.amg) {
+                cache.buildAMG();
+            }
+            else {
+                reused = true;
+#if DUNE_VERSION_NEWER(DUNE_ISTL, 2, 6)
+                if (cache.reuse.mode() == PreconditionerReusePolicy::ReuseAggregation) {
+                    // Keep the aggregates, recompute the coarse level matrices.
+                    cache.amg->recalculateHierarchy();
+                }
+#endif
+            }
 
             const int verbosity = 0;
             const int maxit = 30;
             const double tolerance = 1e-5;
 
             // Construct linear solver.
-            Dune::BiCGSTABSolver<Vector1> linsolve(sOpA, precond, tolerance, maxit, verbosity);
+            Dune::BiCGSTABSolver<Vector1> linsolve(*cache.op, *cache.amg, tolerance, maxit, verbosity);
 
             // Solve system.
             Dune::InverseOperatorResult result;
             linsolve.apply(x, b, result);
+            cache.reuse.solveDone(result.iterations, result.converged);
+
+            if (reused && !result.converged) {
+                // A reused hierarchy must not cause a failure: retry with a fresh one.
+                const int iterationsReused = result.iterations;
+                cache.buildAMG();
+                Dune::BiCGSTABSolver<Vector1> freshsolve(*cache.op, *cache.amg, tolerance, maxit, verbosity);
+                x = 0.0;
+                b = b0;
+                freshsolve.apply(x, b, result);
+                cache.reuse.solveDone(result.iterations, result.converged);
+                result.iterations += iterationsReused;
+            }
+            else if (cache.reuse.mode() == PreconditionerReusePolicy::Rebuild) {
+                // Do not keep the hierarchy and matrix in memory if they will not be reused.
+                cache.amg.reset();
+                cache.op.reset();
+                cache.matrix.reset();
+            }
 
             // Check for failure of linear solver.
             if (!result.converged) {
@@ -464,20 +770,45 @@ namespace Opm
     } // end namespace detail
 
 
+    /// Construct a system solver.
+    NewtonIterationBlackoilInterleaved::NewtonIterationBlackoilInterleaved(const ParameterGroup& param,
+                                                                           const boost::any& parallelInformation_arg)
+      : newtonIncrementDoublePrecision_(),
+        newtonIncrementSinglePrecision_(),
+        parameters_( param ),
+        parallelInformation_(parallelInformation_arg),
+        iterations_( 0 ),
+        mixedPrecisionPreconditioner_( param.getDefault("linear_solver_mixed_precision", false) ),
+        mixedPrecisionReuse_( param, "linear_solver_mixed_precision_" ),
+        pressureSolverCache_( new detail::PressureSolverCache( param ) )
+    {
+        // The single precision path sets up ILU0 or AMG like ISTLSolver,
+        // there is no single precision CPR preconditioner.
+        if ( mixedPrecisionPreconditioner_ && parameters_.use_cpr_ ) {
+            OPM_THROW(std::runtime_error, "linear_solver_mixed_precision=true cannot be combined with use_cpr=true, "
+                      "use the ILU0 or AMG (linear_solver_use_amg=true) preconditioner instead.");
+        }
+    }
+
+    NewtonIterationBlackoilInterleaved::~NewtonIterationBlackoilInterleaved()
+    {
+    }
+
     NewtonIterationBlackoilInterleaved::SolutionVector
     NewtonIterationBlackoilInterleaved::computeNewtonIncrement(const LinearisedBlackoilResidual& residual) const
     {
+        ScopedTiming timing("computeNewtonIncrement");
         // get np and call appropriate template method
         const int np = residual.material_balance_eq.size();
         if (np == 1) {
-            auto result = detail::computePressureIncrement(residual);
+            auto result = detail::computePressureIncrement(residual, *pressureSolverCache_);
             iterations_ = result.second.iterations;
             return result.first;
         }
 
         const NewtonIterationBlackoilInterface& newtonIncrement = residual.singlePrecision ?
-            detail::NewtonIncrement< maxNumberEquations_, float  > :: get( newtonIncrementSinglePrecision_, parameters_, parallelInformation_, np ) :
-            detail::NewtonIncrement< maxNumberEquations_, double > :: get( newtonIncrementDoublePrecision_, parameters_, parallelInformation_, np );
+            detail::NewtonIncrement< maxNumberEquations_, float  > :: get( newtonIncrementSinglePrecision_, parameters_, parallelInformation_, false, mixedPrecisionReuse_, np ) :
+            detail::NewtonIncrement< maxNumberEquations_, double > :: get( newtonIncrementDoublePrecision_, parameters_, parallelInformation_, mixedPrecisionPreconditioner_, mixedPrecisionReuse_, np );
 
         // compute newton increment
         SolutionVector dx = newtonIncrement.computeNewtonIncrement( residual );
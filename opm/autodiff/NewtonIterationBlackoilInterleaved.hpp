@@ -30,6 +30,7 @@
 #include <opm/common/utility/parameters/ParameterGroup.hpp>
 #include <opm/autodiff/ParallelOverlappingILU0.hpp>
 #include <opm/autodiff/FlowLinearSolverParameters.hpp>
+#include <opm/autodiff/PreconditionerReusePolicy.hpp>
 
 #include <ewoms/common/parametersystem.hh>
 
@@ -41,6 +42,10 @@ namespace Opm
 
     using NewtonIterationBlackoilInterleavedParameters = FlowLinearSolverParameters;
 
+    namespace detail {
+        struct PressureSolverCache;
+    }
+
     /// This class solves the fully implicit black-oil system by
     /// solving the reduced system (after eliminating well variables)
     /// as a block-structured matrix (one block for all cell variables).
@@ -49,12 +54,20 @@ namespace Opm
     public:
 
         /// Construct a system solver.
-        /// \param[in] param   parameters controlling the behaviour of the linear solvers
+        /// \param[in] param   parameters controlling the behaviour of the linear solvers,
+        ///                    besides those of FlowLinearSolverParameters:
+        ///                    linear_solver_mixed_precision (default false) set up and apply
+        ///                    the preconditioner in single precision;
+        ///                    linear_solver_mixed_precision_reuse_setup, _reuse_max_age and
+        ///                    _reuse_iteration_growth, when to recompute that preconditioner,
+        ///                    as the cpr_reuse_* parameters (see PreconditionerReusePolicy)
         /// \param[in] parallelInformation In the case of a parallel run
         ///                                with dune-istl the information about the parallelization.
         NewtonIterationBlackoilInterleaved(const ParameterGroup& param,
                                            const boost::any& parallelInformation=boost::any());
 
+        ~NewtonIterationBlackoilInterleaved();
+
         /// Solve the system of linear equations Ax = b, with A being the
         /// combined derivative matrix of the residual and b
         /// being the residual itself.
@@ -77,6 +90,17 @@ namespace Opm
         NewtonIterationBlackoilInterleavedParameters parameters_;
         boost::any parallelInformation_;
         mutable int iterations_;
+        // Set up and apply the preconditioner in single precision (parameter
+        // linear_solver_mixed_precision), the Krylov solver stays in double.
+        // Rejected together with use_cpr.
+        const bool mixedPrecisionPreconditioner_;
+        // Reuse of the single precision preconditioner, read from its own
+        // linear_solver_mixed_precision_reuse_* parameters, which work like
+        // the cpr_reuse_* ones of the pressure solver.
+        const PreconditionerReusePolicy mixedPrecisionReuse_;
+        // AMG hierarchy of the pressure solver, reused as allowed by the
+        // cpr_reuse_* parameters (see PreconditionerReusePolicy).
+        mutable std::unique_ptr< detail::PressureSolverCache > pressureSolverCache_;
     };
 
 } // namespace Opm
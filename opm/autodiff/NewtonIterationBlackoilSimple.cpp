@@ -21,6 +21,7 @@
 
 #include <opm/autodiff/NewtonIterationBlackoilSimple.hpp>
 #include <opm/autodiff/AutoDiffHelpers.hpp>
+#include <opm/autodiff/TimingRegistry.hpp>
 #include <opm/common/ErrorMacros.hpp>
 #include <opm/common/Exceptions.hpp>
 #include <opm/core/linalg/LinearSolverFactory.hpp>
@@ -47,6 +48,7 @@ namespace Opm
     NewtonIterationBlackoilSimple::SolutionVector
     NewtonIterationBlackoilSimple::computeNewtonIncrement(const LinearisedBlackoilResidual& residual) const
     {
+        ScopedTiming timing("computeNewtonIncrement");
         typedef LinearisedBlackoilResidual::ADB ADB;
         const int np = residual.material_balance_eq.size();
         ADB mass_res = residual.material_balance_eq[0];
@@ -258,6 +258,7 @@ namespace Opm
               eclipseState_( eclipseState ),
               schedule_(schedule),
               globalCellData_(new data::Solution),
+              globalWellStateStep_(-1),
               isIORank_(true),
               phaseUsage_(phaseUsage)
 
@@ -376,15 +377,22 @@ namespace Opm
 
                 if( isIORank )
                 {
-                    // add missing data to global cell data
-                    for (const auto& pair : localCellData_) {
-                        const std::string& key = pair.first;
-                        std::size_t container_size = numGlobalCells;
-                        auto ret = globalCellData_.insert(key, pair.second.dim,
-                                                std::vector<double>(container_size),
-                                                pair.second.target);
-                        assert(ret.second);
-                        DUNE_UNUSED_PARAMETER(ret.second); //dummy op to prevent warning with -DNDEBUG
+                    // Every entry of the global cell data is overwritten
+                    // when unpacking, so the vectors of the last gather are
+                    // reused unless the set of fields has changed.
+                    if( ! hasFields( globalCellData_, localCellData_, numGlobalCells ) )
+                    {
+                        globalCellData_.clear();
+                        // add missing data to global cell data
+                        for (const auto& pair : localCellData_) {
+                            const std::string& key = pair.first;
+                            std::size_t container_size = numGlobalCells;
+                            auto ret = globalCellData_.insert(key, pair.second.dim,
+                                                    std::vector<double>(container_size),
+                                                    pair.second.target);
+                            assert(ret.second);
+                            DUNE_UNUSED_PARAMETER(ret.second); //dummy op to prevent warning with -DNDEBUG
+                        }
                     }
 
                     MessageBufferType buffer;
@@ -437,6 +445,27 @@ namespace Opm
             }
 
         protected:
+            // true if global holds exactly the fields of local, with
+            // numGlobalCells entries each
+            static bool hasFields( const data::Solution& global,
+                                   const data::Solution& local,
+                                   const std::size_t numGlobalCells )
+            {
+                if( global.size() != local.size() ) {
+                    return false;
+                }
+                for (const auto& pair : local) {
+                    auto it = global.find( pair.first );
+                    if( it == global.end() ||
+                        it->second.dim != pair.second.dim ||
+                        it->second.target != pair.second.target ||
+                        it->second.data.size() != numGlobalCells ) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
             template <class Vector>
             void write( MessageBufferType& buffer, const IndexMapType& localIndexMap,
                         const Vector& vector,
@@ -602,7 +631,9 @@ namespace Opm
                               const data::Solution& localCellData,
                               const int wellStateStepNumber )
         {
-            if( isIORank() )
+            // The wells only change with the report step, substeps reuse
+            // the global well state of the last gather.
+            if( isIORank() && wellStateStepNumber != globalWellStateStep_ )
             {
                 Dune::CpGrid& globalGrid = *grid_;
                 // TODO: make a dummy DynamicListEconLimited here for NOW for compilation and development
@@ -629,7 +660,7 @@ namespace Opm
 
                 const Wells* wells = wells_manager.c_wells();
                 globalWellState_.initLegacy(wells, *globalReservoirState_, globalWellState_, phaseUsage_ );
-                globalCellData_->clear();
+                globalWellStateStep_ = wellStateStepNumber;
             }
 
             PackUnPackSimulationDataContainer packUnpack( numCells(),
@@ -646,9 +677,11 @@ namespace Opm
 #endif
             if( isIORank() )
             {
-                // copy values from globalCellData to globalReservoirState
-                RestartValue restart_value(*globalCellData_, {});
+                // copy values from globalCellData to globalReservoirState,
+                // lending the global cell data to the restart value
+                RestartValue restart_value(std::move(*globalCellData_), {});
                 solutionToSim(restart_value,  phaseUsage_, *globalReservoirState_);
+                *globalCellData_ = std::move(restart_value.solution);
             }
             return isIORank();
         }
@@ -691,6 +724,8 @@ namespace Opm
         std::unique_ptr<data::Solution>           globalCellData_;
         // this needs to be revised
         WellStateFullyImplicitBlackoil            globalWellState_;
+        // report step the global well state was set up for
+        int                                       globalWellStateStep_;
         // true if we are on I/O rank
         bool                                      isIORank_;
         // Phase usage needed to convert solution to simulation data container
@@ -0,0 +1,146 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_PRECONDITIONERREUSEPOLICY_HEADER_INCLUDED
+#define OPM_PRECONDITIONERREUSEPOLICY_HEADER_INCLUDED
+
+#include <opm/common/utility/parameters/ParameterGroup.hpp>
+
+#include <algorithm>
+#include <string>
+
+namespace Opm
+{
+
+    /// Decides when the setup of a preconditioner (e.g. an AMG hierarchy)
+    /// must be recomputed and when it may be reused for the next linear
+    /// solve.
+    ///
+    /// A setup is reused for at most maxAge() solves. It is also recomputed
+    /// when the sparsity structure of the matrix changes, when a solve did
+    /// not converge, or when the number of linear iterations has grown
+    /// beyond iterationGrowth() times the iterations of the first solve
+    /// with the current setup.
+    class PreconditionerReusePolicy
+    {
+    public:
+        /// How much of the setup is kept when it is reused.
+        enum Mode {
+            /// Recompute the setup for every solve.
+            Rebuild = 0,
+            /// Reuse the complete preconditioner.
+            ReuseAll = 1,
+            /// Keep the AMG aggregation, but recompute the coarse level
+            /// matrices from the new fine level matrix.
+            ReuseAggregation = 2
+        };
+
+        /// Construct a policy that rebuilds the setup for every solve.
+        PreconditionerReusePolicy()
+            : PreconditionerReusePolicy(Rebuild, 1, 1.0)
+        {
+        }
+
+        PreconditionerReusePolicy(const Mode mode, const int maxAge, const double iterationGrowth)
+            : mode_(mode),
+              maxAge_(mode == Rebuild ? 1 : std::max(maxAge, 1)),
+              iterationGrowth_(iterationGrowth),
+              valid_(false), stale_(false), age_(0), reference_(-1),
+              setups_(0), solves_(0)
+        {
+        }
+
+        /// Read the policy from the parameters
+        ///     cpr_reuse_setup            (default 0) 0: rebuild, 1: reuse all, 2: reuse aggregation
+        ///     cpr_reuse_max_age          (default 10) maximum number of solves with one setup
+        ///     cpr_reuse_iteration_growth (default 1.5) relative iteration growth marking a setup stale
+        explicit PreconditionerReusePolicy(const ParameterGroup& param)
+            : PreconditionerReusePolicy(param, "cpr_")
+        {
+        }
+
+        /// Read the policy from the parameters prefix + "reuse_setup",
+        /// prefix + "reuse_max_age" and prefix + "reuse_iteration_growth",
+        /// with the meaning and defaults of the cpr_reuse_* parameters.
+        /// Gives each preconditioner its own policy.
+        PreconditionerReusePolicy(const ParameterGroup& param, const std::string& prefix)
+            : PreconditionerReusePolicy(static_cast<Mode>(std::min(std::max(param.getDefault(prefix + "reuse_setup", 0), 0), 2)),
+                                        param.getDefault(prefix + "reuse_max_age", 10),
+                                        param.getDefault(prefix + "reuse_iteration_growth", 1.5))
+        {
+        }
+
+        Mode mode() const { return mode_; }
+        int maxAge() const { return maxAge_; }
+        double iterationGrowth() const { return iterationGrowth_; }
+
+        /// Whether the setup must be recomputed before the next solve.
+        bool needsSetup(const bool structureChanged) const
+        {
+            return !valid_ || structureChanged || stale_ || age_ >= maxAge_;
+        }
+
+        /// Report that the setup has been recomputed.
+        void setupDone()
+        {
+            valid_ = true;
+            stale_ = false;
+            age_ = 0;
+            reference_ = -1;
+            ++setups_;
+        }
+
+        /// Report the outcome of a solve with the current setup.
+        void solveDone(const int iterations, const bool converged)
+        {
+            ++age_;
+            ++solves_;
+            if (!converged) {
+                stale_ = true;
+            }
+            else if (reference_ < 0) {
+                reference_ = std::max(iterations, 1);
+            }
+            else if (iterations > iterationGrowth_ * reference_) {
+                stale_ = true;
+            }
+        }
+
+        /// Force the next solve to recompute the setup.
+        void invalidate() { valid_ = false; }
+
+        /// Number of setups computed so far.
+        int setups() const { return setups_; }
+
+        /// Number of solves reported so far.
+        int solves() const { return solves_; }
+
+    private:
+        Mode mode_;
+        int maxAge_;
+        double iterationGrowth_;
+        bool valid_;
+        bool stale_;
+        int age_;
+        int reference_;
+        int setups_;
+        int solves_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_PRECONDITIONERREUSEPOLICY_HEADER_INCLUDED
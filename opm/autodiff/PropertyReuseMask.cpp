@@ -0,0 +1,132 @@
+/*
+  Copyright 2017 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+#include <opm/autodiff/PropertyReuseMask.hpp>
+
+#include <cmath>
+
+namespace Opm
+{
+
+    namespace
+    {
+        bool relativeChange(const double x, const double x_ref, const double tolerance)
+        {
+            return std::fabs(x - x_ref) > tolerance*std::fabs(x_ref);
+        }
+    }
+
+
+    PropertyReuseMask::PropertyReuseMask(const double tolerance)
+        : tolerance_(tolerance),
+          num_cells_(0),
+          valid_(false)
+    {
+    }
+
+
+    void PropertyReuseMask::invalidate()
+    {
+        valid_ = false;
+    }
+
+
+    void PropertyReuseMask::update(const std::vector<double>& pressure,
+                                   const std::vector<double>& saturation,
+                                   const int np,
+                                   const std::vector<double>& rs,
+                                   const std::vector<double>& rv,
+                                   const std::vector<int>& variable_set)
+    {
+        const int nc = pressure.size();
+        const bool all_dirty = !enabled() || !valid_ || nc != num_cells_
+            || rs.size() != rs_.size() || rv.size() != rv_.size()
+            || variable_set.size() != variable_set_.size()
+            || static_cast<int>(saturation_.size()) != nc*np;
+
+        num_cells_ = nc;
+        dirty_.clear();
+        clean_.clear();
+        if (all_dirty) {
+            dirty_.resize(nc);
+            for (int c = 0; c < nc; ++c) {
+                dirty_[c] = c;
+            }
+            if (enabled()) {
+                pressure_ = pressure;
+                saturation_ = saturation;
+                rs_ = rs;
+                rv_ = rv;
+                variable_set_ = variable_set;
+                valid_ = true;
+            }
+            return;
+        }
+
+        for (int c = 0; c < nc; ++c) {
+            if (changed(c, pressure, saturation, np, rs, rv, variable_set)) {
+                dirty_.push_back(c);
+                pressure_[c] = pressure[c];
+                for (int phase = 0; phase < np; ++phase) {
+                    saturation_[c*np + phase] = saturation[c*np + phase];
+                }
+                if (!rs_.empty()) {
+                    rs_[c] = rs[c];
+                }
+                if (!rv_.empty()) {
+                    rv_[c] = rv[c];
+                }
+                variable_set_[c] = variable_set[c];
+            } else {
+                clean_.push_back(c);
+            }
+        }
+    }
+
+
+    bool PropertyReuseMask::changed(const int c,
+                                    const std::vector<double>& pressure,
+                                    const std::vector<double>& saturation,
+                                    const int np,
+                                    const std::vector<double>& rs,
+                                    const std::vector<double>& rv,
+                                    const std::vector<int>& variable_set) const
+    {
+        if (variable_set[c] != variable_set_[c]) {
+            return true;
+        }
+        if (relativeChange(pressure[c], pressure_[c], tolerance_)) {
+            return true;
+        }
+        for (int phase = 0; phase < np; ++phase) {
+            if (std::fabs(saturation[c*np + phase] - saturation_[c*np + phase]) > tolerance_) {
+                return true;
+            }
+        }
+        if (!rs.empty() && relativeChange(rs[c], rs_[c], tolerance_)) {
+            return true;
+        }
+        if (!rv.empty() && relativeChange(rv[c], rv_[c], tolerance_)) {
+            return true;
+        }
+        return false;
+    }
+
+} // namespace Opm
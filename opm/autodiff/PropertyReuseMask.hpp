@@ -0,0 +1,135 @@
+/*
+  Copyright 2017 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_PROPERTYREUSEMASK_HEADER_INCLUDED
+#define OPM_PROPERTYREUSEMASK_HEADER_INCLUDED
+
+#include <opm/autodiff/AutoDiffBlock.hpp>
+#include <opm/autodiff/AutoDiffHelpers.hpp>
+
+#include <cassert>
+#include <vector>
+
+namespace Opm
+{
+
+    /// Per-cell dirty mask for reusing fluid property evaluations
+    /// between Newton iterations.
+    ///
+    /// The mask remembers the cell state (pressure, saturations, rs,
+    /// rv and the choice of primary variables) at which the cached
+    /// properties of each cell were last evaluated. On update(), a cell
+    /// is dirty if, compared to that state,
+    ///   - pressure, rs or rv changed by more than tolerance relative
+    ///     to the old value,
+    ///   - any saturation changed by more than tolerance,
+    ///   - the choice of primary variables changed.
+    /// The reference state of the dirty cells is then set to the new
+    /// state, since their properties are expected to be re-evaluated.
+    /// Comparing with the state of the last evaluation rather than the
+    /// previous iteration keeps cached values from drifting by more
+    /// than the tolerance over several small updates.
+    ///
+    /// A tolerance of zero disables reuse: every cell is dirty.
+    class PropertyReuseMask
+    {
+    public:
+        typedef AutoDiffBlock<double> ADB;
+
+        /// Construct with a given tolerance.
+        explicit PropertyReuseMask(const double tolerance = 0.0);
+
+        /// Whether the tolerance allows any reuse at all.
+        bool enabled() const { return tolerance_ > 0.0; }
+
+        /// Forget the reference state, so that all cells are dirty on
+        /// the next update().
+        void invalidate();
+
+        /// Compare the given state with the reference state, and
+        /// compute the dirty and clean cells.
+        /// \param[in] pressure      pressure, one value per cell
+        /// \param[in] saturation    saturations, np values per cell
+        /// \param[in] np            number of phases
+        /// \param[in] rs            gas-oil ratio, or empty
+        /// \param[in] rv            oil-gas ratio, or empty
+        /// \param[in] variable_set  any per-cell integer identifying the
+        ///                          choice of primary variables
+        void update(const std::vector<double>& pressure,
+                    const std::vector<double>& saturation,
+                    const int np,
+                    const std::vector<double>& rs,
+                    const std::vector<double>& rv,
+                    const std::vector<int>& variable_set);
+
+        /// Number of cells given to the last update().
+        int numCells() const { return num_cells_; }
+
+        /// Whether all cells are dirty, i.e. nothing can be reused.
+        bool allDirty() const { return clean_.empty(); }
+
+        /// Cells whose properties must be re-evaluated, in increasing order.
+        const std::vector<int>& dirtyCells() const { return dirty_; }
+
+        /// Cells whose cached properties are still valid, in increasing order.
+        const std::vector<int>& cleanCells() const { return clean_; }
+
+        /// Combine cached properties for all cells with fresh
+        /// properties for the dirty cells only. The result has the
+        /// values and derivatives of fresh in the dirty cells and those
+        /// of cached in the clean cells.
+        ADB merge(const ADB& cached, const ADB& fresh) const
+        {
+            assert(fresh.size() == static_cast<int>(dirty_.size()));
+            if (clean_.empty()) {
+                return fresh;
+            }
+            assert(cached.size() == num_cells_);
+            if (dirty_.empty()) {
+                return cached;
+            }
+            return superset(subset(cached, clean_), clean_, num_cells_)
+                + superset(fresh, dirty_, num_cells_);
+        }
+
+    private:
+        bool changed(const int cell,
+                     const std::vector<double>& pressure,
+                     const std::vector<double>& saturation,
+                     const int np,
+                     const std::vector<double>& rs,
+                     const std::vector<double>& rv,
+                     const std::vector<int>& variable_set) const;
+
+        double tolerance_;
+        int num_cells_;
+        bool valid_;
+        std::vector<int> dirty_;
+        std::vector<int> clean_;
+        // State at the last evaluation of each cell.
+        std::vector<double> pressure_;
+        std::vector<double> saturation_;
+        std::vector<double> rs_;
+        std::vector<double> rv_;
+        std::vector<int> variable_set_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_PROPERTYREUSEMASK_HEADER_INCLUDED
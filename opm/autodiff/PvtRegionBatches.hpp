@@ -0,0 +1,139 @@
+/*
+  Copyright 2017 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_PVTREGIONBATCHES_HEADER_INCLUDED
+#define OPM_PVTREGIONBATCHES_HEADER_INCLUDED
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+namespace Opm
+{
+
+    /// Groups the entries of a cell array by PVT region, so that
+    /// property evaluation can run over one region at a time, with
+    /// the region (and thereby the tables) fixed for a whole batch.
+    ///
+    /// The grouping is a stable counting sort, so within a region the
+    /// entries keep the order of the cell array. When all cells are in
+    /// the same region there is a single batch covering the entire
+    /// array, and no permutation is stored.
+    class PvtRegionBatches
+    {
+    public:
+        /// No entries.
+        PvtRegionBatches()
+            : size_(0)
+        {
+        }
+
+        /// Group the entries of cells by region_of_cell[cells[i]].
+        PvtRegionBatches(const std::vector<int>& region_of_cell,
+                         const std::vector<int>& cells)
+            : size_(static_cast<int>(cells.size()))
+        {
+            if (size_ == 0) {
+                return;
+            }
+            int min_region = region_of_cell[cells[0]];
+            int max_region = min_region;
+            for (const int cell : cells) {
+                min_region = std::min(min_region, region_of_cell[cell]);
+                max_region = std::max(max_region, region_of_cell[cell]);
+            }
+            if (min_region == max_region) {
+                regions_.push_back(min_region);
+                start_ = { 0, size_ };
+                return;
+            }
+
+            // Counting sort on the region index.
+            const int num_regions = max_region - min_region + 1;
+            std::vector<int> count(num_regions + 1, 0);
+            for (const int cell : cells) {
+                ++count[region_of_cell[cell] - min_region + 1];
+            }
+            start_.push_back(0);
+            for (int r = 0; r < num_regions; ++r) {
+                if (count[r + 1] > 0) {
+                    regions_.push_back(min_region + r);
+                    start_.push_back(start_.back() + count[r + 1]);
+                }
+                count[r + 1] += count[r];
+            }
+            index_.resize(size_);
+            for (int i = 0; i < size_; ++i) {
+                index_[count[region_of_cell[cells[i]] - min_region]++] = i;
+            }
+        }
+
+        /// Number of entries of the cell array.
+        int size() const
+        {
+            return size_;
+        }
+
+        /// Number of batches, i.e. of distinct regions among the cells.
+        int numBatches() const
+        {
+            return static_cast<int>(regions_.size());
+        }
+
+        /// Region of a batch.
+        int region(const int batch) const
+        {
+            return regions_[batch];
+        }
+
+        /// Call kernel(region, i) for every entry i of the cell
+        /// array, one region at a time.
+        template <class Kernel>
+        void forEach(const Kernel& kernel) const
+        {
+            if (index_.empty()) {
+                assert(numBatches() <= 1);
+                if (size_ > 0) {
+                    const int region = regions_[0];
+                    for (int i = 0; i < size_; ++i) {
+                        kernel(region, i);
+                    }
+                }
+                return;
+            }
+            for (int batch = 0; batch < numBatches(); ++batch) {
+                const int region = regions_[batch];
+                for (int k = start_[batch]; k < start_[batch + 1]; ++k) {
+                    kernel(region, index_[k]);
+                }
+            }
+        }
+
+    private:
+        int size_;
+        std::vector<int> regions_;
+        std::vector<int> start_;
+        // Entries of the cell array, sorted by region. Empty for a
+        // single region.
+        std::vector<int> index_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_PVTREGIONBATCHES_HEADER_INCLUDED
@@ -525,6 +525,12 @@ public:
     {
         return dim==3 && codim==0;
     }
+    /// \brief Set up what depends on the received values. To be called
+    /// once all of them have been scattered.
+    void finish()
+    {
+        recvProps_.initPvtRegionBatches();
+    }
 private:
     /// \brief The properties where we will retieve the values to be sent.
     const BlackoilPropsAdFromDeck& sendProps_;
@@ -588,6 +594,7 @@ distributeGridAndData( Dune::CpGrid& grid,
                                          distributed_props);
     grid.scatterData(state_handle);
     grid.scatterData(props_handle);
+    props_handle.finish();
     // Create a distributed Geology. Some values will be updated using communication
     // below
     DerivedGeology distributed_geology(grid,
@@ -0,0 +1,224 @@
+/*
+  Copyright 2017 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_SCRATCHARENA_HEADER_INCLUDED
+#define OPM_SCRATCHARENA_HEADER_INCLUDED
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace Opm
+{
+
+    /// Stack-like arena for short-lived scratch arrays.
+    ///
+    /// Memory is handed out by advancing a position in a few large
+    /// chunks, and given back by rewinding the position when a Scope
+    /// ends. It is kept for later scopes, so after the first Newton
+    /// iteration the scratch arrays of the assembly do not touch the
+    /// heap at all. When the outermost scope ends, memory beyond
+    /// maxRetained() is freed, and if more than one chunk was needed the
+    /// remaining chunks are merged into one. shrinkTo() and release()
+    /// free memory explicitly, e.g. at the end of a time step.
+    ///
+    /// Usage:
+    ///     ScratchArena& arena = ScratchArena::threadLocal();
+    ///     const ScratchArena::Scope scope(arena);
+    ///     double* tmp = arena.allocate<double>(n);
+    ///
+    /// Only trivially destructible types can be allocated, and their
+    /// contents are uninitialized.
+    class ScratchArena
+    {
+    public:
+        /// Alignment of every allocation, in bytes.
+        static const std::size_t alignment = 64;
+
+        /// Default of maxRetained(), in bytes.
+        static const std::size_t defaultMaxRetained = std::size_t(256) << 20;
+
+        /// Rewinds the arena to its position at construction when
+        /// going out of scope.
+        class Scope
+        {
+        public:
+            explicit Scope(ScratchArena& arena)
+                : arena_(arena), chunk_(arena.chunk_), offset_(arena.offset_)
+            {
+                ++arena_.depth_;
+            }
+
+            ~Scope()
+            {
+                --arena_.depth_;
+                arena_.rewind(chunk_, offset_);
+            }
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+        private:
+            ScratchArena& arena_;
+            std::size_t chunk_;
+            std::size_t offset_;
+        };
+
+        ScratchArena()
+            : chunk_(0), offset_(0), depth_(0), max_retained_(defaultMaxRetained)
+        {
+        }
+
+        ScratchArena(const ScratchArena&) = delete;
+        ScratchArena& operator=(const ScratchArena&) = delete;
+
+        /// The arena of the calling thread.
+        static ScratchArena& threadLocal()
+        {
+            static thread_local ScratchArena arena;
+            return arena;
+        }
+
+        /// Uninitialized storage for n objects, valid until the
+        /// enclosing Scope ends.
+        template <class T>
+        T* allocate(const std::size_t n)
+        {
+            static_assert(std::is_trivially_destructible<T>::value,
+                          "ScratchArena only holds trivially destructible types.");
+            static_assert(alignment % alignof(T) == 0, "Unsupported alignment.");
+            assert(depth_ > 0);
+            return static_cast<T*>(allocateBytes(n * sizeof(T)));
+        }
+
+        /// Total size of the chunks held, in bytes.
+        std::size_t capacity() const
+        {
+            std::size_t total = 0;
+            for (const Chunk& chunk : chunks_) {
+                total += chunk.size;
+            }
+            return total;
+        }
+
+        /// Number of chunks held.
+        std::size_t numChunks() const { return chunks_.size(); }
+
+        /// Largest capacity kept when the outermost Scope ends, in bytes.
+        std::size_t maxRetained() const { return max_retained_; }
+
+        /// Set the largest capacity kept when the outermost Scope ends.
+        /// A single very large evaluation then does not pin its scratch
+        /// memory for the rest of the run.
+        void setMaxRetained(const std::size_t bytes) { max_retained_ = bytes; }
+
+        /// Free chunks until at most bytes are held. Must not be called
+        /// within a Scope.
+        void shrinkTo(const std::size_t bytes)
+        {
+            assert(depth_ == 0);
+            std::size_t total = capacity();
+            while (total > bytes) {
+                total -= chunks_.back().size;
+                chunks_.pop_back();
+            }
+            chunk_ = 0;
+            offset_ = 0;
+        }
+
+        /// Free all memory. Must not be called within a Scope.
+        void release()
+        {
+            shrinkTo(0);
+        }
+
+    private:
+        struct Chunk
+        {
+            std::unique_ptr<char[]> data;
+            std::size_t size;
+        };
+
+        static std::size_t alignUp(const std::size_t n)
+        {
+            return (n + alignment - 1) / alignment * alignment;
+        }
+
+        char* chunkBegin(const std::size_t c) const
+        {
+            // The storage of a chunk is over-allocated by alignment
+            // bytes, so that it can start on an aligned address.
+            const std::size_t addr = reinterpret_cast<std::size_t>(chunks_[c].data.get());
+            return chunks_[c].data.get() + (alignUp(addr) - addr);
+        }
+
+        void addChunk(const std::size_t size)
+        {
+            Chunk chunk;
+            chunk.data.reset(new char[size + alignment]);
+            chunk.size = size;
+            chunks_.push_back(std::move(chunk));
+        }
+
+        void* allocateBytes(const std::size_t bytes)
+        {
+            const std::size_t needed = alignUp(std::max(bytes, std::size_t(1)));
+            // Find a chunk, from the current one on, with room left.
+            while (chunk_ < chunks_.size() && offset_ + needed > chunks_[chunk_].size) {
+                ++chunk_;
+                offset_ = 0;
+            }
+            if (chunk_ == chunks_.size()) {
+                const std::size_t last = chunks_.empty() ? 0 : chunks_.back().size;
+                addChunk(std::max(needed, std::max(2*last, std::size_t(1) << 16)));
+            }
+            void* p = chunkBegin(chunk_) + offset_;
+            offset_ += needed;
+            return p;
+        }
+
+        void rewind(const std::size_t chunk, const std::size_t offset)
+        {
+            chunk_ = chunk;
+            offset_ = offset;
+            if (depth_ == 0) {
+                // Nothing is in use: drop what exceeds the retained
+                // capacity and merge the rest into one chunk.
+                shrinkTo(max_retained_);
+                if (chunks_.size() > 1) {
+                    const std::size_t total = capacity();
+                    chunks_.clear();
+                    addChunk(total);
+                }
+            }
+        }
+
+        std::vector<Chunk> chunks_;
+        std::size_t chunk_;
+        std::size_t offset_;
+        int depth_;
+        std::size_t max_retained_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_SCRATCHARENA_HEADER_INCLUDED
@@ -28,6 +28,8 @@
 #include <opm/core/well_controls.h>
 #include <opm/core/wells/DynamicListEconLimited.hpp>
 #include <opm/autodiff/BlackoilModel.hpp>
+#include <opm/autodiff/TimingRegistry.hpp>
+#include <opm/autodiff/fastSparseOperations.hpp>
 
 namespace Opm
 {
@@ -114,6 +116,20 @@ namespace Opm
                 tstep_os.open(tstep_filename.c_str());
         }
 
+        // Hierarchical timings of the assembly, linear solve and output,
+        // written to timing.json and timing.csv at the end of the run.
+        TimingRegistry& timing_registry = TimingRegistry::instance();
+        const bool timing_report = param_.getDefault("timing_report", false);
+        if ( timing_report ) {
+            timing_registry.reset();
+            timing_registry.setEnabled(true);
+        }
+
+        // Per-thread memory for the cached structure of the products with
+        // the discrete operators of the model, 0 disables the cache.
+        const int sparse_plan_cache_mb = std::max(param_.getDefault("sparse_plan_cache_mb", 32), 0);
+        setSparsePlanCacheMaxBytes(std::size_t(sparse_plan_cache_mb) << 20);
+
         // adaptive time stepping
         const auto& events = schedule_->getEvents();
         std::unique_ptr< AdaptiveTimeStepping > adaptiveTimeStepping;
@@ -152,6 +168,7 @@ namespace Opm
         while (!timer.done()) {
             // Report timestep.
             step_timer.start();
+            timing_registry.setReportStep(timer.currentStepNum());
             if ( terminal_output_ )
             {
                 std::ostringstream ss;
@@ -322,6 +339,24 @@ namespace Opm
                                            well_state, dynamic_list_econ_limited);
         }
 
+        // make sure the last report steps are on disk before returning
+        output_writer_.waitForPendingWrites();
+
+        if ( timing_report ) {
+            timing_registry.setEnabled(false);
+            if ( output_writer_.output() && output_writer_.isIORank() ) {
+                std::ofstream json_os(output_writer_.outputDirectory() + "/timing.json");
+                timing_registry.writeJson(json_os);
+                std::ofstream csv_os(output_writer_.outputDirectory() + "/timing.csv");
+                timing_registry.writeCsv(csv_os);
+            }
+            if ( terminal_output_ ) {
+                std::ostringstream ss;
+                timing_registry.print(ss);
+                OpmLog::info(ss.str());
+            }
+        }
+
         // Stop timer and create timing report
         total_timer.stop();
         report.total_time = total_timer.secsSinceStart();
@@ -36,7 +36,9 @@
 #include <opm/parser/eclipse/Units/Units.hpp>
 
 #include <opm/autodiff/GridHelpers.hpp>
+#include <opm/autodiff/TimingRegistry.hpp>
 
+#include <chrono>
 #include <sstream>
 #include <iomanip>
 #include <fstream>
@@ -179,7 +181,6 @@ namespace Opm
         {
             BlackoilOutputWriter& writer_;
             std::unique_ptr< SimulatorTimerInterface > timer_;
-            const SimulationDataContainer state_;
             const WellStateFullyImplicitBlackoil wellState_;
             data::Solution simProps_;
             std::map<std::string, double> miscSummaryData_;
@@ -188,17 +189,15 @@ namespace Opm
 
             explicit WriterCall( BlackoilOutputWriter& writer,
                                  const SimulatorTimerInterface& timer,
-                                 const SimulationDataContainer& state,
                                  const WellStateFullyImplicitBlackoil& wellState,
-                                 const data::Solution& simProps,
+                                 data::Solution&& simProps,
                                  const std::map<std::string, double>& miscSummaryData,
                                  const RestartValue::ExtraVector& extraRestartData,
                                  bool substep)
                 : writer_( writer ),
                   timer_( timer.clone() ),
-                  state_( state ),
                   wellState_( wellState ),
-                  simProps_( simProps ),
+                  simProps_( std::move( simProps ) ),
                   miscSummaryData_( miscSummaryData ),
                   extraRestartData_( extraRestartData ),
                   substep_( substep )
@@ -209,7 +208,7 @@ namespace Opm
             void run ()
             {
                 // write data
-                writer_.writeTimeStepSerial( *timer_, state_, wellState_, simProps_, miscSummaryData_, extraRestartData_, substep_ );
+                writer_.writeTimeStepSerial( *timer_, wellState_, std::move( simProps_ ), miscSummaryData_, extraRestartData_, substep_ );
             }
         };
     }
@@ -232,7 +231,7 @@ namespace Opm
         {
             localCellData = simToSolution(localState, restart_double_si_, phaseUsage_); // Get "normal" data (SWAT, PRESSURE, ...);
         }
-        writeTimeStepWithCellProperties(timer, localState, localCellData ,
+        writeTimeStepWithCellProperties(timer, localState, std::move(localCellData),
                                         localWellState, miscSummaryData, extraRestartData, substep);
     }
 
@@ -251,6 +250,26 @@ namespace Opm
                   const RestartValue::ExtraVector& extraRestartData,
                   bool substep)
     {
+        writeTimeStepWithCellProperties(timer, localState, data::Solution(localCellData),
+                                        localWellState, miscSummaryData, extraRestartData, substep);
+    }
+
+
+
+
+
+    void
+    BlackoilOutputWriter::
+    writeTimeStepWithCellProperties(
+                  const SimulatorTimerInterface& timer,
+                  const SimulationDataContainer& localState,
+                  data::Solution&& localCellData,
+                  const WellStateFullyImplicitBlackoil& localWellState,
+                  const std::map<std::string, double>& miscSummaryData,
+                  const RestartValue::ExtraVector& extraRestartData,
+                  bool substep)
+    {
+        ScopedTiming timing("writeTimeStep");
         // VTK output (is parallel if grid is parallel)
         if( vtkWriter_ ) {
             vtkWriter_->writeTimeStep( timer, localState, localWellState, false );
@@ -273,23 +292,52 @@ namespace Opm
             // Note that at this point the extraData are assumed to be global, i.e. identical across all processes.
         }
 
-        const data::Solution& cellData = ( parallelOutput_ && parallelOutput_->isParallel() ) ? parallelOutput_->globalCellData() : localCellData;
-        const SimulationDataContainer& state = (parallelOutput_ && parallelOutput_->isParallel() ) ? parallelOutput_->globalReservoirState() : localState;
-        const WellStateFullyImplicitBlackoil& wellState  = (parallelOutput_ && parallelOutput_->isParallel() ) ? parallelOutput_->globalWellState() : localWellState;
+        const bool gathered = parallelOutput_ && parallelOutput_->isParallel();
+        const SimulationDataContainer& state = gathered ? parallelOutput_->globalReservoirState() : localState;
+        const WellStateFullyImplicitBlackoil& wellState  = gathered ? parallelOutput_->globalWellState() : localWellState;
 
         // serial output is only done on I/O rank
         int err = 0;
         std::string emsg;
         if( isIORank )
         {
+            // The gathered cell data stay with parallelOutput_, the local
+            // ones are ours and are passed on without a copy.
+            data::Solution cellData;
+            if( gathered ) {
+                cellData = parallelOutput_->globalCellData();
+            }
+            else {
+                cellData = std::move( localCellData );
+            }
+
+            // Matlab output reads the reservoir state, which is only
+            // borrowed, so it is always written before returning. The
+            // ECL output owns its data and may be written asynchronously.
             if( asyncOutput_ ) {
+                if( matlabWriter_ ) {
+                    matlabWriter_->writeTimeStep( timer, state, wellState, substep );
+                }
+
+                // report failures of earlier writes that have finished in the meantime
+                while( ! pendingAsyncWrites_.empty() &&
+                       pendingAsyncWrites_.front().wait_for( std::chrono::seconds(0) ) == std::future_status::ready )
+                {
+                    std::future< void > done( std::move( pendingAsyncWrites_.front() ) );
+                    pendingAsyncWrites_.pop_front();
+                    done.get();
+                }
                 // dispatch the write call to the extra thread
-                asyncOutput_->dispatch( detail::WriterCall( *this, timer, state, wellState, cellData, miscSummaryData, extraRestartData, substep ) );
+                pendingAsyncWrites_.emplace_back(
+                    asyncOutput_->dispatch( detail::WriterCall( *this, timer, wellState, std::move( cellData ), miscSummaryData, extraRestartData, substep ) ) );
             }
             else {
                 // just write the data to disk
                 try {
-                    writeTimeStepSerial( timer, state, wellState, cellData, miscSummaryData, extraRestartData, substep );
+                    if( matlabWriter_ ) {
+                        matlabWriter_->writeTimeStep( timer, state, wellState, substep );
+                    }
+                    writeTimeStepSerial( timer, wellState, std::move( cellData ), miscSummaryData, extraRestartData, substep );
                 } catch (std::runtime_error& msg) {
                     err = 1;
                     emsg = msg.what();
@@ -316,18 +364,13 @@ namespace Opm
     void
     BlackoilOutputWriter::
     writeTimeStepSerial(const SimulatorTimerInterface& timer,
-                        const SimulationDataContainer& state,
                         const WellStateFullyImplicitBlackoil& wellState,
-                        const data::Solution& simProps,
+                        data::Solution&& simProps,
                         const std::map<std::string, double>& miscSummaryData,
                         const RestartValue::ExtraVector& extraRestartData,
                         bool substep)
     {
-        // Matlab output
-        if( matlabWriter_ ) {
-            matlabWriter_->writeTimeStep( timer, state, wellState, substep );
-        }
-
+        ScopedTiming timing("writeTimeStepSerial");
         // ECL output
         if ( eclIO_ )
         {
@@ -337,7 +380,7 @@ namespace Opm
             } else {
                 // ... insert "extra" data (KR, VISC, ...)
                 const int reportStepForOutput = substep ? timer.reportStepNum() + 1 : timer.reportStepNum();
-                RestartValue restart_value(simProps, wellState.report(phaseUsage_, globalCellIdxMap_));
+                RestartValue restart_value(std::move(simProps), wellState.report(phaseUsage_, globalCellIdxMap_));
                 for (const auto& extra_pair : extraRestartData) {
                     const RestartKey& restart_key = extra_pair.first;
                     const std::vector<double>& data = extra_pair.second;
@@ -358,6 +401,72 @@ namespace Opm
     }
 
 
+
+    BlackoilOutputWriter::~BlackoilOutputWriter()
+    {
+        // The queued writes refer to this writer, so they have to finish
+        // before it goes away. Errors can only be logged here.
+        const std::exception_ptr error = drainPendingWrites();
+        if( error ) {
+            try {
+                std::rethrow_exception( error );
+            }
+            catch( const std::exception& e ) {
+                OpmLog::error("Asynchronous output failed: " + std::string( e.what() ));
+            }
+            catch( ... ) {
+                OpmLog::error("Asynchronous output failed with an unknown error.");
+            }
+        }
+    }
+
+
+
+    std::exception_ptr
+    BlackoilOutputWriter::
+    drainPendingWrites()
+    {
+        std::exception_ptr firstError;
+        while( ! pendingAsyncWrites_.empty() )
+        {
+            std::future< void > done( std::move( pendingAsyncWrites_.front() ) );
+            pendingAsyncWrites_.pop_front();
+            try {
+                done.get();
+            }
+            catch( ... ) {
+                if( ! firstError ) {
+                    firstError = std::current_exception();
+                }
+            }
+        }
+        return firstError;
+    }
+
+
+
+    void
+    BlackoilOutputWriter::
+    waitForPendingWrites()
+    {
+        if( ! asyncOutput_ ) {
+            return;
+        }
+
+        const std::exception_ptr error = drainPendingWrites();
+        int err = error ? 1 : 0;
+#if HAVE_MPI
+        MPI_Bcast(&err, 1, MPI_INT, 0, MPI_COMM_WORLD);
+#endif
+        if( error ) {
+            std::rethrow_exception( error );
+        }
+        if( err ) {
+            throw std::runtime_error("I/O process encountered problems.");
+        }
+    }
+
+
     bool BlackoilOutputWriter::isRestart() const {
         const auto& initconfig = eclipseState_.getInitConfig();
         return initconfig.restartRequested();
@@ -48,10 +48,14 @@
 #include <opm/parser/eclipse/EclipseState/InitConfig/InitConfig.hpp>
 #include <opm/simulators/ensureDirectoryExists.hpp>
 
+#include <algorithm>
+#include <deque>
+#include <exception>
 #include <string>
 #include <sstream>
 #include <iomanip>
 #include <fstream>
+#include <future>
 #include <thread>
 #include <map>
 
@@ -218,6 +222,10 @@ namespace Opm
                              std::unique_ptr<EclipseIO>&& eclIO,
                              const Opm::PhaseUsage &phaseUsage);
 
+        /** \brief Waits for outstanding asynchronous writes; failures are
+         *         logged, as a destructor must not throw. */
+        ~BlackoilOutputWriter();
+
         /** \copydoc Opm::OutputWriter::writeInit */
         void writeInit(const data::Solution& simProps, const NNC& nnc);
 
@@ -251,6 +259,19 @@ namespace Opm
                            const RestartValue::ExtraVector& extraRestartData,
                            bool substep = false);
 
+        /*!
+         * \brief As above, but takes over cellData, which is then handed
+         *        to the ECL writer (or the asynchronous write) without a copy.
+         */
+        void writeTimeStepWithCellProperties(
+                           const SimulatorTimerInterface& timer,
+                           const SimulationDataContainer& reservoirState,
+                           data::Solution&& cellData,
+                           const Opm::WellStateFullyImplicitBlackoil& wellState,
+                           const std::map<std::string, double>& miscSummaryData,
+                           const RestartValue::ExtraVector& extraRestartData,
+                           bool substep = false);
+
         /*!
          * \brief Write a blackoil reservoir state to disk for later inspection with
          *        visualization tools like ResInsight. This function will not write
@@ -265,18 +286,25 @@ namespace Opm
                            bool substep = false);
 
         /*!
-         * \brief Write a blackoil reservoir state to disk for later inspection with
-         *        visualization tools like ResInsight. This is the function which does
-         *        the actual write to file.
+         * \brief Write the ECL output of a time step to disk. This is the function
+         *        which does the actual write to file, possibly on the asynchronous
+         *        output thread; simProps is taken over by the restart data.
          */
         void writeTimeStepSerial(const SimulatorTimerInterface& timer,
-                                 const SimulationDataContainer& reservoirState,
                                  const Opm::WellStateFullyImplicitBlackoil& wellState,
-                                 const data::Solution& simProps,
+                                 data::Solution&& simProps,
                                  const std::map<std::string, double>& miscSummaryData,
                                  const RestartValue::ExtraVector& extraRestartData,
                                  bool substep );
 
+        /*!
+         * \brief Block until all asynchronous writes have finished. If one of
+         *        them failed, the first error is rethrown on the I/O rank and
+         *        reported as a std::runtime_error on the other ranks. Must be
+         *        called on all ranks, e.g. at the end of the simulation.
+         */
+        void waitForPendingWrites();
+
         /** \brief return output directory */
         const std::string& outputDirectory() const { return outputDir_; }
 
@@ -301,6 +329,9 @@ namespace Opm
         bool requireFIPNUM() const;
 
     protected:
+        // wait for all pending asynchronous writes and return the first failure
+        std::exception_ptr drainPendingWrites();
+
         const bool output_;
         std::unique_ptr< ParallelDebugOutputInterface > parallelOutput_;
 
@@ -317,6 +348,8 @@ namespace Opm
         const SummaryConfig& summaryConfig_;
 
         std::unique_ptr< ThreadHandle > asyncOutput_;
+        // completion of the writes dispatched to asyncOutput_ that have not been checked yet
+        std::deque< std::future< void > > pendingAsyncWrites_;
         const int* globalCellIdxMap_;
     };
 
@@ -350,6 +383,7 @@ namespace Opm
         schedule_(schedule),
         summaryConfig_(summaryConfig),
         asyncOutput_(),
+        pendingAsyncWrites_(),
         globalCellIdxMap_(Opm::UgGridHelpers::globalCell(grid))
     {
         // For output.
@@ -394,7 +428,9 @@ namespace Opm
             {
                 const bool isIORank = parallelOutput_ ? parallelOutput_->isIORank() : true;
 #if HAVE_PTHREAD
-                asyncOutput_.reset( new ThreadHandle( isIORank ) );
+                // number of time steps that may wait for output before the simulation blocks
+                const int queueSize = param.getDefault("async_output_queue_size", 4);
+                asyncOutput_.reset( new ThreadHandle( isIORank, 1, std::max( queueSize, 1 ) ) );
 #else
                 OPM_THROW(std::runtime_error,"Pthreads were not found, cannot enable async_output");
 #endif
@@ -512,15 +548,17 @@ namespace Opm
 
 
         // this method basically converts all Eigen vectors to std::vectors
-        // stored in a SimulationDataContainer
+        // stored in a SimulationDataContainer. Only the data of the model
+        // is stored, the fields of the reservoir state are read directly
+        // from the state by simToSolution().
         template <class SimulatorData>
         SimulationDataContainer
         convertToSimulationDataContainer( const SimulatorData& sd,
                                           const SimulationDataContainer& localState,
                                           const Opm::PhaseUsage& phaseUsage )
         {
-            // copy local state and then add missing data
-            SimulationDataContainer simData( localState );
+            // no cells, to avoid allocating the default fields
+            SimulationDataContainer simData( 0, 0, localState.numPhases() );
 
             //Get shorthands for water, oil, gas
             const int aqua_active   = phaseUsage.phase_used[Opm::PhaseUsage::Aqua];
@@ -894,12 +932,17 @@ namespace Opm
                               std::move( fd.fip[ FIPDataType::FIP_AQUA ] ),
                               data::TargetType::SUMMARY );
             }
+            // fd is our own copy, so its vectors are moved to the output.
             if (liquid_active) {
-                const VectorType& oipl = fd.fip[FIPDataType::FIP_LIQUID];
+                VectorType& oipl = fd.fip[FIPDataType::FIP_LIQUID];
                 VectorType  oip ( oipl );
                 const size_t size = oip.size();
 
-                const VectorType& oipg = vapour_active ? fd.fip[FIPDataType::FIP_VAPORIZED_OIL] : VectorType(size, 0.0);
+                VectorType zeros;
+                if( !vapour_active ) {
+                    zeros.assign(size, 0.0);
+                }
+                VectorType& oipg = vapour_active ? fd.fip[FIPDataType::FIP_VAPORIZED_OIL] : zeros;
                 if( vapour_active )
                 {
                     // oip = oipl + oipg
@@ -931,11 +974,15 @@ namespace Opm
                 }
             }
             if (vapour_active) {
-                const VectorType& gipg = fd.fip[ FIPDataType::FIP_VAPOUR];
+                VectorType& gipg = fd.fip[ FIPDataType::FIP_VAPOUR];
                 VectorType  gip( gipg );
                 const size_t size = gip.size();
 
-                const VectorType& gipl = liquid_active ? fd.fip[ FIPDataType::FIP_DISSOLVED_GAS ] : VectorType(size,0.0);
+                VectorType zeros;
+                if( !liquid_active ) {
+                    zeros.assign(size, 0.0);
+                }
+                VectorType& gipl = liquid_active ? fd.fip[ FIPDataType::FIP_DISSOLVED_GAS ] : zeros;
                 if( liquid_active )
                 {
                     // gip = gipg + gipl
@@ -1016,7 +1063,7 @@ namespace Opm
                 SimulationDataContainer sd =
                     detail::convertToSimulationDataContainer( physicalModel.getSimulatorData(localState), localState, phaseUsage_ );
 
-                localCellData = simToSolution( sd, restart_double_si_, phaseUsage_); // Get "normal" data (SWAT, PRESSURE, ...);
+                localCellData = simToSolution( localState, restart_double_si_, phaseUsage_); // Get "normal" data (SWAT, PRESSURE, ...);
 
                 detail::getRestartData( localCellData, std::move(sd), phaseUsage_, physicalModel,
                                         restartConfig, reportStepNum, logMessages );
@@ -1034,7 +1081,7 @@ namespace Opm
                 miscSummaryData["TCPU"] = totalSolverTime;
             }
         }
-        writeTimeStepWithCellProperties(timer, localState, localCellData, physicalModel.wellModel().wellState(localWellState), miscSummaryData, extraRestartData, substep);
+        writeTimeStepWithCellProperties(timer, localState, std::move(localCellData), physicalModel.wellModel().wellState(localWellState), miscSummaryData, extraRestartData, substep);
     }
 }
 #endif
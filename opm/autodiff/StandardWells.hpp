@@ -42,6 +42,8 @@
 #include <opm/autodiff/AutoDiffBlock.hpp>
 #include <opm/autodiff/AutoDiffHelpers.hpp>
 #include <opm/autodiff/BlackoilPropsAdFromDeck.hpp>
+#include <opm/autodiff/VFPInjPropertiesLegacy.hpp>
+#include <opm/autodiff/VFPProdPropertiesLegacy.hpp>
 #include <opm/simulators/WellSwitchingLogger.hpp>
 
 namespace Opm {
@@ -224,6 +226,9 @@ namespace Opm {
             const std::vector<bool>*  active_;
             const std::vector<PhasePresence>*  phase_condition_;
             const VFPProperties<VFPInjPropertiesLegacy,VFPProdPropertiesLegacy>* vfp_properties_;
+            // VFP tables and interpolation intervals of the wells under THP control
+            VFPInjPropertiesLegacy::WellCache vfp_inj_cache_;
+            VFPProdPropertiesLegacy::WellCache vfp_prod_cache_;
             double gravity_;
             // the depth of the all the cell centers
             // for standard Wells, it the same with the perforation depth
@@ -25,6 +25,7 @@
 #include <opm/autodiff/VFPInjPropertiesLegacy.hpp>
 #include <opm/autodiff/VFPProdPropertiesLegacy.hpp>
 #include <opm/autodiff/WellHelpers.hpp>
+#include <opm/autodiff/TimingRegistry.hpp>
 
 
 
@@ -236,6 +237,9 @@ namespace Opm
         // Compute the average pressure in each well block
         const Vector perf_press = Eigen::Map<const Vector>(xw.perfPress().data(), nperf);
         Vector avg_press = perf_press*0;
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif // HAVE_OPENMP
         for (int w = 0; w < nw; ++w) {
             for (int perf = wells().well_connpos[w]; perf < wells().well_connpos[w+1]; ++perf) {
                 const double p_above = perf == wells().well_connpos[w] ? state.bhp.value()[w] : perf_press[perf - 1];
@@ -402,6 +406,7 @@ namespace Opm
                     Vector& aliveWells,
                     std::vector<ADB>& cq_s) const
     {
+        ScopedTiming timing("computeWellFlux");
         if( ! localWellsActive() ) return ;
 
         const int np = wells().number_of_phases;
@@ -423,31 +428,41 @@ namespace Opm
 
         // Compute vectors with zero and ones that
         // selects the wanted quantities.
+        // This is done well by well, in parallel, on the contiguous
+        // perforations of each well.
 
         // selects injection perforations
         Vector selectInjectingPerforations = Vector::Zero(nperf);
         // selects producing perforations
         Vector selectProducingPerforations = Vector::Zero(nperf);
-        for (int c = 0; c < nperf; ++c){
-            if (drawdown.value()[c] < 0)
-                selectInjectingPerforations[c] = 1;
-            else
-                selectProducingPerforations[c] = 1;
-        }
-
-        // Handle cross flow
-        const Vector numInjectingPerforations = (wellOps().p2w * ADB::constant(selectInjectingPerforations)).value();
-        const Vector numProducingPerforations = (wellOps().p2w * ADB::constant(selectProducingPerforations)).value();
+        const Vector& drawdown_value = drawdown.value();
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif // HAVE_OPENMP
         for (int w = 0; w < nw; ++w) {
+            const int perf_begin = wells().well_connpos[w];
+            const int perf_end = wells().well_connpos[w+1];
+            int numInjectingPerforations = 0;
+            for (int perf = perf_begin; perf < perf_end; ++perf) {
+                if (drawdown_value[perf] < 0) {
+                    selectInjectingPerforations[perf] = 1;
+                    ++numInjectingPerforations;
+                } else {
+                    selectProducingPerforations[perf] = 1;
+                }
+            }
+            const int numProducingPerforations = (perf_end - perf_begin) - numInjectingPerforations;
+
+            // Handle cross flow
             if (!wells().allow_cf[w]) {
-                for (int perf = wells().well_connpos[w] ; perf < wells().well_connpos[w+1]; ++perf) {
+                for (int perf = perf_begin; perf < perf_end; ++perf) {
                     // Crossflow is not allowed; reverse flow is prevented.
                     // At least one of the perforation must be open in order to have a meeningful
                     // equation to solve. For the special case where all perforations have reverse flow,
                     // and the target rate is non-zero all of the perforations are keept open.
-                    if (wells().type[w] == INJECTOR && numInjectingPerforations[w] > 0) {
+                    if (wells().type[w] == INJECTOR && numInjectingPerforations > 0) {
                         selectProducingPerforations[perf] = 0.0;
-                    } else if (wells().type[w] == PRODUCER && numProducingPerforations[w] > 0 ){
+                    } else if (wells().type[w] == PRODUCER && numProducingPerforations > 0 ){
                         selectInjectingPerforations[perf] = 0.0;
                     }
                 }
@@ -959,8 +974,8 @@ namespace Opm
         const ADB thp_inj_target = ADB::constant(thp_inj_target_v);
         const ADB thp_prod_target = ADB::constant(thp_prod_target_v);
         const ADB alq = ADB::constant(alq_v);
-        const ADB bhp_from_thp_inj = vfp_properties_->getInj()->bhp(inj_table_id, aqua, liquid, vapour, thp_inj_target);
-        const ADB bhp_from_thp_prod = vfp_properties_->getProd()->bhp(prod_table_id, aqua, liquid, vapour, thp_prod_target, alq);
+        const ADB bhp_from_thp_inj = vfp_properties_->getInj()->bhp(inj_table_id, aqua, liquid, vapour, thp_inj_target, vfp_inj_cache_);
+        const ADB bhp_from_thp_prod = vfp_properties_->getProd()->bhp(prod_table_id, aqua, liquid, vapour, thp_prod_target, alq, vfp_prod_cache_);
 
         //Perform hydrostatic correction to computed targets
         const Vector dp_v = wellhelpers::computeHydrostaticCorrection(wells(), vfp_ref_depth_v, wellPerforationDensities(), gravity_);
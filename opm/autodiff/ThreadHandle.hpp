@@ -24,16 +24,30 @@
 #ifndef OPM_THREADHANDLE_HPP
 #define OPM_THREADHANDLE_HPP
 
-#include <cassert>
-#include <dune/common/exceptions.hh>
-
-#include <thread>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <future>
+#include <memory>
 #include <mutex>
-#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <vector>
 
 namespace Opm
 {
 
+  /// \brief Executor running dispatched objects on one or more worker threads.
+  ///
+  /// Objects are queued in dispatch order and picked up by idle workers.
+  /// With a single worker (the default) objects are run in dispatch order,
+  /// which the output writers rely on. The queue is bounded: when it is
+  /// full, dispatch() blocks until a worker has taken an object, which
+  /// limits the memory held by pending objects. Exceptions thrown by an
+  /// object are passed on through the future returned by dispatch().
   class ThreadHandle
   {
   public:
@@ -47,7 +61,6 @@ namespace Opm
     public:
       virtual ~ObjectInterface() {}
       virtual void run() = 0;
-      virtual bool isEndMarker () const { return false; }
     };
 
     /// \brief ObjectWrapper class
@@ -62,156 +75,190 @@ namespace Opm
       void run() { obj_.run(); }
     };
 
+    /// \brief Queue and timing statistics of a ThreadHandle.
+    struct Statistics
+    {
+      std::size_t dispatched = 0;       //!< number of objects dispatched
+      std::size_t completed = 0;        //!< number of objects run to completion or failure
+      std::size_t failed = 0;           //!< number of objects whose run() threw
+      std::size_t queueDepth = 0;       //!< current number of queued objects
+      std::size_t maxQueueDepth = 0;    //!< largest number of queued objects seen
+      double totalQueueSeconds = 0.0;   //!< summed time objects waited in the queue
+      double maxQueueSeconds = 0.0;     //!< longest time an object waited in the queue
+      double totalRunSeconds = 0.0;     //!< summed time spent in run()
+      double totalBlockedSeconds = 0.0; //!< summed time dispatch() blocked on a full queue
+
+      double averageQueueSeconds() const
+      {
+        return completed > 0 ? totalQueueSeconds / completed : 0.0;
+      }
+    };
+
   protected:
+    typedef std::chrono::steady_clock Clock;
 
-    /// \brief EndObject class
-    /// Empthy object marking thread termination.
-    class EndObject : public ObjectInterface
+    struct Task
     {
-    public:
-      void run () { }
-      bool isEndMarker () const { return true; }
+      std::unique_ptr< ObjectInterface > obj;
+      std::promise< void > done;
+      Clock::time_point queued;
     };
 
-
-    /// \brief The ThreadHandleQueue class
-    /// Queue of objects to be handled by this thread.
-    class ThreadHandleQueue
+    static double seconds( const Clock::duration& d )
     {
-    public:
-      //! constructor creating object that is executed by thread
-      ThreadHandleQueue()
-        : objQueue_(), mutex_()
-      {
-      }
+      return std::chrono::duration< double >( d ).count();
+    }
 
-      ~ThreadHandleQueue()
+    //! worker loop: run tasks until the handle is shut down and the queue is empty
+    void work()
+    {
+      std::unique_lock< std::mutex > lock( mutex_ );
+      for( ;; )
       {
-        // wait until all objects have been written.
-        while( ! objQueue_.empty() )
-        {
-            wait();
+        notEmpty_.wait( lock, [this]() { return stop_ || ! queue_.empty(); } );
+        if( queue_.empty() ) {
+          // stop_ is set and nothing is left to do
+          return;
         }
-      }
-
-      //! insert object into threads queue
-      void push_back( std::unique_ptr< ObjectInterface >&& obj )
-      {
-        // lock mutex to make sure objPtr is not used
-        mutex_.lock();
-        objQueue_.emplace( std::move(obj) );
-        mutex_.unlock();
-      }
 
-      //! do the work until the queue received an end object
-      void run()
-      {
-        // wait until objects have been pushed to the queue
-        while( objQueue_.empty() )
-        {
-          // sleep one second
-          wait();
+        Task task( std::move( queue_.front() ) );
+        queue_.pop_front();
+        ++active_;
+        const Clock::time_point start = Clock::now();
+        const double queueSeconds = seconds( start - task.queued );
+        stats_.queueDepth = queue_.size();
+        stats_.totalQueueSeconds += queueSeconds;
+        stats_.maxQueueSeconds = std::max( stats_.maxQueueSeconds, queueSeconds );
+        lock.unlock();
+        notFull_.notify_one();
+
+        bool failed = false;
+        try {
+          task.obj->run();
+          task.done.set_value();
         }
-
-        {
-            // lock mutex for access to objQueue_
-            mutex_.lock();
-
-            // get next object from queue
-            std::unique_ptr< ObjectInterface > obj( objQueue_.front().release() );
-            // remove object from queue
-            objQueue_.pop();
-
-            // unlock mutex for access to objQueue_
-            mutex_.unlock();
-
-            // if object is end marker terminate thread
-            if( obj->isEndMarker() ){
-                if( ! objQueue_.empty() ) {
-                    throw std::logic_error("ThreadHandleQueue: not all queued objects were executed");
-                }
-                return;
-            }
-
-            // execute object action
-            obj->run();
+        catch( ... ) {
+          failed = true;
+          task.done.set_exception( std::current_exception() );
+        }
+        // release the object's resources outside the lock
+        task.obj.reset();
+        const double runSeconds = seconds( Clock::now() - start );
+
+        lock.lock();
+        --active_;
+        ++stats_.completed;
+        stats_.failed += failed ? 1 : 0;
+        stats_.totalRunSeconds += runSeconds;
+        if( queue_.empty() && active_ == 0 ) {
+          idle_.notify_all();
         }
-
-        // keep thread running
-        run();
-      }
-
-    protected:
-      std::queue< std::unique_ptr< ObjectInterface > > objQueue_;
-      std::mutex  mutex_;
-
-      // no copying
-      ThreadHandleQueue( const ThreadHandleQueue& ) = delete;
-
-      // wait duration of 10 milli seconds
-      void wait() const
-      {
-          std::this_thread::sleep_for( std::chrono::milliseconds(10) );
       }
-    }; // end ThreadHandleQueue
+    }
 
-    ////////////////////////////////////////////////////
-    //  end ThreadHandleQueue
-    ////////////////////////////////////////////////////
+    std::deque< Task > queue_;
+    const std::size_t maxQueueSize_;
+    std::size_t active_;
+    bool stop_;
+    Statistics stats_;
 
-    // start the thread by calling method run
-    static void startThread( ThreadHandleQueue* obj )
-    {
-       obj->run();
-    }
+    mutable std::mutex mutex_;
+    std::condition_variable notEmpty_;
+    std::condition_variable notFull_;
+    mutable std::condition_variable idle_;
 
-    ThreadHandleQueue threadObjectQueue_;
-    std::unique_ptr< std::thread > thread_;
+    std::vector< std::thread > threads_;
 
   private:
     // prohibit copying
     ThreadHandle( const ThreadHandle& ) = delete;
+    ThreadHandle& operator=( const ThreadHandle& ) = delete;
 
   public:
     //! constructor creating ThreadHandle
-    //! \param isIORank  if true thread is created
-    ThreadHandle( const bool createThread )
-      : threadObjectQueue_(),
-        thread_()
+    //! \param createThread  if true the worker threads are created (i.e. on the I/O rank)
+    //! \param numThreads    number of worker threads, objects only run in dispatch order if 1
+    //! \param maxQueueSize  number of queued objects before dispatch() blocks, 0 means unbounded
+    explicit ThreadHandle( const bool createThread,
+                           const int numThreads = 1,
+                           const std::size_t maxQueueSize = 4 )
+      : queue_(),
+        maxQueueSize_( maxQueueSize ),
+        active_( 0 ),
+        stop_( false ),
+        stats_(),
+        threads_()
     {
         if( createThread )
         {
-           thread_.reset( new std::thread( startThread, &threadObjectQueue_ ) );
-           // detach thread into nirvana
-           thread_->detach();
+            const int n = std::max( numThreads, 1 );
+            threads_.reserve( n );
+            for( int i = 0; i < n; ++i ) {
+                threads_.emplace_back( &ThreadHandle::work, this );
+            }
         }
     } // end constructor
 
-    //! dispatch object to queue of separate thread
+    //! dispatch object to the queue of the worker threads
+    //! \return future becoming ready when the object's run() has returned
     template <class Object>
-    void dispatch( Object&& obj )
+    std::future< void > dispatch( Object&& obj )
     {
-        if( thread_ )
+        if( threads_.empty() )
         {
-            typedef ObjectWrapper< Object >  ObjectPointer;
-            ObjectInterface* objPtr = new ObjectPointer( std::move(obj) );
-
-            // add object to queue of objects
-            threadObjectQueue_.push_back( std::unique_ptr< ObjectInterface > (objPtr) );
+            throw std::logic_error("ThreadHandle::dispatch called without thread being initialized (i.e. on non-ioRank)");
         }
-        else
+
+        Task task;
+        task.obj.reset( new ObjectWrapper< Object >( std::move(obj) ) );
+        std::future< void > result = task.done.get_future();
+
         {
-            throw std::logic_error("ThreadHandle::dispatch called without thread being initialized (i.e. on non-ioRank)");
+            std::unique_lock< std::mutex > lock( mutex_ );
+            if( maxQueueSize_ > 0 && queue_.size() >= maxQueueSize_ )
+            {
+                // back-pressure: wait for a worker to take an object
+                const Clock::time_point start = Clock::now();
+                notFull_.wait( lock, [this]() { return queue_.size() < maxQueueSize_; } );
+                stats_.totalBlockedSeconds += seconds( Clock::now() - start );
+            }
+            task.queued = Clock::now();
+            queue_.emplace_back( std::move( task ) );
+            ++stats_.dispatched;
+            stats_.queueDepth = queue_.size();
+            stats_.maxQueueDepth = std::max( stats_.maxQueueDepth, queue_.size() );
         }
+        notEmpty_.notify_one();
+        return result;
     }
 
-    //! destructor terminating the thread
+    //! block until all dispatched objects have been run
+    void waitForCompletion() const
+    {
+        std::unique_lock< std::mutex > lock( mutex_ );
+        idle_.wait( lock, [this]() { return queue_.empty() && active_ == 0; } );
+    }
+
+    //! number of worker threads
+    int numThreads() const { return static_cast< int >( threads_.size() ); }
+
+    //! snapshot of the queue and timing statistics
+    Statistics statistics() const
+    {
+        std::lock_guard< std::mutex > lock( mutex_ );
+        return stats_;
+    }
+
+    //! destructor running all queued objects and joining the worker threads
     ~ThreadHandle()
     {
-        if( thread_ )
         {
-            // dispatch end object which will terminate the thread
-            threadObjectQueue_.push_back( std::unique_ptr< ObjectInterface > (new EndObject()) ) ;
+            std::lock_guard< std::mutex > lock( mutex_ );
+            stop_ = true;
+        }
+        notEmpty_.notify_all();
+        for( auto& thread : threads_ ) {
+            thread.join();
         }
     }
   };
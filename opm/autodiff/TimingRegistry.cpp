@@ -0,0 +1,331 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#include <opm/autodiff/TimingRegistry.hpp>
+
+#include <algorithm>
+#include <iomanip>
+#include <set>
+
+namespace Opm
+{
+
+    namespace
+    {
+        // Open timers of the calling thread, innermost last.
+        struct ThreadTimerStack
+        {
+            unsigned generation = 0;
+            std::vector<int> open;
+        };
+
+        ThreadTimerStack& threadTimerStack()
+        {
+            thread_local ThreadTimerStack stack;
+            return stack;
+        }
+
+        std::string jsonString(const std::string& s)
+        {
+            std::string result = "\"";
+            for (const char c : s) {
+                if (c == '"' || c == '\\') {
+                    result += '\\';
+                }
+                result += c;
+            }
+            return result + "\"";
+        }
+
+        void writeJsonTimers(std::ostream& os,
+                             const std::vector<std::string>& paths,
+                             const std::vector<std::pair<int, TimingRegistry::Stats>>& timers,
+                             const std::string& indent)
+        {
+            os << "[";
+            for (std::size_t i = 0; i < timers.size(); ++i) {
+                const TimingRegistry::Stats& s = timers[i].second;
+                os << (i == 0 ? "\n" : ",\n") << indent
+                   << "{ \"path\": " << jsonString(paths[timers[i].first])
+                   << ", \"calls\": " << s.calls
+                   << ", \"seconds\": " << s.seconds
+                   << ", \"min\": " << s.minSeconds
+                   << ", \"max\": " << s.maxSeconds << " }";
+            }
+            os << (timers.empty() ? "]" : "\n" + indent.substr(0, indent.size() - 2) + "]");
+        }
+    } // anonymous namespace
+
+
+
+    void TimingRegistry::Stats::add(const double s)
+    {
+        minSeconds = (calls == 0) ? s : std::min(minSeconds, s);
+        maxSeconds = (calls == 0) ? s : std::max(maxSeconds, s);
+        seconds += s;
+        ++calls;
+    }
+
+
+
+    TimingRegistry::Stats& TimingRegistry::Stats::operator+=(const Stats& other)
+    {
+        if (other.calls > 0) {
+            minSeconds = (calls == 0) ? other.minSeconds : std::min(minSeconds, other.minSeconds);
+            maxSeconds = (calls == 0) ? other.maxSeconds : std::max(maxSeconds, other.maxSeconds);
+            seconds += other.seconds;
+            calls += other.calls;
+        }
+        return *this;
+    }
+
+
+
+    TimingRegistry::TimingRegistry()
+        : enabled_(false),
+          step_(0),
+          generation_(1)
+    {
+    }
+
+
+
+    TimingRegistry& TimingRegistry::instance()
+    {
+        static TimingRegistry registry;
+        return registry;
+    }
+
+
+
+    void TimingRegistry::setReportStep(const int step)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        step_ = step;
+    }
+
+
+
+    int TimingRegistry::enter(const char* name)
+    {
+        ThreadTimerStack& stack = threadTimerStack();
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stack.generation != generation_) {
+            stack.open.clear();
+            stack.generation = generation_;
+        }
+        const int parent = stack.open.empty() ? -1 : stack.open.back();
+        const auto key = std::make_pair(parent, std::string(name));
+        auto it = index_.find(key);
+        if (it == index_.end()) {
+            Node node;
+            node.name = key.second;
+            node.parent = parent;
+            nodes_.push_back(node);
+            it = index_.emplace(key, static_cast<int>(nodes_.size()) - 1).first;
+        }
+        const int id = it->second;
+        std::vector<std::thread::id>& threads = nodes_[id].threads;
+        const std::thread::id self = std::this_thread::get_id();
+        if (std::find(threads.begin(), threads.end(), self) == threads.end()) {
+            threads.push_back(self);
+        }
+        stack.open.push_back(id);
+        return id;
+    }
+
+
+
+    void TimingRegistry::leave(const int id, const double seconds)
+    {
+        ThreadTimerStack& stack = threadTimerStack();
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stack.generation != generation_) {
+            // The registry was reset while this timer was open.
+            return;
+        }
+        const auto pos = std::find(stack.open.rbegin(), stack.open.rend(), id);
+        if (pos != stack.open.rend()) {
+            stack.open.erase(std::next(pos).base(), stack.open.end());
+        }
+        Node& node = nodes_[id];
+        node.total.add(seconds);
+        node.steps[step_].add(seconds);
+    }
+
+
+
+    void TimingRegistry::reset()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        nodes_.clear();
+        index_.clear();
+        step_ = 0;
+        ++generation_;
+    }
+
+
+
+    std::vector<std::string> TimingRegistry::pathsLocked() const
+    {
+        // Parents are always created before their children.
+        std::vector<std::string> result(nodes_.size());
+        for (std::size_t i = 0; i < nodes_.size(); ++i) {
+            const int parent = nodes_[i].parent;
+            result[i] = (parent < 0) ? nodes_[i].name : result[parent] + "/" + nodes_[i].name;
+        }
+        return result;
+    }
+
+
+
+    std::vector<std::string> TimingRegistry::paths() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return pathsLocked();
+    }
+
+
+
+    TimingRegistry::Stats TimingRegistry::total(const std::string& path) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const std::vector<std::string> all = pathsLocked();
+        const auto it = std::find(all.begin(), all.end(), path);
+        return (it == all.end()) ? Stats() : nodes_[it - all.begin()].total;
+    }
+
+
+
+    void TimingRegistry::writeJson(std::ostream& os) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const std::vector<std::string> paths = pathsLocked();
+
+        std::vector<std::pair<int, Stats>> totals;
+        std::set<int> steps;
+        for (std::size_t i = 0; i < nodes_.size(); ++i) {
+            totals.emplace_back(static_cast<int>(i), nodes_[i].total);
+            for (const auto& step : nodes_[i].steps) {
+                steps.insert(step.first);
+            }
+        }
+
+        os << "{\n  \"timers\": [";
+        for (std::size_t i = 0; i < nodes_.size(); ++i) {
+            os << (i == 0 ? "\n" : ",\n")
+               << "    { \"path\": " << jsonString(paths[i])
+               << ", \"parent\": " << (nodes_[i].parent < 0 ? std::string("null") : jsonString(paths[nodes_[i].parent]))
+               << ", \"threads\": " << nodes_[i].threads.size() << " }";
+        }
+        os << (nodes_.empty() ? "],\n" : "\n  ],\n");
+
+        os << "  \"total\": ";
+        writeJsonTimers(os, paths, totals, "    ");
+        os << ",\n  \"steps\": [";
+        bool first = true;
+        for (const int step : steps) {
+            std::vector<std::pair<int, Stats>> timers;
+            for (std::size_t i = 0; i < nodes_.size(); ++i) {
+                const auto it = nodes_[i].steps.find(step);
+                if (it != nodes_[i].steps.end()) {
+                    timers.emplace_back(static_cast<int>(i), it->second);
+                }
+            }
+            os << (first ? "\n" : ",\n") << "    { \"step\": " << step << ", \"timers\": ";
+            writeJsonTimers(os, paths, timers, "        ");
+            os << " }";
+            first = false;
+        }
+        os << (steps.empty() ? "]\n}\n" : "\n  ]\n}\n");
+    }
+
+
+
+    void TimingRegistry::writeCsv(std::ostream& os) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const std::vector<std::string> paths = pathsLocked();
+
+        os << "step,path,calls,seconds,min,max,threads\n";
+        const auto row = [&](const std::string& step, const std::size_t i, const Stats& s) {
+            os << step << ',' << paths[i] << ',' << s.calls << ',' << s.seconds << ','
+               << s.minSeconds << ',' << s.maxSeconds << ',' << nodes_[i].threads.size() << '\n';
+        };
+        std::set<int> steps;
+        for (const Node& node : nodes_) {
+            for (const auto& step : node.steps) {
+                steps.insert(step.first);
+            }
+        }
+        for (const int step : steps) {
+            for (std::size_t i = 0; i < nodes_.size(); ++i) {
+                const auto it = nodes_[i].steps.find(step);
+                if (it != nodes_[i].steps.end()) {
+                    row(std::to_string(step), i, it->second);
+                }
+            }
+        }
+        for (std::size_t i = 0; i < nodes_.size(); ++i) {
+            row("total", i, nodes_[i].total);
+        }
+    }
+
+
+
+    void TimingRegistry::print(std::ostream& os) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        std::vector<std::vector<int>> children(nodes_.size() + 1);
+        for (std::size_t i = 0; i < nodes_.size(); ++i) {
+            children[nodes_[i].parent + 1].push_back(static_cast<int>(i));
+        }
+
+        os << std::setw(44) << std::left << "Timer" << std::right
+           << std::setw(10) << "calls" << std::setw(14) << "seconds"
+           << std::setw(14) << "self" << '\n';
+        // Depth-first traversal; children of node i are children[i + 1].
+        std::vector<std::pair<int, int>> pending;
+        for (auto it = children[0].rbegin(); it != children[0].rend(); ++it) {
+            pending.emplace_back(*it, 0);
+        }
+        while (!pending.empty()) {
+            const int id = pending.back().first;
+            const int depth = pending.back().second;
+            pending.pop_back();
+
+            const Node& node = nodes_[id];
+            double self = node.total.seconds;
+            for (const int child : children[id + 1]) {
+                self -= nodes_[child].total.seconds;
+            }
+            os << std::setw(44) << std::left << (std::string(2 * depth, ' ') + node.name) << std::right
+               << std::setw(10) << node.total.calls
+               << std::setw(14) << std::fixed << std::setprecision(3) << node.total.seconds
+               << std::setw(14) << std::max(self, 0.0) << '\n';
+            os.unsetf(std::ios_base::floatfield);
+
+            for (auto it = children[id + 1].rbegin(); it != children[id + 1].rend(); ++it) {
+                pending.emplace_back(*it, depth + 1);
+            }
+        }
+    }
+
+} // namespace Opm
@@ -0,0 +1,159 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_TIMINGREGISTRY_HEADER_INCLUDED
+#define OPM_TIMINGREGISTRY_HEADER_INCLUDED
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace Opm
+{
+
+    /// Process-wide registry of hierarchical timers.
+    ///
+    /// Timed regions are opened with ScopedTiming. A region opened while
+    /// another region is open on the same thread becomes its child, so
+    /// the timers form a tree per thread of execution, e.g.
+    /// "assemble/computeAccum". Each timer counts calls and inclusive
+    /// seconds, both in total and per report step, and records how many
+    /// distinct threads have entered it.
+    ///
+    /// The registry is disabled by default, in which case ScopedTiming
+    /// only reads an atomic flag.
+    class TimingRegistry
+    {
+    public:
+        /// Accumulated timings of one timer.
+        struct Stats
+        {
+            long calls = 0;
+            double seconds = 0.0;
+            double minSeconds = 0.0;
+            double maxSeconds = 0.0;
+
+            void add(double s);
+            Stats& operator+=(const Stats& other);
+        };
+
+        /// The registry used by ScopedTiming.
+        static TimingRegistry& instance();
+
+        void setEnabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+        bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+        /// Attribute subsequent timings to the given report step.
+        void setReportStep(int step);
+
+        /// Open the timer called name below the innermost open timer of
+        /// the calling thread and return its id.
+        int enter(const char* name);
+
+        /// Close the timer opened by enter(), adding the elapsed seconds.
+        void leave(int id, double seconds);
+
+        /// Remove all timers and timings.
+        void reset();
+
+        /// Full slash-separated path of each timer, indexed by id.
+        std::vector<std::string> paths() const;
+
+        /// Total timings of the timer with the given path, zero if it does not exist.
+        Stats total(const std::string& path) const;
+
+        /// Write all timers as JSON: totals and per-report-step timings.
+        void writeJson(std::ostream& os) const;
+
+        /// Write all timers as CSV with one row per report step and timer,
+        /// plus rows with step "total".
+        void writeCsv(std::ostream& os) const;
+
+        /// Write an indented, human-readable tree of the total timings.
+        void print(std::ostream& os) const;
+
+    private:
+        struct Node
+        {
+            std::string name;
+            int parent;
+            Stats total;
+            std::map<int, Stats> steps;
+            std::vector<std::thread::id> threads;
+        };
+
+        TimingRegistry();
+
+        std::vector<std::string> pathsLocked() const;
+
+        std::atomic<bool> enabled_;
+        mutable std::mutex mutex_;
+        std::vector<Node> nodes_;
+        std::map<std::pair<int, std::string>, int> index_;
+        int step_;
+        // Incremented by reset() so that stale per-thread stacks are discarded.
+        unsigned generation_;
+    };
+
+
+
+    /// Times the enclosing scope in TimingRegistry::instance().
+    ///
+    /// \code
+    /// {
+    ///     ScopedTiming timing("assemble");
+    ///     ...
+    /// }
+    /// \endcode
+    class ScopedTiming
+    {
+    public:
+        explicit ScopedTiming(const char* name)
+            : id_(-1)
+        {
+            TimingRegistry& registry = TimingRegistry::instance();
+            if (registry.enabled()) {
+                id_ = registry.enter(name);
+                start_ = std::chrono::steady_clock::now();
+            }
+        }
+
+        ~ScopedTiming()
+        {
+            if (id_ >= 0) {
+                const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_;
+                TimingRegistry::instance().leave(id_, elapsed.count());
+            }
+        }
+
+    private:
+        ScopedTiming(const ScopedTiming&) = delete;
+        ScopedTiming& operator=(const ScopedTiming&) = delete;
+
+        int id_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_TIMINGREGISTRY_HEADER_INCLUDED
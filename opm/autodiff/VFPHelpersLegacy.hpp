@@ -26,6 +26,10 @@
 #include <opm/parser/eclipse/EclipseState/Schedule/VFPInjTable.hpp>
 #include <opm/autodiff/AutoDiffHelpers.hpp>
 
+#include <array>
+#include <cmath>
+#include <vector>
+
 /**
  * This file contains a set of helper functions used by VFPProd / VFPInj.
  */
@@ -113,121 +117,179 @@ inline std::vector<int> commonBlockPattern(
 
 
 /**
- * Returns the actual ADB for the type of FLO/GFR/WFR type
+ * Value of one of the FLO/WFR/GFR variables for a single well, with its
+ * partial derivatives with respect to the aqua, liquid and vapour rates.
+ * Used to evaluate the VFP tables for many wells without building ADB
+ * temporaries for each variable type.
  */
-template <typename TYPE>
-ADB getValue(
-        const ADB& aqua,
-        const ADB& liquid,
-        const ADB& vapour, TYPE type);
-
-template <>
-inline
-ADB getValue(
-        const ADB& aqua,
-        const ADB& liquid,
-        const ADB& vapour,
-        VFPProdTable::FLO_TYPE type) {
-    return detail::getFlo(aqua, liquid, vapour, type);
+struct VFPRateVariable {
+    double value;
+    double daqua;
+    double dliquid;
+    double dvapour;
+};
+
+inline VFPRateVariable operator+(const VFPRateVariable& a, const VFPRateVariable& b) {
+    return { a.value + b.value, a.daqua + b.daqua, a.dliquid + b.dliquid, a.dvapour + b.dvapour };
 }
 
-template <>
-inline
-ADB getValue(
-        const ADB& aqua,
-        const ADB& liquid,
-        const ADB& vapour,
-        VFPProdTable::WFR_TYPE type) {
-    return detail::getWFR(aqua, liquid, vapour, type);
+/**
+ * Quotient n/d, set to zero (value and derivatives) if NaN or INF,
+ * as for the ADB variables (see zeroIfNanInf()).
+ */
+inline VFPRateVariable quotient(const VFPRateVariable& n, const VFPRateVariable& d) {
+    const double value = n.value / d.value;
+    if (!std::isfinite(value)) {
+        return { 0.0, 0.0, 0.0, 0.0 };
+    }
+    return { value,
+             (n.daqua - value*d.daqua) / d.value,
+             (n.dliquid - value*d.dliquid) / d.value,
+             (n.dvapour - value*d.dvapour) / d.value };
 }
 
-template <>
-inline
-ADB getValue(
-        const ADB& aqua,
-        const ADB& liquid,
-        const ADB& vapour,
-        VFPProdTable::GFR_TYPE type) {
-    return detail::getGFR(aqua, liquid, vapour, type);
+/**
+ * Computes the FLO/WFR/GFR variable of the given type, with derivatives.
+ */
+inline VFPRateVariable getRateVariable(const double aqua, const double liquid, const double vapour,
+                                       const VFPProdTable::FLO_TYPE type) {
+    const VFPRateVariable w = { aqua, 1.0, 0.0, 0.0 };
+    const VFPRateVariable o = { liquid, 0.0, 1.0, 0.0 };
+    const VFPRateVariable g = { vapour, 0.0, 0.0, 1.0 };
+    switch (type) {
+        case VFPProdTable::FLO_OIL:
+            return o;
+        case VFPProdTable::FLO_LIQ:
+            return w + o;
+        case VFPProdTable::FLO_GAS:
+            return g;
+        case VFPProdTable::FLO_INVALID: //Intentional fall-through
+        default:
+            OPM_THROW(std::logic_error, "Invalid FLO_TYPE: '" << type << "'");
+    }
 }
 
-template <>
-inline
-ADB getValue(
-        const ADB& aqua,
-        const ADB& liquid,
-        const ADB& vapour,
-        VFPInjTable::FLO_TYPE type) {
-    return detail::getFlo(aqua, liquid, vapour, type);
+inline VFPRateVariable getRateVariable(const double aqua, const double liquid, const double vapour,
+                                       const VFPProdTable::WFR_TYPE type) {
+    const VFPRateVariable w = { aqua, 1.0, 0.0, 0.0 };
+    const VFPRateVariable o = { liquid, 0.0, 1.0, 0.0 };
+    const VFPRateVariable g = { vapour, 0.0, 0.0, 1.0 };
+    switch (type) {
+        case VFPProdTable::WFR_WOR:
+            return quotient(w, o);
+        case VFPProdTable::WFR_WCT:
+            return quotient(w, w + o);
+        case VFPProdTable::WFR_WGR:
+            return quotient(w, g);
+        case VFPProdTable::WFR_INVALID: //Intentional fall-through
+        default:
+            OPM_THROW(std::logic_error, "Invalid WFR_TYPE: '" << type << "'");
+    }
 }
 
+inline VFPRateVariable getRateVariable(const double aqua, const double liquid, const double vapour,
+                                       const VFPProdTable::GFR_TYPE type) {
+    const VFPRateVariable w = { aqua, 1.0, 0.0, 0.0 };
+    const VFPRateVariable o = { liquid, 0.0, 1.0, 0.0 };
+    const VFPRateVariable g = { vapour, 0.0, 0.0, 1.0 };
+    switch (type) {
+        case VFPProdTable::GFR_GOR:
+            return quotient(g, o);
+        case VFPProdTable::GFR_GLR:
+            return quotient(g, o + w);
+        case VFPProdTable::GFR_OGR:
+            return quotient(o, g);
+        case VFPProdTable::GFR_INVALID: //Intentional fall-through
+        default:
+            OPM_THROW(std::logic_error, "Invalid GFR_TYPE: '" << type << "'");
+    }
+}
+
+inline VFPRateVariable getRateVariable(const double aqua, const double liquid, const double vapour,
+                                       const VFPInjTable::FLO_TYPE type) {
+    switch (type) {
+        case VFPInjTable::FLO_OIL:
+            return { liquid, 0.0, 1.0, 0.0 };
+        case VFPInjTable::FLO_WAT:
+            return { aqua, 1.0, 0.0, 0.0 };
+        case VFPInjTable::FLO_GAS:
+            return { vapour, 0.0, 0.0, 1.0 };
+        case VFPInjTable::FLO_INVALID: //Intentional fall-through
+        default:
+            OPM_THROW(std::logic_error, "Invalid FLO_TYPE: '" << type << "'");
+    }
+}
+
+
 /**
- * Given m wells and n types of VFP variables (e.g., FLO = {FLO_OIL, FLO_LIQ}
- * this function combines the n types of ADB objects, so that each of the
- * m wells gets the right ADB.
- * @param TYPE Type of variable to return, e.g., FLO_TYPE, WFR_TYPE, GFR_TYPE
- * @param TABLE Type of table to use, e.g., VFPInjTable, VFPProdTable.
+ * As findInterpData(), but starting from the interval given by hint
+ * (the index of its first element), which is updated to the interval
+ * found. When the value is in the hinted interval or one of its
+ * neighbours, which is the normal case between two Newton iterations,
+ * the lookup is constant time instead of a search through the axis.
  */
-template <typename TYPE, typename TABLE>
-ADB combineADBVars(const std::vector<const TABLE*>& well_tables,
-        const ADB& aqua,
-        const ADB& liquid,
-        const ADB& vapour) {
-
-    const int num_wells = static_cast<int>(well_tables.size());
-    assert(aqua.size() == num_wells);
-    assert(liquid.size() == num_wells);
-    assert(vapour.size() == num_wells);
-
-    //Caching variable for flo/wfr/gfr
-    std::map<TYPE, ADB> map;
-
-    //Indexing variable used when combining the different ADB types
-    std::map<TYPE, std::vector<int> > elems;
-
-    //Compute all of the different ADB types,
-    //and record which wells use which types
-    for (int i=0; i<num_wells; ++i) {
-        const TABLE* table = well_tables[i];
-
-        //Only do something if this well is under THP control
-        if (table != NULL) {
-            TYPE type = getType<TYPE>(table);
-
-            //"Caching" of flo_type etc: Only calculate used types
-            //Create type if it does not exist
-            if (map.find(type) == map.end()) {
-                map.insert(std::pair<TYPE, ADB>(
-                        type,
-                        detail::getValue<TYPE>(aqua, liquid, vapour, type)
-                        ));
+inline InterpData findInterpData(const double value, const std::vector<double>& values, int& hint) {
+    const int nvalues = values.size();
+    if (nvalues > 1) {
+        // Same convention as the search in findInterpData(): the interval
+        // is (i-1, i) for the first i with values[i] >= value.
+        for (const int lo : { hint, hint + 1, hint - 1 }) {
+            if (lo >= 0 && lo + 1 < nvalues
+                && values[lo] < value && value <= values[lo + 1]) {
+                hint = lo;
+                InterpData retval;
+                retval.ind_[0] = lo;
+                retval.ind_[1] = lo + 1;
+                retval.inv_dist_ = 1.0 / (values[lo + 1] - values[lo]);
+                retval.factor_ = (value - values[lo]) * retval.inv_dist_;
+                return retval;
             }
-
-            //Add the index for assembly later in gather_vars
-            elems[type].push_back(i);
         }
     }
+    // Outside the axis, on its first value, or moved far: full search.
+    const InterpData retval = findInterpData(value, values);
+    hint = retval.ind_[0];
+    return retval;
+}
 
-    //Loop over all types of ADB variables, and combine them
-    //so that each well gets the proper variable
-    ADB retval = ADB::constant(ADB::V::Zero(num_wells));
-    for (const auto& entry : elems) {
-        const auto& key = entry.first;
-        const auto& value = entry.second;
-
-        //Get the ADB for this type of variable
-        assert(map.find(key) != map.end());
-        const ADB& values = map.find(key)->second;
-
-        //Get indices to all elements that should use this ADB
-        const std::vector<int>& current = value;
 
-        //Add these elements to retval
-        retval = retval + superset(subset(values, current), current, values.size());
+/**
+ * Per-well data kept between evaluations of the VFP tables for a set of
+ * wells: the table of each well, looked up once as long as the table
+ * ids do not change (i.e. once per report step), and the interval of
+ * each axis containing the well's last evaluation point, used as a
+ * hint for the next lookup.
+ * @param TABLE Type of table, VFPInjTable or VFPProdTable.
+ * @param N Number of axes of the table.
+ */
+template <typename TABLE, int N>
+struct VFPWellCache {
+    std::vector<int> table_id;
+    std::vector<const TABLE*> tables;
+    std::vector<std::array<int, N> > hints;
+
+    /**
+     * Looks up the tables if table_ids differs from the cached ids.
+     * Wells with a table id less than min_table_id have no table.
+     */
+    template <typename TABLES>
+    void update(const TABLES& all_tables, const std::vector<int>& table_ids, const int min_table_id) {
+        if (table_ids == table_id) {
+            return;
+        }
+        const int nw = table_ids.size();
+        tables.assign(nw, nullptr);
+        for (int i = 0; i < nw; ++i) {
+            if (table_ids[i] >= min_table_id) {
+                tables[i] = getTable(all_tables, table_ids[i]);
+            }
+        }
+        std::array<int, N> zero;
+        zero.fill(0);
+        hints.assign(nw, zero);
+        table_id = table_ids;
     }
-
-    return retval;
-}
+};
 
 } // namespace detail
 
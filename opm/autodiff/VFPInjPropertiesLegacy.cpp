@@ -57,6 +57,17 @@ VFPInjPropertiesLegacy::ADB VFPInjPropertiesLegacy::bhp(const std::vector<int>&
                                                         const ADB& liquid,
                                                         const ADB& vapour,
                                                         const ADB& thp_arg) const {
+    WellCache cache;
+    return bhp(table_id, aqua, liquid, vapour, thp_arg, cache);
+}
+
+
+VFPInjPropertiesLegacy::ADB VFPInjPropertiesLegacy::bhp(const std::vector<int>& table_id,
+                                                        const ADB& aqua,
+                                                        const ADB& liquid,
+                                                        const ADB& vapour,
+                                                        const ADB& thp_arg,
+                                                        WellCache& well_cache) const {
     const int nw = thp_arg.size();
 
     std::vector<int> block_pattern = detail::commonBlockPattern(aqua, liquid, vapour, thp_arg);
@@ -70,32 +81,34 @@ VFPInjPropertiesLegacy::ADB VFPInjPropertiesLegacy::bhp(const std::vector<int>&
     //Allocate data for bhp's and partial derivatives
     ADB::V value = ADB::V::Zero(nw);
     ADB::V dthp = ADB::V::Zero(nw);
-    ADB::V dflo = ADB::V::Zero(nw);
+    ADB::V daqua = ADB::V::Zero(nw);
+    ADB::V dliquid = ADB::V::Zero(nw);
+    ADB::V dvapour = ADB::V::Zero(nw);
 
-    //Get the table for each well
-    std::vector<const VFPInjTable*> well_tables(nw, nullptr);
-    for (int i=0; i<nw; ++i) {
-        if (table_id[i] > 0) {
-            well_tables[i] = detail::getTable(m_tables, table_id[i]);
-        }
-    }
-
-    //Get the right FLO variable for each well as a single ADB
-    const ADB flo = detail::combineADBVars<VFPInjTable::FLO_TYPE>(well_tables, aqua, liquid, vapour);
+    //Get the table for each well (only when the table ids change)
+    well_cache.update(m_tables, table_id, 1);
 
-    //Compute the BHP for each well independently
+    //Compute the BHP for each well independently, with the derivatives
+    //of FLO computed directly instead of through ADB temporaries
     for (int i=0; i<nw; ++i) {
-        const VFPInjTable* table = well_tables[i];
+        const VFPInjTable* table = well_cache.tables[i];
         if (table != nullptr) {
-            //First, find the values to interpolate between
-            auto flo_i = detail::findInterpData(flo.value()[i], table->getFloAxis());
-            auto thp_i = detail::findInterpData(thp_arg.value()[i], table->getTHPAxis());
+            const detail::VFPRateVariable flo = detail::getRateVariable(aqua.value()[i], liquid.value()[i],
+                                                                        vapour.value()[i], table->getFloType());
+
+            //First, find the values to interpolate between, starting
+            //from the intervals of the previous evaluation of this well
+            std::array<int, 2>& hint = well_cache.hints[i];
+            auto flo_i = detail::findInterpData(flo.value, table->getFloAxis(), hint[0]);
+            auto thp_i = detail::findInterpData(thp_arg.value()[i], table->getTHPAxis(), hint[1]);
 
             detail::VFPEvaluation bhp_val = detail::interpolate(table->getTable(), flo_i, thp_i);
 
             value[i] = bhp_val.value;
             dthp[i] = bhp_val.dthp;
-            dflo[i] = bhp_val.dflo;
+            daqua[i] = bhp_val.dflo*flo.daqua;
+            dliquid[i] = bhp_val.dflo*flo.dliquid;
+            dvapour[i] = bhp_val.dflo*flo.dvapour;
         }
         else {
             value[i] = -1e100; //Signal that this value has not been calculated properly, due to "missing" table
@@ -104,7 +117,9 @@ VFPInjPropertiesLegacy::ADB VFPInjPropertiesLegacy::bhp(const std::vector<int>&
 
     //Create diagonal matrices from ADB::Vs
     ADB::M dthp_diag(dthp.matrix().asDiagonal());
-    ADB::M dflo_diag(dflo.matrix().asDiagonal());
+    ADB::M daqua_diag(daqua.matrix().asDiagonal());
+    ADB::M dliquid_diag(dliquid.matrix().asDiagonal());
+    ADB::M dvapour_diag(dvapour.matrix().asDiagonal());
 
     //Calculate the Jacobians
     const int num_blocks = block_pattern.size();
@@ -117,8 +132,14 @@ VFPInjPropertiesLegacy::ADB VFPInjPropertiesLegacy::bhp(const std::vector<int>&
         if (!thp_arg.derivative().empty()) {
             jacs[block] += dthp_diag * thp_arg.derivative()[block];
         }
-        if (!flo.derivative().empty()) {
-            jacs[block] += dflo_diag * flo.derivative()[block];
+        if (!aqua.derivative().empty()) {
+            jacs[block] += daqua_diag * aqua.derivative()[block];
+        }
+        if (!liquid.derivative().empty()) {
+            jacs[block] += dliquid_diag * liquid.derivative()[block];
+        }
+        if (!vapour.derivative().empty()) {
+            jacs[block] += dvapour_diag * vapour.derivative()[block];
         }
     }
 
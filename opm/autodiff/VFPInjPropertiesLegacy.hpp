@@ -37,6 +37,11 @@ class VFPInjPropertiesLegacy : public VFPInjProperties {
 public:
     typedef AutoDiffBlock<double> ADB;
 
+    /// Tables and last interpolation intervals of a set of wells, see
+    /// detail::VFPWellCache. Owned by the caller, so that evaluations
+    /// of different callers or threads do not share state.
+    typedef detail::VFPWellCache<VFPInjTable, 2> WellCache;
+
     /**
      * Empty constructor
      */
@@ -94,6 +99,19 @@ public:
             const ADB& liquid,
             const ADB& vapour,
             const ADB& thp) const;
+
+    /**
+     * As above, with the tables of the wells and the starting points of the
+     * interpolation searches taken from and stored in cache. Repeated calls
+     * with the same wells, e.g. in consecutive Newton iterations, then skip
+     * the table lookups.
+     */
+    ADB bhp(const std::vector<int>& table_id,
+            const ADB& aqua,
+            const ADB& liquid,
+            const ADB& vapour,
+            const ADB& thp,
+            WellCache& cache) const;
 };
 
 
@@ -57,6 +57,18 @@ VFPProdPropertiesLegacy::ADB VFPProdPropertiesLegacy::bhp(const std::vector<int>
                                                           const ADB& vapour,
                                                           const ADB& thp_arg,
                                                           const ADB& alq) const {
+    WellCache cache;
+    return bhp(table_id, aqua, liquid, vapour, thp_arg, alq, cache);
+}
+
+
+VFPProdPropertiesLegacy::ADB VFPProdPropertiesLegacy::bhp(const std::vector<int>& table_id,
+                                                          const ADB& aqua,
+                                                          const ADB& liquid,
+                                                          const ADB& vapour,
+                                                          const ADB& thp_arg,
+                                                          const ADB& alq,
+                                                          WellCache& well_cache) const {
     const int nw = thp_arg.size();
 
     std::vector<int> block_pattern = detail::commonBlockPattern(aqua, liquid, vapour, thp_arg, alq);
@@ -71,44 +83,44 @@ VFPProdPropertiesLegacy::ADB VFPProdPropertiesLegacy::bhp(const std::vector<int>
     //Allocate data for bhp's and partial derivatives
     ADB::V value = ADB::V::Zero(nw);
     ADB::V dthp = ADB::V::Zero(nw);
-    ADB::V dwfr = ADB::V::Zero(nw);
-    ADB::V dgfr = ADB::V::Zero(nw);
     ADB::V dalq = ADB::V::Zero(nw);
-    ADB::V dflo = ADB::V::Zero(nw);
+    ADB::V daqua = ADB::V::Zero(nw);
+    ADB::V dliquid = ADB::V::Zero(nw);
+    ADB::V dvapour = ADB::V::Zero(nw);
 
-    //Get the table for each well
-    std::vector<const VFPProdTable*> well_tables(nw, nullptr);
-    for (int i=0; i<nw; ++i) {
-        if (table_id[i] >= 0) {
-            well_tables[i] = detail::getTable(m_tables, table_id[i]);
-        }
-    }
-
-    //Get the right FLO/GFR/WFR variable for each well as a single ADB
-    const ADB flo = detail::combineADBVars<VFPProdTable::FLO_TYPE>(well_tables, aqua, liquid, vapour);
-    const ADB wfr = detail::combineADBVars<VFPProdTable::WFR_TYPE>(well_tables, aqua, liquid, vapour);
-    const ADB gfr = detail::combineADBVars<VFPProdTable::GFR_TYPE>(well_tables, aqua, liquid, vapour);
+    //Get the table for each well (only when the table ids change)
+    well_cache.update(m_tables, table_id, 0);
 
-    //Compute the BHP for each well independently
+    //Compute the BHP for each well independently, with the derivatives
+    //of FLO/WFR/GFR computed directly instead of through ADB temporaries
     for (int i=0; i<nw; ++i) {
-        const VFPProdTable* table = well_tables[i];
+        const VFPProdTable* table = well_cache.tables[i];
         if (table != nullptr) {
-            //First, find the values to interpolate between
+            const double a = aqua.value()[i];
+            const double l = liquid.value()[i];
+            const double v = vapour.value()[i];
+            const detail::VFPRateVariable flo = detail::getRateVariable(a, l, v, table->getFloType());
+            const detail::VFPRateVariable wfr = detail::getRateVariable(a, l, v, table->getWFRType());
+            const detail::VFPRateVariable gfr = detail::getRateVariable(a, l, v, table->getGFRType());
+
+            //First, find the values to interpolate between, starting
+            //from the intervals of the previous evaluation of this well
             //Value of FLO is negative in OPM for producers, but positive in VFP table
-            auto flo_i = detail::findInterpData(-flo.value()[i], table->getFloAxis());
-            auto thp_i = detail::findInterpData( thp_arg.value()[i], table->getTHPAxis());
-            auto wfr_i = detail::findInterpData( wfr.value()[i], table->getWFRAxis());
-            auto gfr_i = detail::findInterpData( gfr.value()[i], table->getGFRAxis());
-            auto alq_i = detail::findInterpData( alq.value()[i], table->getALQAxis());
+            std::array<int, 5>& hint = well_cache.hints[i];
+            auto flo_i = detail::findInterpData(-flo.value, table->getFloAxis(), hint[0]);
+            auto thp_i = detail::findInterpData( thp_arg.value()[i], table->getTHPAxis(), hint[1]);
+            auto wfr_i = detail::findInterpData( wfr.value, table->getWFRAxis(), hint[2]);
+            auto gfr_i = detail::findInterpData( gfr.value, table->getGFRAxis(), hint[3]);
+            auto alq_i = detail::findInterpData( alq.value()[i], table->getALQAxis(), hint[4]);
 
             detail::VFPEvaluation bhp_val = detail::interpolate(table->getTable(), flo_i, thp_i, wfr_i, gfr_i, alq_i);
 
             value[i] = bhp_val.value;
             dthp[i] = bhp_val.dthp;
-            dwfr[i] = bhp_val.dwfr;
-            dgfr[i] = bhp_val.dgfr;
             dalq[i] = bhp_val.dalq;
-            dflo[i] = bhp_val.dflo;
+            daqua[i] = -bhp_val.dflo*flo.daqua + bhp_val.dwfr*wfr.daqua + bhp_val.dgfr*gfr.daqua;
+            dliquid[i] = -bhp_val.dflo*flo.dliquid + bhp_val.dwfr*wfr.dliquid + bhp_val.dgfr*gfr.dliquid;
+            dvapour[i] = -bhp_val.dflo*flo.dvapour + bhp_val.dwfr*wfr.dvapour + bhp_val.dgfr*gfr.dvapour;
         }
         else {
             value[i] = -1e100; //Signal that this value has not been calculated properly, due to "missing" table
@@ -117,10 +129,10 @@ VFPProdPropertiesLegacy::ADB VFPProdPropertiesLegacy::bhp(const std::vector<int>
 
     //Create diagonal matrices from ADB::Vs
     ADB::M dthp_diag(dthp.matrix().asDiagonal());
-    ADB::M dwfr_diag(dwfr.matrix().asDiagonal());
-    ADB::M dgfr_diag(dgfr.matrix().asDiagonal());
     ADB::M dalq_diag(dalq.matrix().asDiagonal());
-    ADB::M dflo_diag(dflo.matrix().asDiagonal());
+    ADB::M daqua_diag(daqua.matrix().asDiagonal());
+    ADB::M dliquid_diag(dliquid.matrix().asDiagonal());
+    ADB::M dvapour_diag(dvapour.matrix().asDiagonal());
 
     //Calculate the Jacobians
     const int num_blocks = block_pattern.size();
@@ -133,17 +145,17 @@ VFPProdPropertiesLegacy::ADB VFPProdPropertiesLegacy::bhp(const std::vector<int>
         if (!thp_arg.derivative().empty()) {
             jacs[block] += dthp_diag * thp_arg.derivative()[block];
         }
-        if (!wfr.derivative().empty()) {
-            jacs[block] += dwfr_diag * wfr.derivative()[block];
-        }
-        if (!gfr.derivative().empty()) {
-            jacs[block] += dgfr_diag * gfr.derivative()[block];
-        }
         if (!alq.derivative().empty()) {
             jacs[block] += dalq_diag * alq.derivative()[block];
         }
-        if (!flo.derivative().empty()) {
-            jacs[block] -= dflo_diag * flo.derivative()[block];
+        if (!aqua.derivative().empty()) {
+            jacs[block] += daqua_diag * aqua.derivative()[block];
+        }
+        if (!liquid.derivative().empty()) {
+            jacs[block] += dliquid_diag * liquid.derivative()[block];
+        }
+        if (!vapour.derivative().empty()) {
+            jacs[block] += dvapour_diag * vapour.derivative()[block];
         }
     }
 
@@ -41,6 +41,11 @@ class VFPProdPropertiesLegacy : public VFPProdProperties {
 public:
     typedef AutoDiffBlock<double> ADB;
 
+    /// Tables and last interpolation intervals of a set of wells, see
+    /// detail::VFPWellCache. Owned by the caller, so that evaluations
+    /// of different callers or threads do not share state.
+    typedef detail::VFPWellCache<VFPProdTable, 5> WellCache;
+
     /**
      * Empty constructor
      */
@@ -102,6 +107,20 @@ public:
             const ADB& vapour,
             const ADB& thp,
             const ADB& alq) const;
+
+    /**
+     * As above, with the tables of the wells and the starting points of the
+     * interpolation searches taken from and stored in cache. Repeated calls
+     * with the same wells, e.g. in consecutive Newton iterations, then skip
+     * the table lookups.
+     */
+    ADB bhp(const std::vector<int>& table_id,
+            const ADB& aqua,
+            const ADB& liquid,
+            const ADB& vapour,
+            const ADB& thp,
+            const ADB& alq,
+            WellCache& cache) const;
 };
 
 } //namespace
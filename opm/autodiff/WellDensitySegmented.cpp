@@ -22,6 +22,7 @@
 #include <opm/autodiff/WellStateFullyImplicitBlackoil.hpp>
 #include <opm/common/ErrorMacros.hpp>
 #include <opm/core/props/BlackoilPhases.hpp>
+#include <algorithm>
 #include <numeric>
 #include <cmath>
 
@@ -61,82 +62,91 @@ Opm::WellDensitySegmented::computeConnectionDensities(const Wells& wells,
         }
     }
 
-    // 1. Compute the flow (in surface volume units for each
-    //    component) exiting up the wellbore from each perforation,
-    //    taking into account flow from lower in the well, and
-    //    in/out-flow at each perforation.
-    std::vector<double> q_out_perf(nperf*numComponents);
-    for (int w = 0; w < nw; ++w) {
-        // Iterate over well perforations from bottom to top.
-        for (int perf = wells.well_connpos[w+1] - 1; perf >= wells.well_connpos[w]; --perf) {
-            for (int component = 0; component < numComponents; ++component) {
-                if (perf == wells.well_connpos[w+1] - 1) {
-                    // This is the bottom perforation. No flow from below.
-                    q_out_perf[perf*numComponents + component] = 0.0;
-                } else {
-                    // Set equal to flow from below.
-                    q_out_perf[perf*numComponents + component] = q_out_perf[(perf+1)*numComponents + component];
-                }
-                // Subtract outflow through perforation.
-                q_out_perf[perf*numComponents + component] -= perfComponentRates[perf*numComponents + component];
-            }
-        }
-    }
-
-    // 2. Compute the component mix at each perforation as the
-    //    absolute values of the surface rates divided by their sum.
-    //    Then compute volume ratios (formation factors) for each perforation.
-    //    Finally compute densities for the segments associated with each perforation.
+    // The wells are independent, so they are processed in parallel,
+    // each thread taking batches of wells and working on the
+    // contiguous perforation range of one well at a time.
     const int gaspos = phase_usage.phase_pos[BlackoilPhases::Vapour];
     const int oilpos = phase_usage.phase_pos[BlackoilPhases::Liquid];
-    std::vector<double> mix(numComponents,0.0);
-    std::vector<double> x(numComponents);
-    std::vector<double> surf_dens(numComponents);
+    std::vector<double> q_out_perf(nperf*numComponents);
     std::vector<double> dens(nperf);
-    for (int w = 0; w < nw; ++w) {
-        for (int perf = wells.well_connpos[w]; perf < wells.well_connpos[w+1]; ++perf) {
-            // Find component mix.
-            const double tot_surf_rate = std::accumulate(q_out_perf.begin() + numComponents*perf,
-                                                         q_out_perf.begin() + numComponents*(perf+1), 0.0);
-            if (tot_surf_rate != 0.0) {
+#if HAVE_OPENMP
+#pragma omp parallel
+#endif // HAVE_OPENMP
+    {
+        // Scratch space private to each thread.
+        std::vector<double> mix(numComponents, 0.0);
+        std::vector<double> x(numComponents);
+#if HAVE_OPENMP
+#pragma omp for schedule(dynamic, 16)
+#endif // HAVE_OPENMP
+        for (int w = 0; w < nw; ++w) {
+            const int top = wells.well_connpos[w];
+            const int bottom = wells.well_connpos[w+1] - 1;
+
+            // 1. Compute the flow (in surface volume units for each
+            //    component) exiting up the wellbore from each perforation,
+            //    taking into account flow from lower in the well, and
+            //    in/out-flow at each perforation.
+            //    Iterate over well perforations from bottom to top.
+            for (int perf = bottom; perf >= top; --perf) {
+                double* q_out = &q_out_perf[perf*numComponents];
+                const double* rates = &perfComponentRates[perf*numComponents];
                 for (int component = 0; component < numComponents; ++component) {
-                    mix[component] = std::fabs(q_out_perf[perf*numComponents + component]/tot_surf_rate);
-                }
-            } else {
-                // No flow => use well specified fractions for mix.
-                for (int phase = 0; phase < np; ++phase) {
-                    mix[phase] = wells.comp_frac[w*np + phase];
+                    // Flow from below (none for the bottom perforation),
+                    // minus outflow through perforation.
+                    const double q_below = perf == bottom ? 0.0 : q_out[numComponents + component];
+                    q_out[component] = q_below - rates[component];
                 }
-                // intialize 0.0 for comIdx >= np;
-            }
-            // Compute volume ratio.
-            x = mix;
-            double rs = 0.0;
-            double rv = 0.0;
-            if (!rsmax_perf.empty() && mix[oilpos] > 0.0) {
-                rs = std::min(mix[gaspos]/mix[oilpos], rsmax_perf[perf]);
-            }
-            if (!rvmax_perf.empty() && mix[gaspos] > 0.0) {
-                rv = std::min(mix[oilpos]/mix[gaspos], rvmax_perf[perf]);
-            }
-            if (rs != 0.0) {
-                // Subtract gas in oil from gas mixture
-                x[gaspos] = (mix[gaspos] - mix[oilpos]*rs)/(1.0 - rs*rv);
-            }
-            if (rv != 0.0) {
-                // Subtract oil in gas from oil mixture
-                x[oilpos] = (mix[oilpos] - mix[gaspos]*rv)/(1.0 - rs*rv);;
-            }
-            double volrat = 0.0;
-            for (int component = 0; component < numComponents; ++component) {
-                volrat += x[component] / b_perf[perf*numComponents + component];
-            }
-            for (int component = 0; component < numComponents; ++component) {
-                surf_dens[component] = surf_dens_perf[perf*numComponents + component];
             }
 
-            // Compute segment density.
-            dens[perf] = std::inner_product(surf_dens.begin(), surf_dens.end(), mix.begin(), 0.0) / volrat;
+            // 2. Compute the component mix at each perforation as the
+            //    absolute values of the surface rates divided by their sum.
+            //    Then compute volume ratios (formation factors) for each perforation.
+            //    Finally compute densities for the segments associated with each perforation.
+            for (int perf = top; perf <= bottom; ++perf) {
+                const double* q_out = &q_out_perf[perf*numComponents];
+                const double* b = &b_perf[perf*numComponents];
+                const double* surf_dens = &surf_dens_perf[perf*numComponents];
+                // Find component mix.
+                const double tot_surf_rate = std::accumulate(q_out, q_out + numComponents, 0.0);
+                if (tot_surf_rate != 0.0) {
+                    for (int component = 0; component < numComponents; ++component) {
+                        mix[component] = std::fabs(q_out[component]/tot_surf_rate);
+                    }
+                } else {
+                    // No flow => use well specified fractions for mix.
+                    for (int phase = 0; phase < np; ++phase) {
+                        mix[phase] = wells.comp_frac[w*np + phase];
+                    }
+                    // Zero for the components that are not phases.
+                    std::fill(mix.begin() + np, mix.end(), 0.0);
+                }
+                // Compute volume ratio.
+                x = mix;
+                double rs = 0.0;
+                double rv = 0.0;
+                if (!rsmax_perf.empty() && mix[oilpos] > 0.0) {
+                    rs = std::min(mix[gaspos]/mix[oilpos], rsmax_perf[perf]);
+                }
+                if (!rvmax_perf.empty() && mix[gaspos] > 0.0) {
+                    rv = std::min(mix[oilpos]/mix[gaspos], rvmax_perf[perf]);
+                }
+                if (rs != 0.0) {
+                    // Subtract gas in oil from gas mixture
+                    x[gaspos] = (mix[gaspos] - mix[oilpos]*rs)/(1.0 - rs*rv);
+                }
+                if (rv != 0.0) {
+                    // Subtract oil in gas from oil mixture
+                    x[oilpos] = (mix[oilpos] - mix[gaspos]*rv)/(1.0 - rs*rv);;
+                }
+                double volrat = 0.0;
+                for (int component = 0; component < numComponents; ++component) {
+                    volrat += x[component] / b[component];
+                }
+
+                // Compute segment density.
+                dens[perf] = std::inner_product(surf_dens, surf_dens + numComponents, mix.begin(), 0.0) / volrat;
+            }
         }
     }
 
@@ -173,24 +183,25 @@ Opm::WellDensitySegmented::computeConnectionPressureDelta(const Wells& wells,
     //    perforation and the one above it, except for the first
     //    perforation for each well, for which it will be the
     //    difference to the reference (bhp) depth.
+    // 2. Compute pressure differences to the reference point (bhp) by
+    //    accumulating the already computed adjacent pressure
+    //    differences, storing the result in dp_perf.
+    //    This accumulation must be done per well, so both steps are
+    //    done in one pass over each well, with the wells in parallel.
     std::vector<double> dp_perf(nperf);
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif // HAVE_OPENMP
     for (int w = 0; w < nw; ++w) {
+        double z_above = wells.depth_ref[w];
+        double dp = 0.0;
         for (int perf = wells.well_connpos[w]; perf < wells.well_connpos[w+1]; ++perf) {
-            const double z_above = perf == wells.well_connpos[w] ? wells.depth_ref[w] : z_perf[perf - 1];
             const double dz = z_perf[perf] - z_above;
-            dp_perf[perf] = dz * dens_perf[perf] * gravity;
+            dp += dz * dens_perf[perf] * gravity;
+            dp_perf[perf] = dp;
+            z_above = z_perf[perf];
         }
     }
 
-    // 2. Compute pressure differences to the reference point (bhp) by
-    //    accumulating the already computed adjacent pressure
-    //    differences, storing the result in dp_perf.
-    //    This accumulation must be done per well.
-    for (int w = 0; w < nw; ++w) {
-        const auto beg = dp_perf.begin() + wells.well_connpos[w];
-        const auto end = dp_perf.begin() + wells.well_connpos[w + 1];
-        std::partial_sum(beg, end, beg);
-    }
-
     return dp_perf;
 }
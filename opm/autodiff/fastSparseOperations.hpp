@@ -15,15 +15,46 @@
 #include <Eigen/Sparse>
 
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <iterator>
 #include <functional>
 #include <limits>
+#include <mutex>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include <Eigen/Core>
 
+#if HAVE_OPENMP
+#include <omp.h>
+#endif // HAVE_OPENMP
+
 namespace Opm {
 
+namespace detail {
+
+    /// Minimum number of non-zeros touched by a sparse kernel before it
+    /// is split over threads. Below this the threading overhead dominates.
+    const int sparseParallelThreshold = 20000;
+
+    /// Whether a sparse kernel doing the given amount of work should run
+    /// its column loop in parallel. Kernels called from within a parallel
+    /// region (e.g. the loop over jacobian blocks in AutoDiffBlock) stay
+    /// serial.
+    inline bool runSparseKernelInParallel(const long work)
+    {
+#if HAVE_OPENMP
+        return work >= sparseParallelThreshold && !omp_in_parallel() && omp_get_max_threads() > 1;
+#else
+        static_cast<void>(work);
+        return false;
+#endif // HAVE_OPENMP
+    }
+
+} // namespace detail
+
 template < unsigned int depth >
 struct QuickSort
 {
@@ -142,14 +173,34 @@ void fastSparseProduct(const Lhs& lhs, const Rhs& rhs, ResultType& res)
 
 
 
-inline void fastDiagSparseProduct(const std::vector<double>& lhs,
+inline void fastDiagSparseProduct(const double* lhs,
                                   const Eigen::SparseMatrix<double>& rhs,
                                   Eigen::SparseMatrix<double>& res)
 {
     res = rhs;
 
     // Multiply rows by diagonal lhs.
-    int n = res.cols();
+    if (res.isCompressed()) {
+        // Contiguous value and row index arrays: one flat loop.
+        double* val = res.valuePtr();
+        const int* row = res.innerIndexPtr();
+        const int nnz = res.nonZeros();
+        const bool parallel = detail::runSparseKernelInParallel(nnz);
+        static_cast<void>(parallel);
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(static) if(parallel)
+#endif // HAVE_OPENMP
+        for (int k = 0; k < nnz; ++k) {
+            val[k] *= lhs[row[k]];
+        }
+        return;
+    }
+    const int n = res.cols();
+    const bool parallel = detail::runSparseKernelInParallel(res.nonZeros());
+    static_cast<void>(parallel);
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(static) if(parallel)
+#endif // HAVE_OPENMP
     for (int col = 0; col < n; ++col) {
         typedef Eigen::SparseMatrix<double>::InnerIterator It;
         for (It it(res, col); it; ++it) {
@@ -160,6 +211,15 @@ inline void fastDiagSparseProduct(const std::vector<double>& lhs,
 
 
 
+inline void fastDiagSparseProduct(const std::vector<double>& lhs,
+                                  const Eigen::SparseMatrix<double>& rhs,
+                                  Eigen::SparseMatrix<double>& res)
+{
+    fastDiagSparseProduct(lhs.data(), rhs, res);
+}
+
+
+
 
 inline void fastSparseDiagProduct(const Eigen::SparseMatrix<double>& lhs,
                                   const std::vector<double>& rhs,
@@ -168,7 +228,12 @@ inline void fastSparseDiagProduct(const Eigen::SparseMatrix<double>& lhs,
     res = lhs;
 
     // Multiply columns by diagonal rhs.
-    int n = res.cols();
+    const int n = res.cols();
+    const bool parallel = detail::runSparseKernelInParallel(res.nonZeros());
+    static_cast<void>(parallel);
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(static) if(parallel)
+#endif // HAVE_OPENMP
     for (int col = 0; col < n; ++col) {
         typedef Eigen::SparseMatrix<double>::InnerIterator It;
         for (It it(res, col); it; ++it) {
@@ -221,7 +286,525 @@ equalSparsityPattern(const Lhs& lhs, const Rhs& rhs)
     return equal;
 }
 
-// this function substracts two sparse matrices
+/// Hit/miss counters of the symbolic plan cache used by the
+/// fastSparseProduct() overload for Eigen::SparseMatrix<double>.
+/// Counters are summed over all threads.
+struct SparsePlanCacheCounters
+{
+    unsigned long product_hits = 0;
+    unsigned long product_misses = 0;
+
+    double productHitRate() const
+    {
+        const unsigned long total = product_hits + product_misses;
+        return total > 0 ? double(product_hits) / double(total) : 0.0;
+    }
+};
+
+namespace detail {
+
+    typedef Eigen::SparseMatrix<double> SparseRep;
+    typedef std::remove_const<std::remove_pointer<
+        decltype(std::declval<const SparseRep&>().innerIndexPtr())>::type>::type SparseIndex;
+
+    enum SparsePlanCounter { ProductHit, ProductMiss, NumSparsePlanCounters };
+
+    inline std::atomic<unsigned long>* sparsePlanCounterStorage()
+    {
+        static std::atomic<unsigned long> counters[NumSparsePlanCounters] = { {0}, {0} };
+        return counters;
+    }
+
+    inline void countSparsePlan(const SparsePlanCounter c)
+    {
+        sparsePlanCounterStorage()[c].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /// Memory limit of the plan cache of each thread, in bytes.
+    /// Zero disables the cache.
+    inline std::atomic<std::size_t>& sparsePlanCacheMaxBytesStorage()
+    {
+        static std::atomic<std::size_t> max_bytes(std::size_t(32) << 20);
+        return max_bytes;
+    }
+
+
+
+    /// FNV-1a hash of the dimensions and all outer and inner indices of a
+    /// compressed matrix.
+    inline std::uint64_t sparsePatternHash(const SparseRep& m)
+    {
+        const std::uint64_t prime = 1099511628211ull;
+        std::uint64_t h = 14695981039346656037ull;
+        h = (h ^ std::uint64_t(m.rows())) * prime;
+        h = (h ^ std::uint64_t(m.cols())) * prime;
+        const SparseIndex* outer = m.outerIndexPtr();
+        const long nouter = long(m.outerSize()) + 1;
+        for (long j = 0; j < nouter; ++j) {
+            h = (h ^ std::uint64_t(outer[j])) * prime;
+        }
+        const SparseIndex* inner = m.innerIndexPtr();
+        const long nnz = m.nonZeros();
+        for (long k = 0; k < nnz; ++k) {
+            h = (h ^ std::uint64_t(inner[k])) * prime;
+        }
+        return h;
+    }
+
+
+
+    /// Sparse matrices whose pattern does not change while they are
+    /// registered, such as the discrete gradient, average and divergence
+    /// operators of HelperOps. Only products with one of these on the left
+    /// go through the plan cache; their right hand sides (jacobians) tend
+    /// to keep their pattern over the Newton iterations.
+    class StableSparseOperators
+    {
+    public:
+        static StableSparseOperators& instance()
+        {
+            static StableSparseOperators operators;
+            return operators;
+        }
+
+        void add(const SparseRep& m)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            erase(m);
+            operators_.push_back(Operator{ &m, ++last_id_, m.rows(), m.cols(), SparseIndex(m.nonZeros()) });
+            generation_.fetch_add(1, std::memory_order_release);
+        }
+
+        void remove(const SparseRep& m)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (erase(m)) {
+                generation_.fetch_add(1, std::memory_order_release);
+            }
+        }
+
+        /// Identifier of m if it is registered and still has its
+        /// registered dimensions and number of nonzeros, otherwise 0.
+        /// Identifiers are never reused. Each thread works on a copy of
+        /// the registry that is only refreshed after it changed.
+        std::uint64_t find(const SparseRep& m)
+        {
+            thread_local std::vector<Operator> known;
+            thread_local unsigned long known_generation = 0;
+            if (generation_.load(std::memory_order_acquire) != known_generation) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                known = operators_;
+                known_generation = generation_.load(std::memory_order_relaxed);
+            }
+            for (const Operator& op : known) {
+                if (op.matrix == &m) {
+                    const bool unchanged = op.rows == m.rows() && op.cols == m.cols()
+                        && op.nnz == SparseIndex(m.nonZeros());
+                    return unchanged ? op.id : 0;
+                }
+            }
+            return 0;
+        }
+
+    private:
+        struct Operator
+        {
+            const SparseRep* matrix;
+            std::uint64_t id;
+            int rows;
+            int cols;
+            SparseIndex nnz;
+        };
+
+        StableSparseOperators() = default;
+
+        bool erase(const SparseRep& m)
+        {
+            const auto end = std::remove_if(operators_.begin(), operators_.end(),
+                                            [&m](const Operator& op) { return op.matrix == &m; });
+            const bool found = end != operators_.end();
+            operators_.erase(end, operators_.end());
+            return found;
+        }
+
+        std::mutex mutex_;
+        std::vector<Operator> operators_;
+        std::uint64_t last_id_ = 0;
+        std::atomic<unsigned long> generation_{1};
+    };
+
+
+
+    /// Structure of op * rhs for a stable operator op, keyed on the
+    /// operator and a hash of the complete pattern of rhs. No operand
+    /// patterns are stored.
+    struct SparseProductPlan
+    {
+        std::uint64_t op = 0;
+        int rhs_rows = 0;
+        int rhs_cols = 0;
+        SparseIndex rhs_nnz = 0;
+        std::uint64_t rhs_hash = 0;
+        unsigned long last_use = 0;
+        std::vector<SparseIndex> outer;
+        std::vector<SparseIndex> inner;
+
+        std::size_t bytes() const
+        {
+            return (outer.capacity() + inner.capacity()) * sizeof(SparseIndex);
+        }
+    };
+
+
+
+    /// Per-thread cache of product plans, bounded by the memory of the
+    /// stored structures (see setSparsePlanCacheMaxBytes()). When full,
+    /// the least recently used plans are dropped. A plan that does not
+    /// fit on its own is used once and not stored.
+    class SparsePlanCache
+    {
+    public:
+        static SparsePlanCache& instance()
+        {
+            static thread_local SparsePlanCache cache;
+            return cache;
+        }
+
+        /// Plan for lhs * rhs, where op identifies the stable operator lhs.
+        /// The pointer is valid until the next call on this thread.
+        const SparseProductPlan* productPlan(const std::uint64_t op,
+                                             const SparseRep& lhs, const SparseRep& rhs)
+        {
+            const std::uint64_t rhs_hash = sparsePatternHash(rhs);
+            ++use_count_;
+            for (SparseProductPlan& plan : plans_) {
+                if (plan.op == op && plan.rhs_hash == rhs_hash && plan.rhs_nnz == SparseIndex(rhs.nonZeros())
+                    && plan.rhs_rows == rhs.rows() && plan.rhs_cols == rhs.cols()) {
+                    plan.last_use = use_count_;
+                    countSparsePlan(ProductHit);
+                    return &plan;
+                }
+            }
+            countSparsePlan(ProductMiss);
+
+            SparseProductPlan plan;
+            plan.op = op;
+            plan.rhs_rows = rhs.rows();
+            plan.rhs_cols = rhs.cols();
+            plan.rhs_nnz = rhs.nonZeros();
+            plan.rhs_hash = rhs_hash;
+            plan.last_use = use_count_;
+            computeProductStructure(lhs, rhs, plan);
+
+            const std::size_t max_bytes = sparsePlanCacheMaxBytesStorage().load(std::memory_order_relaxed);
+            if (plan.bytes() > max_bytes) {
+                evict(max_bytes);
+                uncached_ = std::move(plan);
+                return &uncached_;
+            }
+            evict(max_bytes - plan.bytes());
+            bytes_ += plan.bytes();
+            plans_.push_back(std::move(plan));
+            return &plans_.back();
+        }
+
+        /// Drop a plan returned by productPlan() that turned out not to
+        /// fit its operands.
+        void discard(const SparseProductPlan* plan)
+        {
+            for (auto it = plans_.begin(); it != plans_.end(); ++it) {
+                if (&*it == plan) {
+                    bytes_ -= it->bytes();
+                    plans_.erase(it);
+                    return;
+                }
+            }
+        }
+
+        /// Scatter array of at least n entries, all -1. Users must reset
+        /// the entries they set to -1 before returning.
+        std::vector<SparseIndex>& workspace(const int n)
+        {
+            if (int(work_.size()) < n) {
+                work_.resize(n, -1);
+            }
+            return work_;
+        }
+
+        /// Memory held by the stored plans, in bytes.
+        std::size_t bytes() const { return bytes_; }
+
+    private:
+        SparsePlanCache() = default;
+
+        /// Drop the least recently used plans until at most max_bytes are held.
+        void evict(const std::size_t max_bytes)
+        {
+            while (bytes_ > max_bytes) {
+                auto lru = std::min_element(plans_.begin(), plans_.end(),
+                                            [](const SparseProductPlan& a, const SparseProductPlan& b)
+                                            { return a.last_use < b.last_use; });
+                bytes_ -= lru->bytes();
+                plans_.erase(lru);
+            }
+        }
+
+        static void computeProductStructure(const SparseRep& lhs, const SparseRep& rhs,
+                                            SparseProductPlan& plan)
+        {
+            const int rows = lhs.rows();
+            const int cols = rhs.cols();
+            plan.outer.assign(cols + 1, 0);
+
+            // Columns are split in contiguous chunks, the structure of each
+            // chunk is computed independently and then concatenated.
+            const bool parallel = runSparseKernelInParallel(long(lhs.nonZeros()) + rhs.nonZeros());
+#if HAVE_OPENMP
+            const int num_chunks = parallel ? omp_get_max_threads() : 1;
+#else
+            static_cast<void>(parallel);
+            const int num_chunks = 1;
+#endif // HAVE_OPENMP
+            std::vector<std::vector<SparseIndex> > chunk_inner(num_chunks);
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(static, 1) if(parallel)
+#endif // HAVE_OPENMP
+            for (int c = 0; c < num_chunks; ++c) {
+                const int jbegin = (long(cols) * c) / num_chunks;
+                const int jend = (long(cols) * (c + 1)) / num_chunks;
+                std::vector<bool> mask(rows, false);
+                std::vector<SparseIndex> indices;
+                std::vector<SparseIndex>& inner = chunk_inner[c];
+                for (int j = jbegin; j < jend; ++j) {
+                    indices.clear();
+                    for (SparseRep::InnerIterator rhsIt(rhs, j); rhsIt; ++rhsIt) {
+                        for (SparseRep::InnerIterator lhsIt(lhs, rhsIt.index()); lhsIt; ++lhsIt) {
+                            const SparseIndex i = lhsIt.index();
+                            if (!mask[i]) {
+                                mask[i] = true;
+                                indices.push_back(i);
+                            }
+                        }
+                    }
+                    std::sort(indices.begin(), indices.end());
+                    for (const SparseIndex i : indices) {
+                        inner.push_back(i);
+                        mask[i] = false;
+                    }
+                    plan.outer[j + 1] = indices.size();
+                }
+            }
+
+            for (int j = 0; j < cols; ++j) {
+                plan.outer[j + 1] += plan.outer[j];
+            }
+            plan.inner.clear();
+            plan.inner.reserve(plan.outer[cols]);
+            for (const auto& inner : chunk_inner) {
+                plan.inner.insert(plan.inner.end(), inner.begin(), inner.end());
+            }
+        }
+
+        unsigned long use_count_ = 0;
+        std::size_t bytes_ = 0;
+        std::vector<SparseProductPlan> plans_;
+        SparseProductPlan uncached_;
+        std::vector<SparseIndex> work_;
+    };
+
+
+
+    /// Set m to a rows x cols compressed matrix with the given structure
+    /// and uninitialised values.
+    inline void setStructure(const int rows, const int cols,
+                             const std::vector<SparseIndex>& outer,
+                             const std::vector<SparseIndex>& inner,
+                             SparseRep& m)
+    {
+        m.resize(rows, cols);
+        m.makeCompressed();
+        m.resizeNonZeros(inner.size());
+        std::copy(outer.begin(), outer.end(), m.outerIndexPtr());
+        std::copy(inner.begin(), inner.end(), m.innerIndexPtr());
+    }
+
+    /// Remove the entries whose inner index is marked -1.
+    inline void removeMarkedEntries(SparseRep& m)
+    {
+        const int cols = m.outerSize();
+        SparseIndex* outer = m.outerIndexPtr();
+        SparseIndex* inner = m.innerIndexPtr();
+        double* val = m.valuePtr();
+        SparseIndex dst = 0;
+        SparseIndex begin = outer[0];
+        for (int j = 0; j < cols; ++j) {
+            const SparseIndex end = outer[j + 1];
+            for (SparseIndex k = begin; k < end; ++k) {
+                if (inner[k] >= 0) {
+                    inner[dst] = inner[k];
+                    val[dst] = val[k];
+                    ++dst;
+                }
+            }
+            begin = end;
+            outer[j + 1] = dst;
+        }
+        m.resizeNonZeros(dst);
+    }
+
+    /// Numeric phase of lhs * rhs on the structure of plan. Like the
+    /// generic fastSparseProduct(), contributions that are exactly zero
+    /// are skipped and entries that receive no other contribution are not
+    /// stored, while entries whose contributions cancel are. Returns false
+    /// if a contribution falls outside the plan, i.e. the plan does not
+    /// belong to these operands.
+    inline bool plannedSparseProduct(const SparseRep& lhs, const SparseRep& rhs,
+                                     const SparseProductPlan& plan, SparseRep& res)
+    {
+        const int rows = lhs.rows();
+        const int cols = rhs.cols();
+        setStructure(rows, cols, plan.outer, plan.inner, res);
+
+        // Column partitioned; every thread scatters through the workspace
+        // of its own (thread local) cache instance. Entries without a
+        // contribution get their inner index marked for removal.
+        const SparseIndex* outer = plan.outer.data();
+        const SparseIndex* plan_inner = plan.inner.data();
+        SparseIndex* inner = res.innerIndexPtr();
+        double* val = res.valuePtr();
+        bool unreached = false;
+        bool outside = false;
+        const bool parallel = runSparseKernelInParallel(long(lhs.nonZeros()) + rhs.nonZeros());
+        static_cast<void>(parallel);
+#if HAVE_OPENMP
+#pragma omp parallel if(parallel) reduction(||:unreached,outside)
+#endif // HAVE_OPENMP
+        {
+            std::vector<SparseIndex>& pos = SparsePlanCache::instance().workspace(rows);
+#if HAVE_OPENMP
+#pragma omp for schedule(static)
+#endif // HAVE_OPENMP
+            for (int j = 0; j < cols; ++j) {
+                for (SparseIndex k = outer[j]; k < outer[j + 1]; ++k) {
+                    pos[plan_inner[k]] = k;
+                    val[k] = 0.0;
+                    inner[k] = -1;
+                }
+                for (SparseRep::InnerIterator rhsIt(rhs, j); rhsIt; ++rhsIt) {
+                    const double y = rhsIt.value();
+                    for (SparseRep::InnerIterator lhsIt(lhs, rhsIt.index()); lhsIt; ++lhsIt) {
+                        const double v = lhsIt.value() * y;
+                        if (std::abs(v) > 0.0) {
+                            const SparseIndex k = pos[lhsIt.index()];
+                            if (k < 0) {
+                                outside = true;
+                                continue;
+                            }
+                            val[k] += v;
+                            inner[k] = plan_inner[k];
+                        }
+                    }
+                }
+                for (SparseIndex k = outer[j]; k < outer[j + 1]; ++k) {
+                    pos[plan_inner[k]] = -1;
+                    unreached = unreached || (inner[k] < 0);
+                }
+            }
+        }
+        if (outside) {
+            return false;
+        }
+        if (unreached) {
+            removeMarkedEntries(res);
+        }
+        return true;
+    }
+
+} // namespace detail
+
+
+
+/// Register m as a stable operator: its pattern does not change until
+/// unregisterStableSparseOperator() is called, which must happen before m
+/// is destroyed. Products m * rhs then reuse the structure of earlier
+/// products with the same pattern of rhs.
+inline void registerStableSparseOperator(const Eigen::SparseMatrix<double>& m)
+{
+    detail::StableSparseOperators::instance().add(m);
+}
+
+inline void unregisterStableSparseOperator(const Eigen::SparseMatrix<double>& m)
+{
+    detail::StableSparseOperators::instance().remove(m);
+}
+
+/// Current values of the sparse plan cache counters.
+inline SparsePlanCacheCounters sparsePlanCacheCounters()
+{
+    const std::atomic<unsigned long>* c = detail::sparsePlanCounterStorage();
+    SparsePlanCacheCounters counters;
+    counters.product_hits = c[detail::ProductHit].load();
+    counters.product_misses = c[detail::ProductMiss].load();
+    return counters;
+}
+
+/// Reset all sparse plan cache counters to zero.
+inline void resetSparsePlanCacheCounters()
+{
+    std::atomic<unsigned long>* c = detail::sparsePlanCounterStorage();
+    for (int i = 0; i < detail::NumSparsePlanCounters; ++i) {
+        c[i].store(0);
+    }
+}
+
+/// Set the memory limit of the sparse plan cache of each thread, in
+/// bytes (32 MiB by default). Zero disables the cache. A lower limit takes
+/// effect at the next miss of each thread.
+inline void setSparsePlanCacheMaxBytes(const std::size_t max_bytes)
+{
+    detail::sparsePlanCacheMaxBytesStorage().store(max_bytes);
+}
+
+inline std::size_t sparsePlanCacheMaxBytes()
+{
+    return detail::sparsePlanCacheMaxBytesStorage().load(std::memory_order_relaxed);
+}
+
+
+
+/// Sparse product of column-major double matrices. When lhs is a
+/// registered stable operator, the symbolic phase (structure of the
+/// result) is looked up in SparsePlanCache and only the numeric phase is
+/// done on a hit. The result is the same as without the cache.
+inline void fastSparseProduct(const Eigen::SparseMatrix<double>& lhs,
+                              const Eigen::SparseMatrix<double>& rhs,
+                              Eigen::SparseMatrix<double>& res)
+{
+    typedef Eigen::SparseMatrix<double> Sp;
+    const std::uint64_t op = (lhs.nonZeros() > 0 && rhs.nonZeros() > 0
+                              && lhs.isCompressed() && rhs.isCompressed()
+                              && sparsePlanCacheMaxBytes() > 0)
+        ? detail::StableSparseOperators::instance().find(lhs) : 0;
+    if (op == 0) {
+        fastSparseProduct<Sp, Sp, Sp>(lhs, rhs, res);
+        return;
+    }
+    eigen_assert(lhs.cols() == rhs.rows());
+
+    detail::SparsePlanCache& cache = detail::SparsePlanCache::instance();
+    const detail::SparseProductPlan* plan = cache.productPlan(op, lhs, rhs);
+    Sp result;
+    if (detail::plannedSparseProduct(lhs, rhs, *plan, result)) {
+        res.swap(result);
+    } else {
+        cache.discard(plan);
+        fastSparseProduct<Sp, Sp, Sp>(lhs, rhs, res);
+    }
+}
+
+
+
+// this function adds two sparse matrices
 // if the sparsity pattern is the same a faster add/substract is performed
 template<typename Lhs, typename Rhs>
 inline void
@@ -238,6 +821,11 @@ fastSparseAdd(Lhs& lhs, const Rhs& rhs)
         const Scalar* rhsV = rhs.valuePtr();
         Scalar* lhsV = lhs.valuePtr();
 
+        const bool parallel = detail::runSparseKernelInParallel( nnz );
+        static_cast<void>( parallel );
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(static) if(parallel)
+#endif // HAVE_OPENMP
         for(Index i=0; i<nnz; ++i )
         {
             lhsV[ i ] += rhsV[ i ];
@@ -267,6 +855,11 @@ fastSparseSubstract(Lhs& lhs, const Rhs& rhs)
         const Scalar* rhsV = rhs.valuePtr();
         Scalar* lhsV = lhs.valuePtr();
 
+        const bool parallel = detail::runSparseKernelInParallel( nnz );
+        static_cast<void>( parallel );
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(static) if(parallel)
+#endif // HAVE_OPENMP
         for(Index i=0; i<nnz; ++i )
         {
             lhsV[ i ] -= rhsV[ i ];
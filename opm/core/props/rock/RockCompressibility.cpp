@@ -23,7 +23,6 @@
 #include <opm/parser/eclipse/Units/Units.hpp>
 #include <opm/common/ErrorMacros.hpp>
 #include <opm/common/OpmLog/OpmLog.hpp>
-#include <opm/common/utility/numeric/linearInterpolation.hpp>
 
 #include <opm/parser/eclipse/EclipseState/Tables/RocktabTable.hpp>
 #include <opm/parser/eclipse/EclipseState/Tables/TableManager.hpp>
@@ -60,6 +59,8 @@ namespace Opm
             } else {
                 transmult_ =  rocktabTable.getColumn("PV_MULT_TRANX").vectorCopy();
             }
+            poromult_table_ = IndexedLinearTable(p_, poromult_);
+            transmult_table_ = IndexedLinearTable(p_, transmult_);
         } else if (!tables.getRockTable().empty()) {
             const auto& rockKeyword = tables.getRockTable();
             if (rockKeyword.size() != 1) {
@@ -90,7 +91,7 @@ namespace Opm
             const double cpnorm = rock_comp_*(pressure - pref_);
             return (1.0 + cpnorm + 0.5*cpnorm*cpnorm);
         } else {
-            return Opm::linearInterpolation(p_, poromult_, pressure);
+            return poromult_table_(pressure);
         }
     }
 
@@ -102,7 +103,7 @@ namespace Opm
             const double cpnorm = rock_comp_*(pressure - pref_);
             return rock_comp_ + cpnorm*rock_comp_;
         } else {
-            return Opm::linearInterpolationDerivative(p_, poromult_, pressure);
+            return poromult_table_.derivative(pressure);
         }
     }
 
@@ -111,7 +112,7 @@ namespace Opm
         if (p_.empty()) {
             return 1.0;
         } else {
-            return Opm::linearInterpolation(p_, transmult_, pressure);
+            return transmult_table_(pressure);
         }
     }
 
@@ -120,7 +121,7 @@ namespace Opm
         if (p_.empty()) {
             return 0.0;
         } else {
-            return Opm::linearInterpolationDerivative(p_, transmult_, pressure);
+            return transmult_table_.derivative(pressure);
         }
     }
 
@@ -129,10 +130,8 @@ namespace Opm
         if (p_.empty()) {
             return rock_comp_;
         } else {
-            //const double poromult = Opm::linearInterpolation(p_, poromult_, pressure);
-            //const double dporomultdp = Opm::linearInterpolationDerivative(p_, poromult_, pressure);
-            const double poromult = Opm::linearInterpolation(p_, poromult_, pressure);
-            const double dporomultdp = Opm::linearInterpolationDerivative(p_, poromult_, pressure);
+            const double poromult = poromult_table_(pressure);
+            const double dporomultdp = poromult_table_.derivative(pressure);
 
             return dporomultdp/poromult;
         }
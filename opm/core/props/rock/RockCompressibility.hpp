@@ -20,6 +20,7 @@
 #ifndef OPM_ROCKCOMPRESSIBILITY_HEADER_INCLUDED
 #define OPM_ROCKCOMPRESSIBILITY_HEADER_INCLUDED
 
+#include <opm/core/utility/IndexedLinearTable.hpp>
 #include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
 
 #include <vector>
@@ -65,6 +66,8 @@ namespace Opm
         std::vector<double> p_;
         std::vector<double> poromult_;
         std::vector<double> transmult_;
+        IndexedLinearTable poromult_table_;
+        IndexedLinearTable transmult_table_;
         double pref_;
         double rock_comp_;
     };
@@ -46,6 +46,7 @@
 
 #include <array>
 #include <cassert>
+#include <exception>
 #include <utility>
 #include <vector>
 
@@ -58,6 +59,39 @@ struct UnstructuredGrid;
 
 namespace Opm
 {
+    namespace Details {
+        /// Call body(i) for i = 0, ..., n - 1, using parallel threads
+        /// if OpenMP is available and n > chunk. Nested parallel
+        /// regions run on one thread, so when called from within a
+        /// parallel loop this is a serial loop. An exception thrown by
+        /// any call is rethrown after the loop.
+        template <class Body>
+        void
+        parallelFor(const int n, const int chunk, const Body& body)
+        {
+            std::exception_ptr error;
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(dynamic, chunk) if (n > chunk)
+#endif // HAVE_OPENMP
+            for (int i = 0; i < n; ++i) {
+                try {
+                    body(i);
+                } catch (...) {
+#if HAVE_OPENMP
+#pragma omp critical(EquilParallelForError)
+#endif // HAVE_OPENMP
+                    {
+                        if (!error) {
+                            error = std::current_exception();
+                        }
+                    }
+                }
+            }
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    } // namespace Details
 
 
     /**
@@ -390,36 +424,61 @@ namespace Opm
                                  const Grid&                       G    ,
                                  const double grav)
                 {
+                    std::vector<int> regions;
                     for (const auto& r : reg.activeRegions()) {
-                        const auto& cells = reg.cells(r);
-                        if (cells.empty())
+                        if (reg.cells(r).empty())
                         {
                             OpmLog::warning("Equilibration region " + std::to_string(r + 1) 
                                             + " has no active cells");
                             continue;
                         }
+                        regions.push_back(r);
+                    }
 
-                        const EqReg eqreg(rec[r], rs_func_[r], rv_func_[r], regionPvtIdx_[r]);
-                   
-                        PVec pressures = phasePressures<FluidSystem>(G, eqreg, cells, grav);
-                        const std::vector<double>& temp = temperature(G, eqreg, cells);
-                        const PVec sat = phaseSaturations<FluidSystem>(G, eqreg, cells, materialLawManager, swat_init_, pressures);
+                    // The regions are independent, and each writes only
+                    // to its own cells, so they are computed in parallel.
+                    // With a single region, the cell loops within the
+                    // region are parallel instead. SWATINIT modifies the
+                    // material law manager (see phaseSaturations()), so
+                    // then all regions run on one thread.
+                    const int nreg = regions.size();
+                    const int chunk = swat_init_.empty() ? 1 : nreg;
+                    Details::parallelFor(nreg, chunk, [&](const int i)
+                    {
+                        calcPressSatRsRv(regions[i], reg, rec, materialLawManager, G, grav);
+                    });
+                }
 
-                        const int np = FluidSystem::numPhases;
-                        for (int p = 0; p < np; ++p) {
-                            copyFromRegion(pressures[p], cells, pp_[p]);
-                            copyFromRegion(sat[p], cells, sat_[p]);
-                        }
-                        const bool oil = FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx);
-                        const bool gas = FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx);
-                        if (oil && gas) {
-                            const int oilpos = FluidSystem::oilPhaseIdx;
-                            const int gaspos = FluidSystem::gasPhaseIdx;
-                            const Vec rs_vals = computeRs(G, cells, pressures[oilpos], temp, *(rs_func_[r]), sat[gaspos]);
-                            const Vec rv_vals = computeRs(G, cells, pressures[gaspos], temp, *(rv_func_[r]), sat[oilpos]);
-                            copyFromRegion(rs_vals, cells, rs_);
-                            copyFromRegion(rv_vals, cells, rv_);
-                        }
+                template <class RMap, class MaterialLawManager, class Grid>
+                void
+                calcPressSatRsRv(const int                         r    ,
+                                 const RMap&                       reg  ,
+                                 const std::vector< EquilRecord >& rec  ,
+                                 MaterialLawManager& materialLawManager,
+                                 const Grid&                       G    ,
+                                 const double grav)
+                {
+                    const auto& cells = reg.cells(r);
+                    const EqReg eqreg(rec[r], rs_func_[r], rv_func_[r], regionPvtIdx_[r]);
+
+                    PVec pressures = phasePressures<FluidSystem>(G, eqreg, cells, grav);
+                    const std::vector<double>& temp = temperature(G, eqreg, cells);
+                    const PVec sat = phaseSaturations<FluidSystem>(G, eqreg, cells, materialLawManager, swat_init_, pressures);
+
+                    const int np = FluidSystem::numPhases;
+                    for (int p = 0; p < np; ++p) {
+                        copyFromRegion(pressures[p], cells, pp_[p]);
+                        copyFromRegion(sat[p], cells, sat_[p]);
+                    }
+                    const bool oil = FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx);
+                    const bool gas = FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx);
+                    if (oil && gas) {
+                        const int oilpos = FluidSystem::oilPhaseIdx;
+                        const int gaspos = FluidSystem::gasPhaseIdx;
+                        const Vec rs_vals = computeRs(G, cells, pressures[oilpos], temp, *(rs_func_[r]), sat[gaspos]);
+                        const Vec rv_vals = computeRs(G, cells, pressures[gaspos], temp, *(rv_func_[r]), sat[oilpos]);
+                        copyFromRegion(rs_vals, cells, rs_);
+                        copyFromRegion(rv_vals, cells, rv_);
                     }
                 }
 
@@ -237,42 +237,35 @@ namespace Opm
 
 
         namespace PhasePressure {
-            template <class Grid,
-                      class PressFunction,
-                      class CellRange>
+            /// Evaluate the pressure tables at the cell depths of a
+            /// region, given once for all phases.
+            template <class PressFunction>
             void
-            assign(const Grid&                         G    ,
+            assign(const std::vector<double>&          depth,
                    const std::array<PressFunction, 2>& f    ,
                    const double                        split,
-                   const CellRange&                    cells,
                    std::vector<double>&                p    )
             {
 
                 enum { up = 0, down = 1 };
 
-                std::vector<double>::size_type c = 0;
-                for (typename CellRange::const_iterator
-                         ci = cells.begin(), ce = cells.end();
-                     ci != ce; ++ci, ++c)
-                {
-                    assert (c < p.size());
+                assert (depth.size() <= p.size());
 
-                    const double z = UgGridHelpers::cellCenterDepth(G, *ci);
+                parallelFor(depth.size(), 1024, [&](const int c)
+                {
+                    const double z = depth[c];
                     p[c] = (z < split) ? f[up](z) : f[down](z);
-                }
+                });
             }
 
-            template <                     class FluidSystem,
-                                           class Grid,
-                                           class Region,
-                                           class CellRange>
+            template <class FluidSystem,
+                      class Region>
             void
-            water(const Grid&                 G     ,
-                  const Region&               reg   ,
+            water(const Region&               reg   ,
                   const std::array<double,2>& span  ,
                   const double                grav  ,
                   double&                     po_woc,
-                  const CellRange&            cells ,
+                  const std::vector<double>&  depth ,
                   std::vector<double>&        press )
             {
                 using PhasePressODE::Water;
@@ -303,7 +296,7 @@ namespace Opm
                     }
                 };
 
-                assign(G, wpress, z0, cells, press);
+                assign(depth, wpress, z0, press);
 
                 if (reg.datum() > reg.zwoc()) {
                     // Return oil pressure at contact
@@ -312,15 +305,12 @@ namespace Opm
             }
 
             template <class FluidSystem,
-                      class Grid,
-                      class Region,
-                      class CellRange>
+                      class Region>
             void
-            oil(const Grid&                 G     ,
-                const Region&               reg   ,
+            oil(const Region&               reg   ,
                 const std::array<double,2>& span  ,
                 const double                grav  ,
-                const CellRange&            cells ,
+                const std::vector<double>&  depth ,
                 std::vector<double>&        press ,
                 double&                     po_woc,
                 double&                     po_goc)
@@ -357,7 +347,7 @@ namespace Opm
                     }
                 };
 
-                assign(G, opress, z0, cells, press);
+                assign(depth, opress, z0, press);
 
                 const double woc = reg.zwoc();
                 if      (z0 > woc) { po_woc = opress[0](woc); } // WOC above datum
@@ -371,16 +361,13 @@ namespace Opm
             }
 
             template <class FluidSystem,
-                      class Grid,
-                      class Region,
-                      class CellRange>
+                      class Region>
             void
-            gas(const Grid&                 G     ,
-                const Region&               reg   ,
+            gas(const Region&               reg   ,
                 const std::array<double,2>& span  ,
                 const double                grav  ,
                 double&                     po_goc,
-                const CellRange&            cells ,
+                const std::vector<double>&  depth ,
                 std::vector<double>&        press )
             {
                 using PhasePressODE::Gas;
@@ -412,7 +399,7 @@ namespace Opm
                     }
                 };
 
-                assign(G, gpress, z0, cells, press);
+                assign(depth, gpress, z0, press);
 
                 if (reg.datum() < reg.zgoc()) {
                     // Return oil pressure at contact
@@ -422,15 +409,12 @@ namespace Opm
         } // namespace PhasePressure
 
         template <class FluidSystem,
-                  class Grid,
-                  class Region,
-                  class CellRange>
+                  class Region>
         void
-        equilibrateOWG(const Grid&                         G,
-                       const Region&                       reg,
+        equilibrateOWG(const Region&                       reg,
                        const double                        grav,
                        const std::array<double,2>&         span,
-                       const CellRange&                    cells,
+                       const std::vector<double>&          depth,
                        std::vector< std::vector<double> >& press)
         {
             const bool water = FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx);
@@ -445,54 +429,54 @@ namespace Opm
                 double po_goc = -1;
 
                 if (water) {
-                    PhasePressure::water<FluidSystem>(G, reg, span, grav, po_woc,
-                                         cells, press[ waterpos ]);
+                    PhasePressure::water<FluidSystem>(reg, span, grav, po_woc,
+                                                      depth, press[ waterpos ]);
                 }
 
                 if (oil) {
-                    PhasePressure::oil<FluidSystem>(G, reg, span, grav, cells,
-                                       press[ oilpos ], po_woc, po_goc);
+                    PhasePressure::oil<FluidSystem>(reg, span, grav, depth,
+                                                    press[ oilpos ], po_woc, po_goc);
                 }
 
                 if (gas) {
-                    PhasePressure::gas<FluidSystem>(G, reg, span, grav, po_goc,
-                                       cells, press[ gaspos ]);
+                    PhasePressure::gas<FluidSystem>(reg, span, grav, po_goc,
+                                                    depth, press[ gaspos ]);
                 }
             } else if (reg.datum() < reg.zgoc()) { // Datum in gas zone
                 double po_woc = -1;
                 double po_goc = -1;
 
                 if (gas) {
-                    PhasePressure::gas<FluidSystem>(G, reg, span, grav, po_goc,
-                                       cells, press[ gaspos ]);
+                    PhasePressure::gas<FluidSystem>(reg, span, grav, po_goc,
+                                                    depth, press[ gaspos ]);
                 }
 
                 if (oil) {
-                    PhasePressure::oil<FluidSystem>(G, reg, span, grav, cells,
-                                       press[ oilpos ], po_woc, po_goc);
+                    PhasePressure::oil<FluidSystem>(reg, span, grav, depth,
+                                                    press[ oilpos ], po_woc, po_goc);
                 }
 
                 if (water) {
-                    PhasePressure::water<FluidSystem>(G, reg, span, grav, po_woc,
-                                         cells, press[ waterpos ]);
+                    PhasePressure::water<FluidSystem>(reg, span, grav, po_woc,
+                                                      depth, press[ waterpos ]);
                 }
             } else { // Datum in oil zone
                 double po_woc = -1;
                 double po_goc = -1;
 
                 if (oil) {
-                    PhasePressure::oil<FluidSystem>(G, reg, span, grav, cells,
+                    PhasePressure::oil<FluidSystem>(reg, span, grav, depth,
                                                     press[ oilpos ], po_woc, po_goc);
                 }
 
                 if (water) {
-                    PhasePressure::water<FluidSystem>(G, reg, span, grav, po_woc,
-                                         cells, press[ waterpos ]);
+                    PhasePressure::water<FluidSystem>(reg, span, grav, po_woc,
+                                                      depth, press[ waterpos ]);
                 }
 
                 if (gas) {
-                    PhasePressure::gas<FluidSystem>(G, reg, span, grav, po_goc,
-                                       cells, press[ gaspos ]);
+                    PhasePressure::gas<FluidSystem>(reg, span, grav, po_goc,
+                                                    depth, press[ gaspos ]);
                 }
             }
         }
@@ -516,6 +500,9 @@ namespace Opm
                 {{  std::numeric_limits<double>::max() ,
                    -std::numeric_limits<double>::max() }}; // Symm. about 0.
 
+            // Depth of each cell in the range, computed once and used
+            // for all phases.
+            std::vector<double> depth;
             int ncell = 0;
             {
                 // This code is only supported in three space dimensions
@@ -539,12 +526,21 @@ namespace Opm
                 auto cell2Faces = UgGridHelpers::cell2Faces(G);
                 auto faceVertices = UgGridHelpers::face2Vertices(G);
 
-                for (typename CellRange::const_iterator
-                         ci = cells.begin(), ce = cells.end();
-                     ci != ce; ++ci, ++ncell)
+                const std::vector<int> cell_list(cells.begin(), cells.end());
+                ncell = cell_list.size();
+                depth.resize(ncell);
+
+                double zmin = span[0];
+                double zmax = span[1];
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(static) reduction(min:zmin) reduction(max:zmax)
+#endif // HAVE_OPENMP
+                for (int c = 0; c < ncell; ++c)
                 {
-                    for (auto fi=cell2Faces[*ci].begin(),
-                              fe=cell2Faces[*ci].end();
+                    depth[c] = UgGridHelpers::cellCenterDepth(G, cell_list[c]);
+
+                    for (auto fi=cell2Faces[cell_list[c]].begin(),
+                              fe=cell2Faces[cell_list[c]].end();
                          fi != fe;
                          ++fi)
                     {
@@ -553,11 +549,13 @@ namespace Opm
                         {
                             const double z = UgGridHelpers::vertexCoordinates(G, *i)[nd-1];
 
-                            if (z < span[0]) { span[0] = z; }
-                            if (z > span[1]) { span[1] = z; }
+                            if (z < zmin) { zmin = z; }
+                            if (z > zmax) { zmax = z; }
                         }
                     }
                 }
+                span[0] = zmin;
+                span[1] = zmax;
             }
             const int np = FluidSystem::numPhases;  //reg.phaseUsage().num_phases;
 
@@ -571,7 +569,7 @@ namespace Opm
             span[0] = std::min(span[0],zgoc);
             span[1] = std::max(span[1],zwoc);
 
-            Details::equilibrateOWG<FluidSystem>(G, reg, grav, span, cells, press);
+            Details::equilibrateOWG<FluidSystem>(reg, grav, span, depth, press);
 
             return press;
         }
@@ -617,7 +615,6 @@ namespace Opm
                     /*storeViscosity=*/false,
                     /*storeEnthalpy=*/false> SatOnlyFluidState;
 
-            SatOnlyFluidState fluidState;
             typedef typename MaterialLawManager::MaterialLaw MaterialLaw;
 
             const bool water = FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx);
@@ -625,9 +622,23 @@ namespace Opm
             const int oilpos = FluidSystem::oilPhaseIdx;
             const int waterpos = FluidSystem::waterPhaseIdx;
             const int gaspos = FluidSystem::gasPhaseIdx;
-            std::vector<double>::size_type local_index = 0;
-            for (typename CellRange::const_iterator ci = cells.begin(); ci != cells.end(); ++ci, ++local_index) {
-                const int cell = *ci;
+
+            // The cells are independent: each only reads and writes its
+            // own entries of the pressures and saturations. With SWATINIT,
+            // applySwatinit() also rescales the capillary pressure in the
+            // end-point scaling data of the material law manager, which is
+            // not guaranteed to be private to the cell, so that case runs
+            // on one thread.
+            const std::vector<int> cell_list(cells.begin(), cells.end());
+            const int ncell = cell_list.size();
+            const int chunk = swat_init.empty() ? 256 : ncell;
+            Details::parallelFor(ncell, chunk, [&](const int local_index)
+            {
+                const int cell = cell_list[local_index];
+                SatOnlyFluidState fluidState;
+                for (int phaseIdx = 0; phaseIdx < 3; ++phaseIdx) {
+                    fluidState.setSaturation(phaseIdx, 0.0);
+                }
                 const auto& scaledDrainageInfo =
                     materialLawManager.oilWaterScaledEpsInfoDrainage(cell);
                 const auto& matParams = materialLawManager.materialLawParams(cell);
@@ -742,7 +753,7 @@ namespace Opm
                     double pcWat = pC[FluidSystem::oilPhaseIdx] - pC[FluidSystem::waterPhaseIdx];
                     phase_pressures[waterpos][local_index] = phase_pressures[oilpos][local_index] - pcWat;
                 }
-            }
+            });
             return phase_saturations;
         }
 
@@ -774,12 +785,13 @@ namespace Opm
                                       const std::vector<double> gas_saturation)
         {
             assert(UgGridHelpers::dimensions(grid) == 3);
-            std::vector<double> rs(cells.size());
-            int count = 0;
-            for (auto it = cells.begin(); it != cells.end(); ++it, ++count) {
-                const double depth = UgGridHelpers::cellCenterDepth(grid, *it);
+            const std::vector<int> cell_list(cells.begin(), cells.end());
+            std::vector<double> rs(cell_list.size());
+            Details::parallelFor(cell_list.size(), 1024, [&](const int count)
+            {
+                const double depth = UgGridHelpers::cellCenterDepth(grid, cell_list[count]);
                 rs[count] = rs_func(depth, oil_pressure[count], temperature[count], gas_saturation[count]);
-            }
+            });
             return rs;
         }
 
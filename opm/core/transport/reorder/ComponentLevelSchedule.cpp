@@ -0,0 +1,109 @@
+/*
+  Copyright 2017 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+#include <opm/core/transport/reorder/ComponentLevelSchedule.hpp>
+#include <opm/grid/UnstructuredGrid.h>
+
+#include <algorithm>
+#include <cassert>
+
+
+namespace Opm
+{
+
+    const int ComponentLevelSchedule::minimumParallelLevelSize;
+
+
+    void ComponentLevelSchedule::compute(const UnstructuredGrid& grid,
+                                         const int* sequence,
+                                         const int* components,
+                                         const int num_components)
+    {
+        // Build the cell neighbour graph from the face topology.
+        const int nc = grid.number_of_cells;
+        ia_.resize(nc + 1);
+        ja_.resize(grid.cell_facepos[nc]);
+        int p = 0;
+        ia_[0] = 0;
+        for (int cell = 0; cell < nc; ++cell) {
+            for (int i = grid.cell_facepos[cell]; i < grid.cell_facepos[cell + 1]; ++i) {
+                const int f = grid.cell_faces[i];
+                const int other = grid.face_cells[2*f] == cell
+                    ? grid.face_cells[2*f + 1] : grid.face_cells[2*f];
+                if (other >= 0) {
+                    ja_[p++] = other;
+                }
+            }
+            ia_[cell + 1] = p;
+        }
+        compute(nc, ia_.data(), ja_.data(), sequence, components, num_components);
+    }
+
+
+    void ComponentLevelSchedule::compute(const int num_cells,
+                                         const int* ia,
+                                         const int* ja,
+                                         const int* sequence,
+                                         const int* components,
+                                         const int num_components)
+    {
+        comp_of_cell_.assign(num_cells, -1);
+        for (int comp = 0; comp < num_components; ++comp) {
+            for (int p = components[comp]; p < components[comp + 1]; ++p) {
+                comp_of_cell_[sequence[p]] = comp;
+            }
+        }
+
+        // Components are topologically sorted, so a single pass in
+        // sequence order sees the final level of all earlier components.
+        level_.resize(num_components);
+        int num_levels = 0;
+        for (int comp = 0; comp < num_components; ++comp) {
+            int level = 0;
+            for (int p = components[comp]; p < components[comp + 1]; ++p) {
+                const int cell = sequence[p];
+                for (int j = ia[cell]; j < ia[cell + 1]; ++j) {
+                    const int other_comp = comp_of_cell_[ja[j]];
+                    if (other_comp >= 0 && other_comp < comp) {
+                        level = std::max(level, level_[other_comp] + 1);
+                    }
+                }
+            }
+            level_[comp] = level;
+            num_levels = std::max(num_levels, level + 1);
+        }
+
+        // Bucket the components by level, keeping sequence order.
+        level_ptr_.assign(num_levels + 1, 0);
+        for (int comp = 0; comp < num_components; ++comp) {
+            ++level_ptr_[level_[comp] + 1];
+        }
+        for (int level = 0; level < num_levels; ++level) {
+            level_ptr_[level + 1] += level_ptr_[level];
+        }
+        assert(level_ptr_[num_levels] == num_components);
+        level_components_.resize(num_components);
+        std::vector<int> pos(level_ptr_.begin(), level_ptr_.end() - 1);
+        for (int comp = 0; comp < num_components; ++comp) {
+            level_components_[pos[level_[comp]]++] = comp;
+        }
+    }
+
+} // namespace Opm
@@ -0,0 +1,155 @@
+/*
+  Copyright 2017 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_COMPONENTLEVELSCHEDULE_HEADER_INCLUDED
+#define OPM_COMPONENTLEVELSCHEDULE_HEADER_INCLUDED
+
+#include <exception>
+#include <vector>
+
+#if HAVE_OPENMP
+#include <omp.h>
+#endif // HAVE_OPENMP
+
+struct UnstructuredGrid;
+
+namespace Opm
+{
+
+    /// Level (wavefront) schedule for the strongly connected
+    /// components of a reordered cell sequence.
+    ///
+    /// Given the output of compute_sequence(), every component is
+    /// assigned the level 1 + max(level of neighbouring components
+    /// that come earlier in the sequence), where two components are
+    /// neighbours if any of their cells share a face. Components in
+    /// the same level therefore never touch each other, and solving
+    /// the levels in order, with the components of each level in any
+    /// order or concurrently, sees exactly the same neighbour values
+    /// as the sequential sweep over the components. Note that this is
+    /// stricter than using the upwind graph alone: faces with zero
+    /// flux also order their cells, since solvers may still read
+    /// neighbour state across them.
+    class ComponentLevelSchedule
+    {
+    public:
+        /// Compute the schedule for the faces of a grid.
+        /// \param[in] grid            grid the sequence was computed for
+        /// \param[in] sequence        cell permutation from compute_sequence()
+        /// \param[in] components      component pointers from compute_sequence()
+        /// \param[in] num_components  number of components
+        void compute(const UnstructuredGrid& grid,
+                     const int* sequence,
+                     const int* components,
+                     const int num_components);
+
+        /// Compute the schedule for an arbitrary cell neighbour graph,
+        /// given in compressed form: the neighbours of cell i are
+        /// ja[ia[i] .. ia[i+1]-1]. Each connection may be given in
+        /// one or both directions.
+        void compute(const int num_cells,
+                     const int* ia,
+                     const int* ja,
+                     const int* sequence,
+                     const int* components,
+                     const int num_components);
+
+        /// Number of levels.
+        int numLevels() const
+        {
+            return level_ptr_.empty() ? 0 : static_cast<int>(level_ptr_.size()) - 1;
+        }
+
+        /// Level pointers: the components of level l are
+        /// levelComponents()[levelPointers()[l] .. levelPointers()[l+1]-1].
+        const std::vector<int>& levelPointers() const
+        {
+            return level_ptr_;
+        }
+
+        /// Components ordered by level, in sequence order within a level.
+        const std::vector<int>& levelComponents() const
+        {
+            return level_components_;
+        }
+
+        /// Call solve_component(comp) for all components, one level
+        /// after the other. The components of a level are processed
+        /// by parallel threads if OpenMP is available and the level
+        /// has at least minimumParallelLevelSize components. An
+        /// exception thrown by any component is rethrown after its
+        /// level is done.
+        template <class ComponentSolver>
+        void run(const ComponentSolver& solve_component) const
+        {
+            std::exception_ptr error;
+            const int num_levels = numLevels();
+            for (int level = 0; level < num_levels; ++level) {
+                const int begin = level_ptr_[level];
+                const int end = level_ptr_[level + 1];
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(dynamic, 16) if (end - begin >= minimumParallelLevelSize)
+#endif // HAVE_OPENMP
+                for (int i = begin; i < end; ++i) {
+                    try {
+                        solve_component(level_components_[i]);
+                    } catch (...) {
+#if HAVE_OPENMP
+#pragma omp critical(ComponentLevelScheduleError)
+#endif // HAVE_OPENMP
+                        {
+                            if (!error) {
+                                error = std::current_exception();
+                            }
+                        }
+                    }
+                }
+                if (error) {
+                    std::rethrow_exception(error);
+                }
+            }
+        }
+
+        /// True if run() may use more than one thread.
+        static bool parallelRunAvailable()
+        {
+#if HAVE_OPENMP
+            return omp_get_max_threads() > 1 && !omp_in_parallel();
+#else
+            return false;
+#endif // HAVE_OPENMP
+        }
+
+        /// Levels smaller than this are solved by the calling thread only.
+        static const int minimumParallelLevelSize = 32;
+
+    private:
+        std::vector<int> level_ptr_;
+        std::vector<int> level_components_;
+
+        // Workspace, kept to avoid reallocation between calls.
+        std::vector<int> comp_of_cell_;
+        std::vector<int> level_;
+        std::vector<int> ia_;
+        std::vector<int> ja_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_COMPONENTLEVELSCHEDULE_HEADER_INCLUDED
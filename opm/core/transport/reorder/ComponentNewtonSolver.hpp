@@ -0,0 +1,193 @@
+/*
+  Copyright 2017 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_COMPONENTNEWTONSOLVER_HEADER_INCLUDED
+#define OPM_COMPONENTNEWTONSOLVER_HEADER_INCLUDED
+
+#include <opm/common/utility/platform_dependent/disable_warnings.h>
+#include <Eigen/Dense>
+#include <Eigen/Sparse>
+#include <Eigen/SparseLU>
+#include <opm/common/utility/platform_dependent/reenable_warnings.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace Opm
+{
+
+    /// Newton solver for the coupled equations of all cells in a
+    /// strongly connected component of a reordered transport problem.
+    ///
+    /// Instead of sweeping over the cells of the component with
+    /// single-cell solves until the sweeps stop changing anything,
+    /// the residuals of all cells are assembled into one system with
+    /// BlockSize unknowns per cell, which is solved by a dense LU
+    /// factorisation for small components and by a sparse LU
+    /// factorisation for large ones.
+    ///
+    /// The Problem type passed to solve() must provide
+    ///
+    ///     void assemble(int cell, ComponentNewtonSolver::System& sys);
+    ///     bool converged(int cell, const double* residual);
+    ///     void update(int cell, const double* dx);
+    ///
+    /// where assemble() adds the residual of a cell and its jacobian
+    /// blocks (with respect to the cell itself and to its neighbours)
+    /// to sys, converged() checks the residual of a cell, and update()
+    /// applies x -= dx to the unknowns of a cell. Blocks are given in
+    /// row-major order; blocks for cells outside the component are
+    /// ignored.
+    ///
+    /// The solver holds no state between calls, so one instance may
+    /// be used from several threads at once.
+    template <int BlockSize>
+    class ComponentNewtonSolver
+    {
+    public:
+        /// Linear system for one Newton iteration.
+        class System
+        {
+        public:
+            /// Residual of a cell, BlockSize entries, to be added to.
+            double* residual(const int cell)
+            {
+                return &residual_[BlockSize*localIndex(cell)];
+            }
+
+            /// Whether a cell belongs to the component.
+            bool contains(const int cell) const
+            {
+                return localIndex(cell) >= 0;
+            }
+
+            /// Add the derivatives of the residual of row_cell with
+            /// respect to the unknowns of col_cell.
+            void addJacobian(const int row_cell, const int col_cell, const double* block)
+            {
+                const int col = localIndex(col_cell);
+                if (col < 0) {
+                    return;
+                }
+                const int row = localIndex(row_cell);
+                for (int i = 0; i < BlockSize; ++i) {
+                    for (int j = 0; j < BlockSize; ++j) {
+                        triplets_.emplace_back(BlockSize*row + i, BlockSize*col + j, block[BlockSize*i + j]);
+                    }
+                }
+            }
+
+        private:
+            friend class ComponentNewtonSolver;
+
+            int localIndex(const int cell) const
+            {
+                const auto it = std::lower_bound(index_.begin(), index_.end(), std::make_pair(cell, -1));
+                return (it != index_.end() && it->first == cell) ? it->second : -1;
+            }
+
+            // Sorted (cell, position in component) pairs.
+            std::vector<std::pair<int, int>> index_;
+            Eigen::VectorXd residual_;
+            std::vector<Eigen::Triplet<double>> triplets_;
+        };
+
+        /// Construct solver.
+        /// \param[in] max_iterations  maximum number of Newton iterations
+        /// \param[in] max_dense_size  components with at most this many
+        ///                            unknowns use a dense factorisation
+        explicit ComponentNewtonSolver(const int max_iterations = 30,
+                                       const int max_dense_size = 200)
+            : max_iterations_(max_iterations),
+              max_dense_size_(max_dense_size)
+        {
+        }
+
+        /// Solve the component. Returns the number of Newton
+        /// iterations used, or -1 if the iteration did not converge or
+        /// a linear system could not be solved. In the latter case the
+        /// unknowns are left at the last iterate.
+        template <class Problem>
+        int solve(Problem& problem, const int num_cells, const int* cells) const
+        {
+            const int n = BlockSize*num_cells;
+            System sys;
+            sys.index_.resize(num_cells);
+            for (int i = 0; i < num_cells; ++i) {
+                sys.index_[i] = std::make_pair(cells[i], i);
+            }
+            std::sort(sys.index_.begin(), sys.index_.end());
+            Eigen::VectorXd dx(n);
+            for (int iter = 0; ; ++iter) {
+                sys.residual_.setZero(n);
+                sys.triplets_.clear();
+                for (int i = 0; i < num_cells; ++i) {
+                    problem.assemble(cells[i], sys);
+                }
+                bool converged = true;
+                for (int i = 0; i < num_cells && converged; ++i) {
+                    converged = problem.converged(cells[i], &sys.residual_[BlockSize*i]);
+                }
+                if (converged) {
+                    return iter;
+                }
+                if (iter == max_iterations_ || !solveLinear(sys, n, dx)) {
+                    return -1;
+                }
+                for (int i = 0; i < num_cells; ++i) {
+                    problem.update(cells[i], &dx[BlockSize*i]);
+                }
+            }
+        }
+
+    private:
+        int max_iterations_;
+        int max_dense_size_;
+
+        bool solveLinear(const System& sys, const int n, Eigen::VectorXd& dx) const
+        {
+            if (n <= max_dense_size_) {
+                Eigen::MatrixXd jac = Eigen::MatrixXd::Zero(n, n);
+                for (const auto& t : sys.triplets_) {
+                    jac(t.row(), t.col()) += t.value();
+                }
+                const Eigen::FullPivLU<Eigen::MatrixXd> lu(jac);
+                if (!lu.isInvertible()) {
+                    return false;
+                }
+                dx = lu.solve(sys.residual_);
+            } else {
+                Eigen::SparseMatrix<double> jac(n, n);
+                jac.setFromTriplets(sys.triplets_.begin(), sys.triplets_.end());
+                Eigen::SparseLU<Eigen::SparseMatrix<double>> lu;
+                lu.analyzePattern(jac);
+                lu.factorize(jac);
+                if (lu.info() != Eigen::Success) {
+                    return false;
+                }
+                dx = lu.solve(sys.residual_);
+            }
+            return dx.allFinite();
+        }
+    };
+
+} // namespace Opm
+
+#endif // OPM_COMPONENTNEWTONSOLVER_HEADER_INCLUDED
@@ -0,0 +1,233 @@
+/*
+  Copyright 2017 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+#include <opm/core/transport/reorder/ReorderSequenceCache.hpp>
+#include <opm/core/transport/reorder/tarjan.h>
+#include <opm/grid/UnstructuredGrid.h>
+
+#include <algorithm>
+#include <cassert>
+
+
+namespace Opm
+{
+
+    namespace
+    {
+        // Sign of the flux over an interior face, 0 on the boundary.
+        signed char faceSign(const UnstructuredGrid& grid, const double* flux, const int f)
+        {
+            if (grid.face_cells[2*f] < 0 || grid.face_cells[2*f + 1] < 0) {
+                return 0;
+            }
+            return flux[f] > 0.0 ? 1 : (flux[f] < 0.0 ? -1 : 0);
+        }
+    }
+
+
+    ReorderSequenceCache::ReorderSequenceCache(const double max_changed_fraction,
+                                               const double max_repair_fraction)
+        : max_changed_fraction_(max_changed_fraction),
+          max_repair_fraction_(max_repair_fraction),
+          workspace_(true),
+          grid_(0),
+          num_cells_(0),
+          num_faces_(0),
+          num_computed_(0),
+          num_reused_(0),
+          num_repaired_(0)
+    {
+    }
+
+
+    ReorderSequenceCache::UpdateType
+    ReorderSequenceCache::update(const UnstructuredGrid& grid, const double* flux)
+    {
+        if (grid_ != &grid
+            || num_cells_ != grid.number_of_cells
+            || num_faces_ != grid.number_of_faces) {
+            computeFull(grid, flux);
+            return Computed;
+        }
+
+        // Compare the sign pattern with the cached one.
+        changed_faces_.clear();
+        for (int f = 0; f < num_faces_; ++f) {
+            const signed char s = faceSign(grid, flux, f);
+            if (s != sign_[f]) {
+                changed_faces_.push_back(f);
+                sign_[f] = s;
+            }
+        }
+        if (changed_faces_.empty()) {
+            ++num_reused_;
+            return Reused;
+        }
+        if (changed_faces_.size() > max_changed_fraction_*num_faces_ || !repair(grid, flux)) {
+            computeFull(grid, flux);
+            return Computed;
+        }
+        ++num_repaired_;
+        return Repaired;
+    }
+
+
+    void ReorderSequenceCache::clear()
+    {
+        grid_ = 0;
+        num_cells_ = 0;
+        num_faces_ = 0;
+        sequence_.clear();
+        components_.clear();
+        workspace_.clear();
+    }
+
+
+    void ReorderSequenceCache::computeFull(const UnstructuredGrid& grid, const double* flux)
+    {
+        grid_ = &grid;
+        num_cells_ = grid.number_of_cells;
+        num_faces_ = grid.number_of_faces;
+
+        workspace_.compute(grid, flux);
+        sequence_.assign(workspace_.sequence().begin(), workspace_.sequence().end());
+        components_.assign(workspace_.components().begin(), workspace_.components().end());
+
+        sign_.resize(num_faces_);
+        for (int f = 0; f < num_faces_; ++f) {
+            sign_[f] = faceSign(grid, flux, f);
+        }
+        comp_of_cell_.resize(num_cells_);
+        setComponentOfCells(0, numComponents());
+        local_index_.assign(num_cells_, -1);
+        ++num_computed_;
+    }
+
+
+    bool ReorderSequenceCache::repair(const UnstructuredGrid& grid, const double* flux)
+    {
+        // Find the range [lo, hi] of components whose order or
+        // connectivity may have changed. The signs are already updated.
+        int lo = numComponents();
+        int hi = -1;
+        for (const int f : changed_faces_) {
+            const int c0 = grid.face_cells[2*f];
+            const int c1 = grid.face_cells[2*f + 1];
+            if (c0 < 0 || c1 < 0) {
+                continue;
+            }
+            const int k0 = comp_of_cell_[c0];
+            const int k1 = comp_of_cell_[c1];
+            if (k0 == k1) {
+                // The component may have split.
+                lo = std::min(lo, k0);
+                hi = std::max(hi, k0);
+            } else if (sign_[f] != 0) {
+                const int k_up = sign_[f] > 0 ? k0 : k1;
+                const int k_down = sign_[f] > 0 ? k1 : k0;
+                if (k_up > k_down) {
+                    lo = std::min(lo, k_down);
+                    hi = std::max(hi, k_up);
+                }
+            }
+            // A face that stopped carrying flux between two components
+            // only removes a dependency; the order stays valid.
+        }
+        if (hi < 0) {
+            return true;
+        }
+
+        const int begin = components_[lo];
+        const int end = components_[hi + 1];
+        const int n = end - begin;
+        if (n > max_repair_fraction_*num_cells_) {
+            return false;
+        }
+
+        // Upwind graph restricted to the cells of the region, as in
+        // make_upwind_graph(): the upwind neighbours of each cell.
+        cells_.assign(sequence_.begin() + begin, sequence_.begin() + end);
+        for (int i = 0; i < n; ++i) {
+            local_index_[cells_[i]] = i;
+        }
+        ia_.resize(n + 1);
+        ja_.clear();
+        ia_[0] = 0;
+        for (int i = 0; i < n; ++i) {
+            const int cell = cells_[i];
+            for (int j = grid.cell_facepos[cell]; j < grid.cell_facepos[cell + 1]; ++j) {
+                const int f = grid.cell_faces[j];
+                const bool first = (grid.face_cells[2*f] == cell);
+                const int other = first ? grid.face_cells[2*f + 1] : grid.face_cells[2*f];
+                if (other < 0 || local_index_[other] < 0) {
+                    continue;
+                }
+                const double theflux = first ? flux[f] : -flux[f];
+                if (theflux < 0.0) {
+                    ja_.push_back(local_index_[other]);
+                }
+            }
+            ia_[i + 1] = ja_.size();
+        }
+        for (int i = 0; i < n; ++i) {
+            local_index_[cells_[i]] = -1;
+        }
+
+        vert_.resize(n);
+        comp_.resize(n + 1);
+        work_.resize(3*n);
+        int ncomp = 0;
+        tarjan(n, ia_.data(), ja_.empty() ? 0 : ja_.data(),
+               vert_.data(), comp_.data(), &ncomp, work_.data());
+
+        // Splice the new order of the region into the sequence.
+        for (int p = 0; p < n; ++p) {
+            sequence_[begin + p] = cells_[vert_[p]];
+        }
+        const int old_ncomp = hi - lo + 1;
+        if (ncomp == old_ncomp) {
+            for (int k = 1; k <= ncomp; ++k) {
+                components_[lo + k] = begin + comp_[k];
+            }
+            setComponentOfCells(lo, hi + 1);
+        } else {
+            components_.erase(components_.begin() + lo + 1, components_.begin() + hi + 2);
+            std::vector<int> new_ptr(ncomp);
+            for (int k = 1; k <= ncomp; ++k) {
+                new_ptr[k - 1] = begin + comp_[k];
+            }
+            components_.insert(components_.begin() + lo + 1, new_ptr.begin(), new_ptr.end());
+            setComponentOfCells(lo, numComponents());
+        }
+        assert(components_[lo + ncomp] == end);
+        return true;
+    }
+
+
+    void ReorderSequenceCache::setComponentOfCells(const int first_comp, const int last_comp)
+    {
+        for (int comp = first_comp; comp < last_comp; ++comp) {
+            for (int p = components_[comp]; p < components_[comp + 1]; ++p) {
+                comp_of_cell_[sequence_[p]] = comp;
+            }
+        }
+    }
+
+} // namespace Opm
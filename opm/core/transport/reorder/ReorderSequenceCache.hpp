@@ -0,0 +1,120 @@
+/*
+  Copyright 2017 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_REORDERSEQUENCECACHE_HEADER_INCLUDED
+#define OPM_REORDERSEQUENCECACHE_HEADER_INCLUDED
+
+#include <opm/core/transport/reorder/ReorderWorkspace.hpp>
+
+#include <vector>
+
+struct UnstructuredGrid;
+
+namespace Opm
+{
+
+    /// Keeps the result of compute_sequence() between calls, and
+    /// reuses it for later flux fields when possible.
+    ///
+    /// The sign pattern of the flux is stored per face. If it is
+    /// unchanged, the previous sequence is returned as is. If only a
+    /// few faces changed sign, the sequence is repaired locally: only
+    /// the components between the lowest and highest ones involved in
+    /// a flipped face that breaks the current order (or inside which
+    /// a face changed) are recomputed, from the upwind graph
+    /// restricted to their cells. Everything else keeps its place.
+    /// The result has the same strongly connected components as a
+    /// full recomputation, in a valid (though not necessarily the
+    /// same) topological order. If too many faces change, or the
+    /// region to repair is too large, a full recomputation is done,
+    /// searching the graph in the order of the previous full one (see
+    /// ReorderWorkspace).
+    class ReorderSequenceCache
+    {
+    public:
+        /// How the last call to update() obtained the sequence.
+        enum UpdateType { Computed, Reused, Repaired };
+
+        /// Construct cache.
+        /// \param[in] max_changed_fraction  at most this fraction of the
+        ///                                  faces may change sign for a
+        ///                                  local repair to be tried
+        /// \param[in] max_repair_fraction   at most this fraction of the
+        ///                                  cells may be in the repaired
+        ///                                  region
+        explicit ReorderSequenceCache(const double max_changed_fraction = 0.05,
+                                      const double max_repair_fraction = 0.25);
+
+        /// Compute the sequence for a flux field, with the same
+        /// conventions as compute_sequence().
+        UpdateType update(const UnstructuredGrid& grid, const double* flux);
+
+        /// Forget the cached sequence, the next update() is a full one.
+        void clear();
+
+        /// Causal cell permutation.
+        const std::vector<int>& sequence() const { return sequence_; }
+
+        /// Component pointers into sequence(), numComponents() + 1 entries.
+        const std::vector<int>& components() const { return components_; }
+
+        /// Number of strongly connected components.
+        int numComponents() const { return static_cast<int>(components_.size()) - 1; }
+
+        /// Number of update() calls that did a full computation,
+        /// reused the sequence, or repaired it.
+        int numComputed() const { return num_computed_; }
+        int numReused() const { return num_reused_; }
+        int numRepaired() const { return num_repaired_; }
+
+    private:
+        void computeFull(const UnstructuredGrid& grid, const double* flux);
+        bool repair(const UnstructuredGrid& grid, const double* flux);
+        void setComponentOfCells(const int first_comp, const int last_comp);
+
+        double max_changed_fraction_;
+        double max_repair_fraction_;
+        ReorderWorkspace workspace_;
+
+        const UnstructuredGrid* grid_;
+        int num_cells_;
+        int num_faces_;
+        std::vector<signed char> sign_;
+        std::vector<int> changed_faces_;
+        std::vector<int> sequence_;
+        std::vector<int> components_;
+        std::vector<int> comp_of_cell_;
+
+        // Workspace for local repairs.
+        std::vector<int> local_index_;
+        std::vector<int> cells_;
+        std::vector<int> ia_;
+        std::vector<int> ja_;
+        std::vector<int> vert_;
+        std::vector<int> comp_;
+        std::vector<int> work_;
+
+        int num_computed_;
+        int num_reused_;
+        int num_repaired_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_REORDERSEQUENCECACHE_HEADER_INCLUDED
@@ -19,7 +19,6 @@
 
 #include "config.h"
 #include <opm/core/transport/reorder/ReorderSolverInterface.hpp>
-#include <opm/core/transport/reorder/reordersequence.h>
 #include <opm/grid/UnstructuredGrid.h>
 #include <opm/grid/utility/StopWatch.hpp>
 
@@ -30,18 +29,31 @@
 
 void Opm::ReorderSolverInterface::reorderAndTransport(const UnstructuredGrid& grid, const double* darcyflux)
 {
-    // Compute reordered sequence of single-cell problems
-    sequence_.resize(grid.number_of_cells);
-    components_.resize(grid.number_of_cells + 1);
-    int ncomponents;
+    // Compute reordered sequence of single-cell problems, reusing
+    // the previous one if the flux directions allow it.
     time::StopWatch clock;
     clock.start();
-    compute_sequence(&grid, darcyflux, &sequence_[0], &components_[0], &ncomponents);
+    ordering_.update(grid, darcyflux);
     clock.stop();
     std::cout << "Topological sort took: " << clock.secsSinceStart() << " seconds." << std::endl;
 
-    // Make vector's size match actual used data.
-    components_.resize(ncomponents + 1);
+    const std::vector<int>& seq = ordering_.sequence();
+    const std::vector<int>& comps = ordering_.components();
+    const int ncomponents = ordering_.numComponents();
+
+    // Solve independent components concurrently, level by level.
+    if (supportsConcurrentSolves() && ComponentLevelSchedule::parallelRunAvailable()) {
+        schedule_.compute(grid, seq.data(), comps.data(), ncomponents);
+        schedule_.run([this, &seq, &comps](const int comp) {
+                const int comp_size = comps[comp + 1] - comps[comp];
+                if (comp_size == 1) {
+                    solveSingleCell(seq[comps[comp]]);
+                } else {
+                    solveMultiCell(comp_size, &seq[comps[comp]]);
+                }
+            });
+        return;
+    }
 
     // Invoke appropriate solve method for each interdependent component.
     for (int comp = 0; comp < ncomponents; ++comp) {
@@ -55,11 +67,11 @@ void Opm::ReorderSolverInterface::reorderAndTransport(const UnstructuredGrid& gr
         }
 #endif
 #endif
-	const int comp_size = components_[comp + 1] - components_[comp];
+	const int comp_size = comps[comp + 1] - comps[comp];
 	if (comp_size == 1) {
-	    solveSingleCell(sequence_[components_[comp]]);
+	    solveSingleCell(seq[comps[comp]]);
 	} else {
-	    solveMultiCell(comp_size, &sequence_[components_[comp]]);
+	    solveMultiCell(comp_size, &seq[comps[comp]]);
 	}
     }
 }
@@ -67,11 +79,11 @@ void Opm::ReorderSolverInterface::reorderAndTransport(const UnstructuredGrid& gr
 
 const std::vector<int>& Opm::ReorderSolverInterface::sequence() const
 {
-    return sequence_;
+    return ordering_.sequence();
 }
 
 
 const std::vector<int>& Opm::ReorderSolverInterface::components() const
 {
-    return components_;
+    return ordering_.components();
 }
@@ -20,6 +20,9 @@
 #ifndef OPM_REORDERSOLVERINTERFACE_HEADER_INCLUDED
 #define OPM_REORDERSOLVERINTERFACE_HEADER_INCLUDED
 
+#include <opm/core/transport/reorder/ComponentLevelSchedule.hpp>
+#include <opm/core/transport/reorder/ReorderSequenceCache.hpp>
+
 #include <vector>
 
 struct UnstructuredGrid;
@@ -35,6 +38,14 @@ namespace Opm
     /// class.) The reorderAndTransport() method is provided as an aid
     /// to implementing solve() in subclasses, together with the
     /// sequence() and components() methods for accessing the ordering.
+    /// The ordering is kept between calls, and only recomputed where
+    /// the flux directions changed (see ReorderSequenceCache).
+    ///
+    /// Subclasses whose single- and multi-cell solves only write
+    /// data belonging to the cells they are given may override
+    /// supportsConcurrentSolves() to return true. The components are
+    /// then solved level by level (see ComponentLevelSchedule), with
+    /// independent components of a level solved by parallel threads.
     class ReorderSolverInterface
     {
     public:
@@ -42,13 +53,14 @@ namespace Opm
     private:
 	virtual void solveSingleCell(const int cell) = 0;
 	virtual void solveMultiCell(const int num_cells, const int* cells) = 0;
+        virtual bool supportsConcurrentSolves() const { return false; }
     protected:
 	void reorderAndTransport(const UnstructuredGrid& grid, const double* darcyflux);
         const std::vector<int>& sequence() const;
         const std::vector<int>& components() const;
     private:
-        std::vector<int> sequence_;
-        std::vector<int> components_;
+        ReorderSequenceCache ordering_;
+        ComponentLevelSchedule schedule_;
     };
 
 
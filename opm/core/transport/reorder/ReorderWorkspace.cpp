@@ -0,0 +1,115 @@
+/*
+  Copyright 2017 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+#include <opm/core/transport/reorder/ReorderWorkspace.hpp>
+#include <opm/core/transport/reorder/tarjan.h>
+#include <opm/grid/UnstructuredGrid.h>
+
+#include <cassert>
+
+
+namespace Opm
+{
+
+    ReorderWorkspace::ReorderWorkspace(const bool renumber)
+        : renumber_(renumber),
+          num_cells_(0)
+    {
+    }
+
+
+    void ReorderWorkspace::compute(const UnstructuredGrid& grid, const double* flux)
+    {
+        compute(grid.number_of_cells, grid.cell_facepos, grid.cell_faces, grid.face_cells, flux);
+    }
+
+
+    void ReorderWorkspace::compute(const int num_cells,
+                                   const int* cell_facepos,
+                                   const int* cell_faces,
+                                   const int* face_cells,
+                                   const double* flux)
+    {
+        if (num_cells != num_cells_) {
+            num_cells_ = num_cells;
+            clear();
+        }
+        const bool permuted = renumber_ && int(old_index_.size()) == num_cells;
+
+        // Upwind graph, as in make_upwind_graph(): row i holds the
+        // upwind neighbours of the i'th cell in the search numbering.
+        ia_.resize(num_cells + 1);
+        ja_.resize(cell_facepos[num_cells]);
+        int p = 0;
+        ia_[0] = 0;
+        for (int i = 0; i < num_cells; ++i) {
+            const int cell = permuted ? old_index_[i] : i;
+            for (int j = cell_facepos[cell]; j < cell_facepos[cell + 1]; ++j) {
+                const int f = cell_faces[j];
+                const int c0 = face_cells[2*f];
+                const int c1 = face_cells[2*f + 1];
+                if (c0 < 0 || c1 < 0) {
+                    continue;
+                }
+                const bool first = (c0 == cell);
+                const double theflux = first ? flux[f] : -flux[f];
+                if (theflux < 0.0) {
+                    const int other = first ? c1 : c0;
+                    ja_[p++] = permuted ? new_index_[other] : other;
+                }
+            }
+            ia_[i + 1] = p;
+        }
+
+        work_.resize(3*num_cells);
+        sequence_.resize(num_cells);
+        components_.resize(num_cells + 1);
+        int ncomponents = 0;
+        if (permuted) {
+            vert_.resize(num_cells);
+            tarjan(num_cells, ia_.data(), ja_.data(), vert_.data(),
+                   components_.data(), &ncomponents, work_.data());
+            for (int k = 0; k < num_cells; ++k) {
+                sequence_[k] = old_index_[vert_[k]];
+            }
+        } else {
+            tarjan(num_cells, ia_.data(), ja_.data(), sequence_.data(),
+                   components_.data(), &ncomponents, work_.data());
+        }
+        assert(ncomponents <= num_cells);
+        components_.resize(ncomponents + 1);
+
+        if (renumber_) {
+            old_index_.assign(sequence_.begin(), sequence_.end());
+            new_index_.resize(num_cells);
+            for (int k = 0; k < num_cells; ++k) {
+                new_index_[old_index_[k]] = k;
+            }
+        }
+    }
+
+
+    void ReorderWorkspace::clear()
+    {
+        old_index_.clear();
+        new_index_.clear();
+    }
+
+} // namespace Opm
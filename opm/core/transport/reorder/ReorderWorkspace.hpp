@@ -0,0 +1,101 @@
+/*
+  Copyright 2017 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_REORDERWORKSPACE_HEADER_INCLUDED
+#define OPM_REORDERWORKSPACE_HEADER_INCLUDED
+
+#include <vector>
+
+struct UnstructuredGrid;
+
+namespace Opm
+{
+
+    /// Reusable workspace for computing the causal cell sequence of a
+    /// flux field, with the same result conventions as
+    /// compute_sequence().
+    ///
+    /// compute_sequence() allocates the upwind graph and the work
+    /// arrays of tarjan() on every call. This class keeps them between
+    /// calls, so that repeated orderings on the same grid do not touch
+    /// the allocator. The upwind graph is also built in a single pass
+    /// over the cell faces.
+    ///
+    /// With renumbering enabled, the graph given to tarjan() numbers
+    /// the cells in the order of the previous sequence. The search
+    /// then visits the cells roughly in topological order, so the
+    /// graph and the work arrays are traversed nearly sequentially
+    /// even if the grid numbering is unrelated to the flow direction
+    /// (as for corner-point grids with faults and inactive cells).
+    /// The components are the same as without renumbering, but the
+    /// order among independent components may differ.
+    class ReorderWorkspace
+    {
+    public:
+        /// Construct workspace.
+        /// \param[in] renumber  search the graph in the order of the
+        ///                      previous sequence
+        explicit ReorderWorkspace(const bool renumber = false);
+
+        /// Compute the sequence for a flux field on a grid.
+        void compute(const UnstructuredGrid& grid, const double* flux);
+
+        /// Compute the sequence for a flux field on a grid given by
+        /// its cell-face and face-cell topology, with the conventions
+        /// of UnstructuredGrid (face_cells has two entries per face,
+        /// -1 outside the domain).
+        void compute(const int num_cells,
+                     const int* cell_facepos,
+                     const int* cell_faces,
+                     const int* face_cells,
+                     const double* flux);
+
+        /// Forget the previous sequence used for renumbering.
+        void clear();
+
+        /// Causal cell permutation.
+        const std::vector<int>& sequence() const { return sequence_; }
+
+        /// Component pointers into sequence(), numComponents() + 1 entries.
+        const std::vector<int>& components() const { return components_; }
+
+        /// Number of strongly connected components.
+        int numComponents() const { return static_cast<int>(components_.size()) - 1; }
+
+    private:
+        bool renumber_;
+        int num_cells_;
+
+        // Upwind graph in the search numbering.
+        std::vector<int> ia_;
+        std::vector<int> ja_;
+        std::vector<int> work_;
+        std::vector<int> vert_;
+
+        // Search numbering: position of each cell, and cell at each position.
+        std::vector<int> new_index_;
+        std::vector<int> old_index_;
+
+        std::vector<int> sequence_;
+        std::vector<int> components_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_REORDERWORKSPACE_HEADER_INCLUDED
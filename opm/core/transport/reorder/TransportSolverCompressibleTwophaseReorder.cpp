@@ -23,6 +23,7 @@
 #include <opm/core/props/BlackoilPropertiesInterface.hpp>
 #include <opm/grid/UnstructuredGrid.h>
 #include <opm/core/transport/reorder/reordersequence.h>
+#include <opm/core/transport/reorder/ComponentNewtonSolver.hpp>
 #include <opm/common/utility/numeric/RootFinders.hpp>
 #include <opm/core/utility/miscUtilities.hpp>
 #include <opm/core/utility/miscUtilitiesBlackoil.hpp>
@@ -199,8 +200,83 @@ namespace Opm
     }
 
 
+    // Coupled residual for all cells of a strongly connected component,
+    // in the form required by ComponentNewtonSolver. Each cell uses the
+    // single-cell Residual with the fractional flows of its upwind
+    // neighbours as they currently are.
+    struct TransportSolverCompressibleTwophaseReorder::MultiCellProblem
+    {
+        TransportSolverCompressibleTwophaseReorder& tm;
+        const std::vector<int>& pos;
+
+        void assemble(const int cell, ComponentNewtonSolver<1>::System& sys)
+        {
+            Residual res(tm, cell);
+            const double s = tm.saturation_[cell];
+            *sys.residual(cell) = res(s);
+            const double diag = 1.0 + res.dtpv*res.outflux*tm.fracFlowDerivative(s, cell) + res.comp_term;
+            sys.addJacobian(cell, cell, &diag);
+            const int np = tm.props_.numPhases();
+            for (int i = tm.grid_.cell_facepos[cell]; i < tm.grid_.cell_facepos[cell+1]; ++i) {
+                const int f = tm.grid_.cell_faces[i];
+                const bool first = (cell == tm.grid_.face_cells[2*f]);
+                const double flux = first ? tm.darcyflux_[f] : -tm.darcyflux_[f];
+                const int other = first ? tm.grid_.face_cells[2*f+1] : tm.grid_.face_cells[2*f];
+                if (other != -1 && flux < 0.0 && pos[other] != -1) {
+                    const double b_face = tm.A_[np*np*other + 0];
+                    const double offdiag = res.dtpv*res.B_cell*b_face*flux
+                        *tm.fracFlowDerivative(tm.saturation_[other], other);
+                    sys.addJacobian(cell, other, &offdiag);
+                }
+            }
+        }
+
+        bool converged(const int /* cell */, const double* residual)
+        {
+            return std::fabs(*residual) < tm.tol_;
+        }
+
+        void update(const int cell, const double* dx)
+        {
+            double& s = tm.saturation_[cell];
+            s = std::max(0.0, std::min(1.0, s - *dx));
+            tm.fractionalflow_[cell] = tm.fracFlow(s, cell);
+        }
+    };
+
+
+    bool TransportSolverCompressibleTwophaseReorder::solveMultiCellNewton(const int num_cells, const int* cells)
+    {
+        std::vector<double> s0(num_cells);
+        std::vector<int> pos(grid_.number_of_cells, -1);
+        for (int i = 0; i < num_cells; ++i) {
+            const int cell = cells[i];
+            pos[cell] = i;
+            s0[i] = saturation_[cell];
+            fractionalflow_[cell] = fracFlow(saturation_[cell], cell);
+        }
+        MultiCellProblem problem{ *this, pos };
+        if (ComponentNewtonSolver<1>(maxit_).solve(problem, num_cells, cells) < 0) {
+            // Restore the initial state for the fallback solver.
+            for (int i = 0; i < num_cells; ++i) {
+                const int cell = cells[i];
+                saturation_[cell] = s0[i];
+                fractionalflow_[cell] = fracFlow(s0[i], cell);
+            }
+            return false;
+        }
+        return true;
+    }
+
+
     void TransportSolverCompressibleTwophaseReorder::solveMultiCell(const int num_cells, const int* cells)
     {
+        // Solve the component as one coupled system first. Only if
+        // that fails do we fall back to the sweeps below.
+        if (solveMultiCellNewton(num_cells, cells)) {
+            return;
+        }
+
         // Experiment: when a cell changes more than the tolerance,
         //             mark all downwind cells as needing updates. After
         //             computing a single update in each cell, use marks
@@ -316,6 +392,22 @@ namespace Opm
     }
 
 
+    double TransportSolverCompressibleTwophaseReorder::fracFlowDerivative(double s, int cell) const
+    {
+        double sat[2] = { s, 1.0 - s };
+        double mob[2];
+        double dmob[4];
+        props_.relperm(1, sat, &cell, mob, dmob);
+        // dmob is in Fortran order, and ds_o/ds_w = -1.
+        const double dmobw = (dmob[0] - dmob[2])/visc_[2*cell + 0];
+        const double dmobo = (dmob[1] - dmob[3])/visc_[2*cell + 1];
+        mob[0] /= visc_[2*cell + 0];
+        mob[1] /= visc_[2*cell + 1];
+        const double tmob = mob[0] + mob[1];
+        return (dmobw*mob[1] - mob[0]*dmobo)/(tmob*tmob);
+    }
+
+
 
 
 
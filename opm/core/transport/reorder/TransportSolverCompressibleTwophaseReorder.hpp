@@ -87,6 +87,10 @@ namespace Opm
     private:
         virtual void solveSingleCell(const int cell);
         virtual void solveMultiCell(const int num_cells, const int* cells);
+        // The cell solves only write per-cell data, and read the
+        // relperm functions through const methods.
+        virtual bool supportsConcurrentSolves() const { return true; }
+        bool solveMultiCellNewton(const int num_cells, const int* cells);
         void solveSingleCellGravity(const std::vector<int>& cells,
                                     const int pos,
                                     const double* gravflux);
@@ -127,7 +131,9 @@ namespace Opm
         std::vector<int> ja_downw_;
 
         struct Residual;
+        struct MultiCellProblem;
         double fracFlow(double s, int cell) const;
+        double fracFlowDerivative(double s, int cell) const;
 
         struct GravityResidual;
         void mobility(double s, int cell, double* mob) const;
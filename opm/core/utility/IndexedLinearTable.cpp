@@ -0,0 +1,92 @@
+/*
+  Copyright 2017 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+#include <opm/core/utility/IndexedLinearTable.hpp>
+#include <opm/common/ErrorMacros.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+
+namespace Opm
+{
+
+    IndexedLinearTable::IndexedLinearTable()
+        : inv_width_(0.0),
+          num_buckets_(0),
+          last_segment_(-1)
+    {
+    }
+
+
+    IndexedLinearTable::IndexedLinearTable(const std::vector<double>& x, const std::vector<double>& y)
+        : x_(x),
+          y_(y),
+          inv_width_(0.0),
+          num_buckets_(1),
+          last_segment_(static_cast<int>(x.size()) - 2)
+    {
+        const int n = x.size();
+        if (n < 2 || y.size() != x.size()) {
+            OPM_THROW(std::runtime_error, "IndexedLinearTable needs at least two points and as many "
+                      "y values as x values, got " << n << " x and " << y.size() << " y values.");
+        }
+
+        // Same expression as in linearInterpolationDerivative().
+        slope_.resize(n - 1);
+        double min_length = std::numeric_limits<double>::max();
+        for (int k = 0; k < n - 1; ++k) {
+            if (x[k + 1] < x[k]) {
+                OPM_THROW(std::runtime_error, "IndexedLinearTable needs nondecreasing x values.");
+            }
+            slope_[k] = (y[k + 1] - y[k])/(x[k + 1] - x[k]);
+            if (x[k + 1] > x[k]) {
+                min_length = std::min(min_length, x[k + 1] - x[k]);
+            }
+        }
+
+        // Buckets no wider than the shortest segment, within limits.
+        const double range = x[n - 1] - x[0];
+        if (range > 0.0) {
+            const int max_buckets = 16*n + 64;
+            num_buckets_ = static_cast<int>(std::min(double(max_buckets), std::ceil(range/min_length)));
+            num_buckets_ = std::max(num_buckets_, 1);
+            inv_width_ = num_buckets_/range;
+        }
+
+        // Every breakpoint falling in an earlier bucket than x is
+        // smaller than x, so counting them gives a segment at or
+        // before the one containing x.
+        bucket_segment_.assign(num_buckets_, 0);
+        for (int k = 1; k < n - 1; ++k) {
+            const double t = (x[k] - x[0])*inv_width_;
+            const int bucket = t > 0.0 ? (t < num_buckets_ ? static_cast<int>(t) : num_buckets_ - 1) : 0;
+            if (bucket + 1 < num_buckets_) {
+                ++bucket_segment_[bucket + 1];
+            }
+        }
+        for (int b = 1; b < num_buckets_; ++b) {
+            bucket_segment_[b] += bucket_segment_[b - 1];
+        }
+    }
+
+} // namespace Opm
@@ -0,0 +1,90 @@
+/*
+  Copyright 2017 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_INDEXEDLINEARTABLE_HEADER_INCLUDED
+#define OPM_INDEXEDLINEARTABLE_HEADER_INCLUDED
+
+#include <vector>
+
+namespace Opm
+{
+
+    /// Piecewise linear table with constant-time lookup.
+    ///
+    /// Gives the same results as linearInterpolation() and
+    /// linearInterpolationDerivative() (including linear extrapolation
+    /// with the end segments outside the table), but instead of a
+    /// binary search for every evaluation, the segment is found from a
+    /// uniform grid of buckets laid over the table range at
+    /// construction. Each bucket stores the segment containing its left
+    /// end. As long as the buckets are no wider than the shortest
+    /// segment, at most one step forward from there is needed. The
+    /// number of buckets is limited relative to the table size; for
+    /// tables with a few very short segments a lookup may take a few
+    /// more steps, but the result is unchanged.
+    class IndexedLinearTable
+    {
+    public:
+        /// Empty table, must not be evaluated.
+        IndexedLinearTable();
+
+        /// Table through the points (x[i], y[i]). The x values must be
+        /// nondecreasing, and there must be at least two points.
+        IndexedLinearTable(const std::vector<double>& x, const std::vector<double>& y);
+
+        /// Whether the table has been given any points.
+        bool empty() const { return x_.empty(); }
+
+        /// Interpolated value at x.
+        double operator()(const double x) const
+        {
+            const int k = segment(x);
+            return slope_[k]*(x - x_[k]) + y_[k];
+        }
+
+        /// Slope of the segment used at x.
+        double derivative(const double x) const
+        {
+            return slope_[segment(x)];
+        }
+
+    private:
+        int segment(const double x) const
+        {
+            const double t = (x - x_[0])*inv_width_;
+            const int bucket = t > 0.0 ? (t < num_buckets_ ? static_cast<int>(t) : num_buckets_ - 1) : 0;
+            int k = bucket_segment_[bucket];
+            while (k < last_segment_ && x >= x_[k + 1]) {
+                ++k;
+            }
+            return k;
+        }
+
+        std::vector<double> x_;
+        std::vector<double> y_;
+        std::vector<double> slope_;
+        std::vector<int> bucket_segment_;
+        double inv_width_;
+        int num_buckets_;
+        int last_segment_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_INDEXEDLINEARTABLE_HEADER_INCLUDED
@@ -24,7 +24,6 @@
 #include <cmath>
 #include <iostream>
 #include <vector>
-#include <opm/common/utility/numeric/linearInterpolation.hpp>
 #include <opm/common/ErrorMacros.hpp>
 #include <opm/common/Exceptions.hpp>
 
@@ -122,25 +121,36 @@ namespace Opm
     double
     PolymerProperties::shearVrf(const double velocity) const
     {
-        return Opm::linearInterpolation(water_vel_vals_, shear_vrf_vals_, velocity);
+        return shear_vrf_table_(velocity);
     }
 
     double
     PolymerProperties::shearVrfWithDer(const double velocity, double& der) const
     {
-        der =  Opm::linearInterpolationDerivative(water_vel_vals_, shear_vrf_vals_, velocity);
-        return Opm::linearInterpolation(water_vel_vals_, shear_vrf_vals_, velocity);
+        der = shear_vrf_table_.derivative(velocity);
+        return shear_vrf_table_(velocity);
     }
 
     double PolymerProperties::viscMult(double c) const
     {
-        return Opm::linearInterpolation(c_vals_visc_, visc_mult_vals_, c);
+        return visc_mult_table_(c);
     }
 
     double PolymerProperties::viscMultWithDer(double c, double* der) const
     {
-        *der = Opm::linearInterpolationDerivative(c_vals_visc_, visc_mult_vals_, c);
-        return Opm::linearInterpolation(c_vals_visc_, visc_mult_vals_, c);
+        *der = visc_mult_table_.derivative(c);
+        return visc_mult_table_(c);
+    }
+
+    void PolymerProperties::initTables()
+    {
+        // Tables that are not given (such as PLYSHLOG) stay empty.
+        auto makeTable = [](const std::vector<double>& x, const std::vector<double>& y) {
+            return x.size() < 2 ? IndexedLinearTable() : IndexedLinearTable(x, y);
+        };
+        visc_mult_table_ = makeTable(c_vals_visc_, visc_mult_vals_);
+        ads_table_ = makeTable(c_vals_ads_, ads_vals_);
+        shear_vrf_table_ = makeTable(water_vel_vals_, shear_vrf_vals_);
     }
 
     void PolymerProperties::simpleAdsorption(double c, double& c_ads) const
@@ -158,9 +168,9 @@ namespace Opm
     void PolymerProperties::simpleAdsorptionBoth(double c, double& c_ads,
                                                  double& dc_ads_dc, bool if_with_der) const
     {
-        c_ads = Opm::linearInterpolation(c_vals_ads_, ads_vals_, c);;
+        c_ads = ads_table_(c);
         if (if_with_der) {
-            dc_ads_dc = Opm::linearInterpolationDerivative(c_vals_ads_, ads_vals_, c);
+            dc_ads_dc = ads_table_.derivative(c);
         } else {
             dc_ads_dc = 0.;
         }
@@ -20,6 +20,7 @@
 #ifndef OPM_POLYMERPROPERTIES_HEADER_INCLUDED
 #define OPM_POLYMERPROPERTIES_HEADER_INCLUDED
 
+#include <opm/core/utility/IndexedLinearTable.hpp>
 #include <opm/parser/eclipse/Deck/Deck.hpp>
 #include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
 #include <opm/parser/eclipse/EclipseState/Tables/PlyadsTable.hpp>
@@ -90,6 +91,7 @@ namespace Opm
               water_vel_vals_(water_vel_vals),
               shear_vrf_vals_(shear_vrf_vals)
         {
+            initTables();
         }
 
         PolymerProperties(const Opm::Deck& deck, const Opm::EclipseState& eclipseState)
@@ -125,6 +127,7 @@ namespace Opm
             ads_index_ = ads_index;
             water_vel_vals_ = water_vel_vals;
             shear_vrf_vals_ = shear_vrf_vals;
+            initTables();
         }
 
         void readFromDeck(const Opm::Deck& deck, const Opm::EclipseState& eclipseState)
@@ -214,6 +217,7 @@ namespace Opm
                     has_plyshlog_ref_temp_ = false;
                 }
             }
+            initTables();
         }
 
         double cMax() const;
@@ -395,6 +399,9 @@ namespace Opm
         std::vector<double> ads_vals_;
         std::vector<double> water_vel_vals_;
         std::vector<double> shear_vrf_vals_;
+        IndexedLinearTable visc_mult_table_;
+        IndexedLinearTable ads_table_;
+        IndexedLinearTable shear_vrf_table_;
 
         double plyshlog_ref_conc_;
         double plyshlog_ref_salinity_;
@@ -403,6 +410,9 @@ namespace Opm
         bool has_plyshlog_ref_temp_;
 
 
+        /// Set up the lookup tables from the table columns above.
+        void initTables();
+
         void simpleAdsorptionBoth(double c, double& c_ads,
                                   double& dc_ads_dc, bool if_with_der) const;
         void adsorptionBoth(double c, double cmax,
@@ -425,3 +425,245 @@ BOOST_AUTO_TEST_CASE(nonZeros)
     BOOST_CHECK_EQUAL(s.nonZeros(), 4);
 }
 
+
+
+namespace
+{
+    Sp uncachedProduct(const Sp& lhs, const Sp& rhs)
+    {
+        Sp x;
+        fastSparseProduct<Sp, Sp, Sp>(lhs, rhs, x);
+        return x;
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(SparsePlanCache)
+{
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> a1(3,3);
+    a1 <<
+        1.0, 0.0, 2.0,
+        0.0, 1.0, 0.0,
+        3.0, 0.0, 2.0;
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> b1(3,3);
+    b1 <<
+        0.0, 4.0, 0.0,
+        1.0, 0.0, 0.0,
+        0.0, 0.0, 5.0;
+    Sp as(a1.sparseView());
+    Sp bs(b1.sparseView());
+    as.makeCompressed();
+    bs.makeCompressed();
+
+    resetSparsePlanCacheCounters();
+
+    // Products with an unregistered lhs are not cached.
+    Sp x;
+    fastSparseProduct(as, bs, x);
+    BOOST_CHECK(x == uncachedProduct(as, bs));
+    BOOST_CHECK_EQUAL(sparsePlanCacheCounters().product_misses, 0u);
+
+    // Same rhs pattern, different values: second product is a hit.
+    registerStableSparseOperator(as);
+    fastSparseProduct(as, bs, x);
+    BOOST_CHECK(x == uncachedProduct(as, bs));
+    const Sp bs2 = bs * 2.0;
+    fastSparseProduct(as, bs2, x);
+    BOOST_CHECK(x == uncachedProduct(as, bs2));
+
+    SparsePlanCacheCounters c = sparsePlanCacheCounters();
+    BOOST_CHECK_EQUAL(c.product_misses, 1u);
+    BOOST_CHECK_EQUAL(c.product_hits, 1u);
+    BOOST_CHECK_CLOSE(c.productHitRate(), 50.0 / 100.0, 1e-12);
+
+    // Products of an Eigen matrix with a sparse AutoDiffMatrix use the
+    // registered operator itself.
+    (as * Mat(bs)).toSparse(x);
+    BOOST_CHECK(x == uncachedProduct(as, bs));
+    BOOST_CHECK_EQUAL(sparsePlanCacheCounters().product_hits, 2u);
+
+    unregisterStableSparseOperator(as);
+    fastSparseProduct(as, bs, x);
+    BOOST_CHECK(x == uncachedProduct(as, bs));
+    BOOST_CHECK_EQUAL(sparsePlanCacheCounters().product_hits, 2u);
+
+    // The cache can be switched off.
+    registerStableSparseOperator(as);
+    const std::size_t max_bytes = sparsePlanCacheMaxBytes();
+    setSparsePlanCacheMaxBytes(0);
+    fastSparseProduct(as, bs, x);
+    BOOST_CHECK(x == uncachedProduct(as, bs));
+    BOOST_CHECK_EQUAL(sparsePlanCacheCounters().product_hits, 2u);
+    setSparsePlanCacheMaxBytes(max_bytes);
+    unregisterStableSparseOperator(as);
+}
+
+
+BOOST_AUTO_TEST_CASE(SparsePlanCacheZeros)
+{
+    // As without the cache, entries whose contributions cancel are
+    // stored, entries with only zero contributions are not.
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> r1(3,3);
+    r1 <<
+        1.0, 1.0, 1.0,
+        0.0, 0.0, 0.0,
+        0.0, 0.0, 0.0;
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> c1(3,3);
+    c1 <<
+        1.0, 0.0, 0.0,
+       -1.0, 0.0, 0.0,
+        0.0, 0.0, 0.0;
+    Sp rs(r1.sparseView());
+    Sp cs(c1.sparseView());
+    cs.insert(2, 1) = 0.0;
+    rs.makeCompressed();
+    cs.makeCompressed();
+
+    registerStableSparseOperator(rs);
+    resetSparsePlanCacheCounters();
+    Sp x;
+    for (int k = 0; k < 2; ++k) {
+        fastSparseProduct(rs, cs, x);
+        BOOST_CHECK(x == uncachedProduct(rs, cs));
+        BOOST_CHECK_EQUAL(x.nonZeros(), 1);
+        BOOST_CHECK_EQUAL(x.coeff(0, 0), 0.0);
+    }
+    BOOST_CHECK_EQUAL(sparsePlanCacheCounters().product_hits, 1u);
+    unregisterStableSparseOperator(rs);
+}
+
+
+BOOST_AUTO_TEST_CASE(SparsePlanCacheBytes)
+{
+    const int n = 100;
+    Sp id(n, n);
+    id.setIdentity();
+    id.makeCompressed();
+    Sp single1(n, n);
+    single1.insert(1, 1) = 2.0;
+    single1.makeCompressed();
+    Sp single2(n, n);
+    single2.insert(2, 2) = 3.0;
+    single2.makeCompressed();
+    registerStableSparseOperator(id);
+
+    // Room for one plan only: alternating patterns always miss, and the
+    // memory held stays within the limit.
+    Sp x;
+    const std::size_t bytes_before = detail::SparsePlanCache::instance().bytes();
+    fastSparseProduct(id, single1, x);
+    const std::size_t plan_bytes = detail::SparsePlanCache::instance().bytes() - bytes_before;
+    BOOST_CHECK(plan_bytes > 0);
+    const std::size_t max_bytes = sparsePlanCacheMaxBytes();
+    setSparsePlanCacheMaxBytes(plan_bytes);
+    resetSparsePlanCacheCounters();
+    for (int k = 0; k < 5; ++k) {
+        fastSparseProduct(id, single2, x);
+        BOOST_CHECK(x == uncachedProduct(id, single2));
+        fastSparseProduct(id, single1, x);
+        BOOST_CHECK(x == uncachedProduct(id, single1));
+        BOOST_CHECK(detail::SparsePlanCache::instance().bytes() <= plan_bytes);
+    }
+    BOOST_CHECK_EQUAL(sparsePlanCacheCounters().product_hits, 0u);
+
+    // Room for both.
+    setSparsePlanCacheMaxBytes(2 * plan_bytes);
+    resetSparsePlanCacheCounters();
+    for (int k = 0; k < 5; ++k) {
+        fastSparseProduct(id, single2, x);
+        fastSparseProduct(id, single1, x);
+    }
+    BOOST_CHECK_EQUAL(sparsePlanCacheCounters().product_misses, 1u);
+    BOOST_CHECK_EQUAL(sparsePlanCacheCounters().product_hits, 9u);
+
+    // A plan larger than the limit is used, but not kept.
+    setSparsePlanCacheMaxBytes(plan_bytes / 2);
+    resetSparsePlanCacheCounters();
+    fastSparseProduct(id, id, x);
+    BOOST_CHECK(x == uncachedProduct(id, id));
+    fastSparseProduct(id, id, x);
+    BOOST_CHECK_EQUAL(sparsePlanCacheCounters().product_misses, 2u);
+    BOOST_CHECK(detail::SparsePlanCache::instance().bytes() <= plan_bytes / 2);
+
+    setSparsePlanCacheMaxBytes(max_bytes);
+    unregisterStableSparseOperator(id);
+}
+
+
+BOOST_AUTO_TEST_CASE(SparsePlanCacheChangedOperator)
+{
+    // An operator whose pattern changes while registered, keeping its
+    // dimensions and number of nonzeros, finds a plan that does not fit.
+    // This is detected and the product computed without the plan.
+    const int m = 10;
+    Sp d(m, m);
+    Sp d2(m, m);
+    for (int i = 0; i < m; ++i) {
+        d.insert(i, i) = 1.0;
+        d2.insert(i == 1 ? 2 : i, i) = 1.0;
+    }
+    d.makeCompressed();
+    d2.makeCompressed();
+    const Sp rhs = d;
+
+    registerStableSparseOperator(d);
+    Sp x;
+    fastSparseProduct(d, rhs, x);
+    d = d2;
+    resetSparsePlanCacheCounters();
+    fastSparseProduct(d, rhs, x);
+    BOOST_CHECK(x == uncachedProduct(d2, rhs));
+    BOOST_CHECK_EQUAL(sparsePlanCacheCounters().product_hits, 1u);
+
+    // The plan was dropped.
+    fastSparseProduct(d, rhs, x);
+    BOOST_CHECK(x == uncachedProduct(d2, rhs));
+    BOOST_CHECK_EQUAL(sparsePlanCacheCounters().product_misses, 1u);
+    unregisterStableSparseOperator(d);
+}
+
+
+
+BOOST_AUTO_TEST_CASE(LargeSparseKernels)
+{
+    // Large enough for the column-partitioned kernels to run threaded
+    // when OpenMP is enabled.
+    const int n = 30000;
+    std::vector<Eigen::Triplet<double> > t;
+    for (int i = 0; i < n; ++i) {
+        t.emplace_back(i, i, 2.0 + (i % 7));
+        if (i > 0) {
+            t.emplace_back(i, i - 1, -1.0 - (i % 3));
+        }
+        if (i + 3 < n) {
+            t.emplace_back(i, i + 3, 0.5);
+        }
+    }
+    Sp a(n, n);
+    a.setFromTriplets(t.begin(), t.end());
+    Sp b = a.transpose();
+    b.makeCompressed();
+
+    Eigen::Array<double, Eigen::Dynamic, 1> d1 = Eigen::Array<double, Eigen::Dynamic, 1>::LinSpaced(n, 1.0, 2.0);
+    const Mat am(a);
+    const Mat bm(b);
+    const Mat dm(d1.matrix().asDiagonal());
+
+    Sp x;
+    (am * bm).toSparse(x);
+    BOOST_CHECK(x.isApprox(Sp(a * b), 1e-14));
+    (am + bm).toSparse(x);
+    BOOST_CHECK(x.isApprox(Sp(a + b), 1e-14));
+    (dm * am).toSparse(x);
+    BOOST_CHECK(x.isApprox(Sp(spdiag(d1) * a), 1e-14));
+    (bm * dm).toSparse(x);
+    BOOST_CHECK(x.isApprox(Sp(b * spdiag(d1)), 1e-14));
+
+    // Cached product with a registered operator, threaded numeric phase.
+    registerStableSparseOperator(a);
+    for (int k = 0; k < 2; ++k) {
+        fastSparseProduct(a, b, x);
+        BOOST_CHECK(x == uncachedProduct(a, b));
+    }
+    unregisterStableSparseOperator(a);
+}
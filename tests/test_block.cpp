@@ -23,6 +23,7 @@
 #define BOOST_TEST_MODULE AutoDiffBlockTest
 
 #include <opm/autodiff/AutoDiffBlock.hpp>
+#include <opm/autodiff/AutoDiffBlockExpressions.hpp>
 
 #include <boost/test/unit_test.hpp>
 
@@ -365,3 +366,47 @@ BOOST_AUTO_TEST_CASE(Pow)
 }
 
 
+
+BOOST_AUTO_TEST_CASE(FusedExpressions)
+{
+    typedef AutoDiffBlock<double> ADB;
+
+    ADB::V vx(3);
+    vx << 0.2, 1.2, 13.4;
+
+    ADB::V vy(3);
+    vy << 2.0, 3.0, 0.5;
+
+    ADB::V vc(3);
+    vc << 0.5, 4.0, 1.5;
+
+    std::vector<ADB::V> vals{ vx, vy };
+    std::vector<ADB> vars = ADB::variables(vals);
+
+    const ADB x = vars[0];
+    const ADB y = vars[1];
+
+    // A variable with sparse jacobians.
+    Eigen::SparseMatrix<double> S(3, 3);
+    S.insert(0, 0) = 1.0;
+    S.insert(1, 0) = -1.0;
+    S.insert(1, 2) = 2.0;
+    S.insert(2, 1) = 0.5;
+    S.makeCompressed();
+    const ADB z = S * x + y;
+
+    const double tolerance = 1e-14;
+
+    checkClose(evaluateFused(lazy(x) * y * z), x * y * z, tolerance);
+    checkClose(evaluateFused(lazy(x) + y - z), x + y - z, tolerance);
+    checkClose(evaluateFused(lazy(x) / y), x / y, tolerance);
+    checkClose(evaluateFused(vc * (lazy(z) - x)), vc * (z - x), tolerance);
+    checkClose(evaluateFused(2.0 * lazy(x) * x + z / vc), x * x * 2.0 + z / vc, tolerance);
+    checkClose(evaluateFused(-lazy(y) * z), (y * z) * (-1.0), tolerance);
+
+    // Expressions without any jacobians give constants.
+    const ADB c = ADB::constant(vc);
+    const ADB cc = evaluateFused(lazy(c) * c);
+    BOOST_CHECK(cc.derivative().empty());
+    BOOST_CHECK(cc.value().isApprox(vc * vc, tolerance));
+}
@@ -0,0 +1,169 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE ComponentLevelScheduleTest
+
+#include <opm/core/transport/reorder/ComponentLevelSchedule.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    // Neighbour graph of an nx-by-ny cartesian grid, cell = i + nx*j.
+    void cartesianGraph(const int nx, const int ny, std::vector<int>& ia, std::vector<int>& ja)
+    {
+        ia.assign(1, 0);
+        ja.clear();
+        for (int j = 0; j < ny; ++j) {
+            for (int i = 0; i < nx; ++i) {
+                if (i > 0)      ja.push_back(i - 1 + nx*j);
+                if (i < nx - 1) ja.push_back(i + 1 + nx*j);
+                if (j > 0)      ja.push_back(i + nx*(j - 1));
+                if (j < ny - 1) ja.push_back(i + nx*(j + 1));
+                ia.push_back(ja.size());
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(Chain)
+{
+    // 1d flow from left to right: every cell depends on the previous one.
+    std::vector<int> ia, ja;
+    cartesianGraph(5, 1, ia, ja);
+    const std::vector<int> sequence = { 0, 1, 2, 3, 4 };
+    const std::vector<int> components = { 0, 1, 2, 3, 4, 5 };
+    Opm::ComponentLevelSchedule schedule;
+    schedule.compute(5, ia.data(), ja.data(), sequence.data(), components.data(), 5);
+    BOOST_CHECK_EQUAL(schedule.numLevels(), 5);
+    const std::vector<int> expected_ptr = { 0, 1, 2, 3, 4, 5 };
+    BOOST_CHECK(schedule.levelPointers() == expected_ptr);
+}
+
+BOOST_AUTO_TEST_CASE(DiagonalWavefront)
+{
+    // Diagonal flow on a 4x4 grid, cells sequenced along the diagonals.
+    // The levels should be the anti-diagonals i + j.
+    const int n = 4;
+    std::vector<int> ia, ja;
+    cartesianGraph(n, n, ia, ja);
+    std::vector<int> sequence;
+    for (int d = 0; d < 2*n - 1; ++d) {
+        for (int i = 0; i < n; ++i) {
+            const int j = d - i;
+            if (j >= 0 && j < n) {
+                sequence.push_back(i + n*j);
+            }
+        }
+    }
+    std::vector<int> components(n*n + 1);
+    std::iota(components.begin(), components.end(), 0);
+    Opm::ComponentLevelSchedule schedule;
+    schedule.compute(n*n, ia.data(), ja.data(), sequence.data(), components.data(), n*n);
+    BOOST_REQUIRE_EQUAL(schedule.numLevels(), 2*n - 1);
+    const auto& ptr = schedule.levelPointers();
+    const auto& comps = schedule.levelComponents();
+    for (int level = 0; level < schedule.numLevels(); ++level) {
+        BOOST_CHECK_EQUAL(ptr[level + 1] - ptr[level], std::min(level + 1, 2*n - 1 - level));
+        for (int k = ptr[level]; k < ptr[level + 1]; ++k) {
+            const int cell = sequence[components[comps[k]]];
+            BOOST_CHECK_EQUAL(cell % n + cell / n, level);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(MultiCellComponent)
+{
+    // Cells 1 and 2 form a loop, cell 0 is upstream and cell 3 downstream.
+    // Cell 4 is isolated and can go in the first level.
+    std::vector<int> ia, ja;
+    cartesianGraph(4, 1, ia, ja);
+    ia.push_back(ia.back());
+    const std::vector<int> sequence = { 0, 4, 1, 2, 3 };
+    const std::vector<int> components = { 0, 1, 2, 4, 5 };
+    Opm::ComponentLevelSchedule schedule;
+    schedule.compute(5, ia.data(), ja.data(), sequence.data(), components.data(), 4);
+    BOOST_CHECK_EQUAL(schedule.numLevels(), 3);
+    const std::vector<int> expected_ptr = { 0, 2, 3, 4 };
+    const std::vector<int> expected_comps = { 0, 1, 2, 3 };
+    BOOST_CHECK(schedule.levelPointers() == expected_ptr);
+    BOOST_CHECK(schedule.levelComponents() == expected_comps);
+}
+
+BOOST_AUTO_TEST_CASE(RunRespectsLevels)
+{
+    const int n = 64;
+    std::vector<int> ia, ja;
+    cartesianGraph(n, n, ia, ja);
+    std::vector<int> sequence;
+    for (int d = 0; d < 2*n - 1; ++d) {
+        for (int i = 0; i < n; ++i) {
+            const int j = d - i;
+            if (j >= 0 && j < n) {
+                sequence.push_back(i + n*j);
+            }
+        }
+    }
+    std::vector<int> components(n*n + 1);
+    std::iota(components.begin(), components.end(), 0);
+    Opm::ComponentLevelSchedule schedule;
+    schedule.compute(n*n, ia.data(), ja.data(), sequence.data(), components.data(), n*n);
+
+    // Every cell must be solved after its left and lower neighbours.
+    std::vector<std::atomic<int>> done(n*n);
+    for (auto& d : done) {
+        d = 0;
+    }
+    std::atomic<int> violations(0);
+    schedule.run([&](const int comp) {
+            const int cell = sequence[components[comp]];
+            const int i = cell % n;
+            const int j = cell / n;
+            if ((i > 0 && !done[cell - 1]) || (j > 0 && !done[cell - n])) {
+                ++violations;
+            }
+            done[cell] = 1;
+        });
+    BOOST_CHECK_EQUAL(violations, 0);
+    BOOST_CHECK(std::all_of(done.begin(), done.end(), [](const std::atomic<int>& d) { return d == 1; }));
+}
+
+BOOST_AUTO_TEST_CASE(RunRethrows)
+{
+    std::vector<int> ia, ja;
+    cartesianGraph(3, 1, ia, ja);
+    const std::vector<int> sequence = { 0, 1, 2 };
+    const std::vector<int> components = { 0, 1, 2, 3 };
+    Opm::ComponentLevelSchedule schedule;
+    schedule.compute(3, ia.data(), ja.data(), sequence.data(), components.data(), 3);
+    int solved = 0;
+    BOOST_CHECK_THROW(schedule.run([&](const int comp) {
+                if (comp == 1) {
+                    throw std::runtime_error("no convergence");
+                }
+                ++solved;
+            }), std::runtime_error);
+    BOOST_CHECK_EQUAL(solved, 1);
+}
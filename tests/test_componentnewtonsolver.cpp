@@ -0,0 +1,155 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE ComponentNewtonSolverTest
+
+#include <opm/core/transport/reorder/ComponentNewtonSolver.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    // Implicit upwind transport around a loop of cells, cell i
+    // receiving flow from cell i-1 (and cell 0 from the last cell),
+    // plus an injector in cell 0:
+    //     r_i(s) = s_i - s0_i + dt*(f(s_i) - f(s_{i-1}) - q_i)
+    // with f(s) = s^2/(s^2 + (1-s)^2).
+    struct LoopProblem
+    {
+        std::vector<double> s;
+        std::vector<double> s0;
+        double dt;
+
+        static double f(const double s)
+        {
+            return s*s/(s*s + (1-s)*(1-s));
+        }
+        static double df(const double s)
+        {
+            const double d = s*s + (1-s)*(1-s);
+            return (2*s*d - s*s*(4*s - 2))/(d*d);
+        }
+        int upwind(const int cell) const
+        {
+            return cell == 0 ? int(s.size()) - 1 : cell - 1;
+        }
+        double residual(const int cell) const
+        {
+            const double q = cell == 0 ? 1.0 : 0.0;
+            return s[cell] - s0[cell] + dt*(f(s[cell]) - f(s[upwind(cell)]) - q*(1.0 - f(s[cell])));
+        }
+
+        void assemble(const int cell, Opm::ComponentNewtonSolver<1>::System& sys)
+        {
+            const double q = cell == 0 ? 1.0 : 0.0;
+            *sys.residual(cell) += residual(cell);
+            const double diag = 1.0 + dt*(1.0 + q)*df(s[cell]);
+            sys.addJacobian(cell, cell, &diag);
+            const double offdiag = -dt*df(s[upwind(cell)]);
+            sys.addJacobian(cell, upwind(cell), &offdiag);
+        }
+        bool converged(const int, const double* r)
+        {
+            return std::fabs(*r) < 1e-10;
+        }
+        void update(const int cell, const double* dx)
+        {
+            s[cell] = std::max(0.0, std::min(1.0, s[cell] - *dx));
+        }
+    };
+
+    // Linear 2x2 block system A x = b on two coupled cells.
+    struct LinearProblem
+    {
+        double x[4] = { 0.0, 0.0, 0.0, 0.0 };
+
+        void assemble(const int cell, Opm::ComponentNewtonSolver<2>::System& sys)
+        {
+            const double diag[4] = { 4.0, 1.0, 1.0, 3.0 };
+            const double offdiag[4] = { -1.0, 0.0, 0.0, -1.0 };
+            const int other = 1 - cell;
+            double* r = sys.residual(cell);
+            r[0] = diag[0]*x[2*cell] + diag[1]*x[2*cell + 1] + offdiag[0]*x[2*other] - 1.0;
+            r[1] = diag[2]*x[2*cell] + diag[3]*x[2*cell + 1] + offdiag[3]*x[2*other + 1] - 2.0;
+            sys.addJacobian(cell, cell, diag);
+            sys.addJacobian(cell, other, offdiag);
+            // A cell outside the component is ignored.
+            sys.addJacobian(cell, 7, offdiag);
+        }
+        bool converged(const int, const double* r)
+        {
+            return std::fabs(r[0]) < 1e-12 && std::fabs(r[1]) < 1e-12;
+        }
+        void update(const int cell, const double* dx)
+        {
+            x[2*cell] -= dx[0];
+            x[2*cell + 1] -= dx[1];
+        }
+    };
+}
+
+BOOST_AUTO_TEST_CASE(NonlinearLoop)
+{
+    for (const int max_dense : { 1000, 0 }) {
+        LoopProblem problem;
+        const int n = 20;
+        problem.s.assign(n, 0.1);
+        problem.s0.assign(n, 0.1);
+        problem.dt = 0.5;
+        std::vector<int> cells(n);
+        for (int i = 0; i < n; ++i) {
+            cells[i] = i;
+        }
+        Opm::ComponentNewtonSolver<1> solver(30, max_dense);
+        const int iters = solver.solve(problem, n, cells.data());
+        BOOST_CHECK(iters > 0);
+        BOOST_CHECK(iters < 30);
+        for (int i = 0; i < n; ++i) {
+            BOOST_CHECK_SMALL(problem.residual(i), 1e-10);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(LinearBlocks)
+{
+    LinearProblem problem;
+    const int cells[] = { 1, 0 };
+    Opm::ComponentNewtonSolver<2> solver;
+    BOOST_CHECK_EQUAL(solver.solve(problem, 2, cells), 1);
+    // Solution of the symmetric system: x0 = x2, x1 = x3,
+    // 3 x0 + x1 = 1, x0 + 2 x1 = 2.
+    BOOST_CHECK_SMALL(problem.x[0], 1e-12);
+    BOOST_CHECK_CLOSE(problem.x[1], 1.0, 1e-10);
+    BOOST_CHECK_SMALL(problem.x[2], 1e-12);
+    BOOST_CHECK_CLOSE(problem.x[3], 1.0, 1e-10);
+}
+
+BOOST_AUTO_TEST_CASE(IterationLimit)
+{
+    LoopProblem problem;
+    problem.s.assign(5, 0.1);
+    problem.s0.assign(5, 0.1);
+    problem.dt = 0.5;
+    const int cells[] = { 0, 1, 2, 3, 4 };
+    Opm::ComponentNewtonSolver<1> solver(0);
+    BOOST_CHECK_EQUAL(solver.solve(problem, 5, cells), -1);
+}
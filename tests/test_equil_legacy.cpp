@@ -35,6 +35,11 @@
 
 #include <opm/parser/eclipse/Units/Units.hpp>
 
+#if HAVE_OPENMP
+#include <omp.h>
+#endif // HAVE_OPENMP
+
+#include <algorithm>
 #include <array>
 #include <iostream>
 #include <limits>
@@ -1059,4 +1064,101 @@ BOOST_AUTO_TEST_CASE (DeckWithSwatinit)
     }
 }
 
+BOOST_AUTO_TEST_CASE (DeckWithSwatinitMultipleRegions)
+{
+    // Two equilibration regions with SWATINIT, which rescales the
+    // capillary pressure in the material law manager.
+    const std::string deckString =
+        "RUNSPEC\n"
+        "DIMENS\n"
+        "1 1 20 /\n"
+        "TABDIMS\n"
+        "1 1 40 20 1 20 /\n"
+        "EQLDIMS\n"
+        "2 /\n"
+        "OIL\n"
+        "GAS\n"
+        "WATER\n"
+        "METRIC\n"
+        "GRID\n"
+        "DXV\n"
+        "1.0 /\n"
+        "DYV\n"
+        "1.0 /\n"
+        "DZV\n"
+        "20*5.0 /\n"
+        "TOPS\n"
+        "0.0 /\n"
+        "PORO\n"
+        "20*0.3 /\n"
+        "PERMX\n"
+        "20*500 /\n"
+        "PROPS\n"
+        "DENSITY\n"
+        "700 1000 1 /\n"
+        "PVTW\n"
+        "100 1 0 1 0 /\n"
+        "PVDO\n"
+        "100 1.0 1.0\n"
+        "200 0.9 1.0 /\n"
+        "PVDG\n"
+        "100 0.010 0.1\n"
+        "200 0.005 0.2 /\n"
+        "SWOF\n"
+        "0.2 0 1 0.4\n"
+        "1.0 1 0 0.1 /\n"
+        "SGOF\n"
+        "0.0 0 1 0.2\n"
+        "0.8 1 0 0.5 /\n"
+        "SWATINIT\n"
+        "5*0 10*0.5 5*1 /\n"
+        "REGIONS\n"
+        "EQLNUM\n"
+        "10*1 10*2 /\n"
+        "SOLUTION\n"
+        "EQUIL\n"
+        "50 150 50 0.25 20 0.35 1* 1* 0 /\n"
+        "50 150 60 0.25 25 0.35 1* 1* 0 /\n";
+
+    Opm::Parser parser;
+    Opm::ParseContext parseContext;
+    Opm::Deck deck = parser.parseString(deckString, parseContext);
+    Opm::EclipseState eclipseState(deck, parseContext);
+    Opm::GridManager gm(eclipseState.getInputGrid());
+    const UnstructuredGrid& grid = *(gm.c_grid());
+    std::vector<int> compressedToCartesianIdx
+        = Opm::compressedToCartesian(grid.number_of_cells, grid.global_cell);
+    FluidSystem::initFromDeck(deck, eclipseState);
+
+    // The result must not depend on the number of threads.
+    typedef Opm::EQUIL::DeckDependent::InitialStateComputer<FluidSystem> Computer;
+#if HAVE_OPENMP
+    const int num_threads = omp_get_max_threads();
+    omp_set_num_threads(1);
+#endif // HAVE_OPENMP
+    MaterialLawManager serialManager;
+    serialManager.initFromDeck(deck, eclipseState, compressedToCartesianIdx);
+    const Computer serial(serialManager, eclipseState, grid, 9.81, true);
+#if HAVE_OPENMP
+    omp_set_num_threads(std::max(num_threads, 4));
+#endif // HAVE_OPENMP
+    MaterialLawManager parallelManager;
+    parallelManager.initFromDeck(deck, eclipseState, compressedToCartesianIdx);
+    const Computer parallel(parallelManager, eclipseState, grid, 9.81, true);
+#if HAVE_OPENMP
+    omp_set_num_threads(num_threads);
+#endif // HAVE_OPENMP
+
+    for (int phase = 0; phase < 3; ++phase) {
+        for (int c = 0; c < grid.number_of_cells; ++c) {
+            BOOST_CHECK_EQUAL(parallel.press()[phase][c], serial.press()[phase][c]);
+            BOOST_CHECK_EQUAL(parallel.saturation()[phase][c], serial.saturation()[phase][c]);
+        }
+    }
+    // SWATINIT is honoured in the oil zone of both regions.
+    for (int c = 7; c < 12; ++c) {
+        CHECK(parallel.saturation()[FluidSystem::waterPhaseIdx][c], 0.5, 1.0e-3);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
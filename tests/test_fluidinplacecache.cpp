@@ -0,0 +1,143 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE FluidInPlaceCacheTest
+
+#include <opm/autodiff/FluidInPlaceCache.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+namespace
+{
+    typedef Opm::FluidInPlaceCache::ADB ADB;
+    typedef Opm::FluidInPlaceCache::V V;
+
+    struct Quantities
+    {
+        ADB b = ADB::null();
+    };
+
+    struct State
+    {
+        State()
+            : p(4), s(4), pv(4)
+        {
+            p << 100e5, 200e5, 300e5, 400e5;
+            s << 0.2, 0.4, 0.6, 0.8;
+            pv << 1.0, 2.0, 0.5, 3.0;
+        }
+        V p;
+        V s;
+        V pv;
+    };
+
+    // Stand-ins for the PVT and rock compressibility evaluations.
+    ADB reciprocFVF(const ADB& p, const int pos)
+    {
+        const V one = V::Ones(p.size());
+        return one / (one + ((1.0 + pos) * 1e-9) * p);
+    }
+
+    ADB poroMult(const ADB& p)
+    {
+        return V::Ones(p.size()) + 1e-10 * p;
+    }
+
+    // Assemble in state x: variables with derivatives, as in the model.
+    std::vector<Quantities> assemble(const State& x, const int np)
+    {
+        std::vector<V> vals = { x.p, x.s };
+        const std::vector<ADB> vars = ADB::variables(vals);
+        std::vector<Quantities> rq(np);
+        for (int pos = 0; pos < np; ++pos) {
+            rq[pos].b = reciprocFVF(vars[0], pos);
+        }
+        return rq;
+    }
+
+    // The full evaluation of computeFluidInPlace().
+    V recomputed(const State& x, const int pos)
+    {
+        const ADB p = ADB::constant(x.p);
+        const ADB s = ADB::constant(x.s);
+        const ADB b = reciprocFVF(p, pos);
+        return (poroMult(p) * b * s * x.pv).value();
+    }
+
+    V cached(const Opm::FluidInPlaceCache& cache, const State& x, const int pos)
+    {
+        const ADB p = ADB::constant(x.p);
+        return cache.fluidInPlace(pos, poroMult(p), ADB::constant(x.s), x.pv);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(CachedEqualsRecomputed)
+{
+    const int np = 2;
+    State x;
+    Opm::FluidInPlaceCache cache;
+    BOOST_CHECK(!cache.valid());
+
+    cache.assembled(true);
+    cache.converged(assemble(x, np), np);
+    BOOST_REQUIRE(cache.valid());
+    for (int pos = 0; pos < np; ++pos) {
+        const V fip0 = cached(cache, x, pos);
+        const V fip1 = recomputed(x, pos);
+        BOOST_REQUIRE_EQUAL(fip0.size(), fip1.size());
+        for (int c = 0; c < fip0.size(); ++c) {
+            BOOST_CHECK_EQUAL(fip0[c], fip1[c]);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(Invalidation)
+{
+    const int np = 1;
+    State x;
+    Opm::FluidInPlaceCache cache;
+
+    // Converged without an assembly.
+    cache.converged(assemble(x, np), np);
+    BOOST_CHECK(!cache.valid());
+
+    // Some b carried over from an earlier iterate.
+    cache.assembled(false);
+    cache.converged(assemble(x, np), np);
+    BOOST_CHECK(!cache.valid());
+
+    cache.assembled(true);
+    cache.converged(assemble(x, np), np);
+    BOOST_CHECK(cache.valid());
+
+    // A new assembly, an update or a new step.
+    cache.assembled(true);
+    BOOST_CHECK(!cache.valid());
+    cache.converged(assemble(x, np), np);
+    cache.invalidate();
+    BOOST_CHECK(!cache.valid());
+
+    // The state changed after the assembly.
+    cache.assembled(true);
+    cache.invalidate();
+    cache.converged(assemble(x, np), np);
+    BOOST_CHECK(!cache.valid());
+}
@@ -0,0 +1,88 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE IndexedLinearTableTest
+
+#include <opm/core/utility/IndexedLinearTable.hpp>
+#include <opm/common/utility/numeric/linearInterpolation.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    void checkSameAsLinearInterpolation(const std::vector<double>& x, const std::vector<double>& y)
+    {
+        const Opm::IndexedLinearTable table(x, y);
+        const double lo = x.front() - 0.5*(x.back() - x.front());
+        const double hi = x.back() + 0.5*(x.back() - x.front());
+        const int n = 2000;
+        for (int i = 0; i <= n; ++i) {
+            const double xi = lo + (hi - lo)*i/n;
+            BOOST_CHECK_EQUAL(table(xi), Opm::linearInterpolation(x, y, xi));
+            BOOST_CHECK_EQUAL(table.derivative(xi), Opm::linearInterpolationDerivative(x, y, xi));
+        }
+        // Exactly at the breakpoints.
+        for (const double xi : x) {
+            BOOST_CHECK_EQUAL(table(xi), Opm::linearInterpolation(x, y, xi));
+            BOOST_CHECK_EQUAL(table.derivative(xi), Opm::linearInterpolationDerivative(x, y, xi));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(UniformPoints)
+{
+    std::vector<double> x, y;
+    for (int i = 0; i <= 10; ++i) {
+        x.push_back(50e5 + 10e5*i);
+        y.push_back(1.0 + 1e-3*i*i);
+    }
+    checkSameAsLinearInterpolation(x, y);
+}
+
+BOOST_AUTO_TEST_CASE(NonuniformPoints)
+{
+    // Segment lengths spanning several orders of magnitude, so that the
+    // buckets are limited and some contain several breakpoints.
+    std::vector<double> x = { 0.0 };
+    std::vector<double> y = { 0.0 };
+    double h = 1e-6;
+    for (int i = 0; i < 40; ++i) {
+        x.push_back(x.back() + h);
+        y.push_back(std::sin(x.back()));
+        h *= 1.5;
+    }
+    checkSameAsLinearInterpolation(x, y);
+}
+
+BOOST_AUTO_TEST_CASE(TwoPoints)
+{
+    checkSameAsLinearInterpolation({ 1.0, 3.0 }, { 2.0, -4.0 });
+}
+
+BOOST_AUTO_TEST_CASE(InvalidInput)
+{
+    BOOST_CHECK_THROW(Opm::IndexedLinearTable({ 1.0 }, { 1.0 }), std::runtime_error);
+    BOOST_CHECK_THROW(Opm::IndexedLinearTable({ 1.0, 2.0 }, { 1.0 }), std::runtime_error);
+    BOOST_CHECK_THROW(Opm::IndexedLinearTable({ 2.0, 1.0 }, { 1.0, 2.0 }), std::runtime_error);
+    BOOST_CHECK(Opm::IndexedLinearTable().empty());
+}
@@ -0,0 +1,140 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE LocalNewtonRegionTest
+
+#include <opm/autodiff/LocalNewtonRegion.hpp>
+#include <opm/autodiff/AutoDiffHelpers.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+namespace
+{
+    typedef Opm::LocalNewtonRegion::ADB ADB;
+    typedef Opm::LocalNewtonRegion::V V;
+
+    // A chain of n cells.
+    Opm::LocalNewtonRegion::TwoColInt chain(const int n)
+    {
+        Opm::LocalNewtonRegion::TwoColInt conn(n - 1, 2);
+        for (int i = 0; i < n - 1; ++i) {
+            conn(i, 0) = i;
+            conn(i, 1) = i + 1;
+        }
+        return conn;
+    }
+
+    Eigen::MatrixXd dense(const ADB::M& m)
+    {
+        Eigen::SparseMatrix<double> s;
+        m.toSparse(s);
+        return Eigen::MatrixXd(s);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(Select)
+{
+    Opm::LocalNewtonRegion region(8, chain(8));
+    std::vector<bool> flagged(8, false);
+    flagged[2] = true;
+    flagged[6] = true;
+
+    region.select(flagged, 0);
+    BOOST_CHECK(region.cells() == std::vector<int>({ 2, 6 }));
+
+    region.select(flagged, 1);
+    BOOST_CHECK(region.cells() == std::vector<int>({ 1, 2, 3, 5, 6, 7 }));
+
+    region.select(flagged, 2);
+    BOOST_CHECK(region.cells() == std::vector<int>({ 0, 1, 2, 3, 4, 5, 6, 7 }));
+
+    region.select(std::vector<bool>(8, false), 3);
+    BOOST_CHECK(region.cells().empty());
+}
+
+BOOST_AUTO_TEST_CASE(RestrictAndExpand)
+{
+    const int nc = 5;
+    Opm::LocalNewtonRegion region(nc, chain(nc));
+    std::vector<bool> flagged(nc, false);
+    flagged[2] = true;
+    region.select(flagged, 1);
+    BOOST_REQUIRE(region.cells() == std::vector<int>({ 1, 2, 3 }));
+
+    // Cell variables p and s, and two well variables.
+    V p(nc), s(nc), w(2);
+    p << 1.0, 2.0, 3.0, 4.0, 5.0;
+    s << 0.1, 0.2, 0.3, 0.4, 0.5;
+    w << 7.0, 8.0;
+    const std::vector<ADB> vars = ADB::variables(std::vector<V>{ p, s, w });
+
+    // Well equations connected to cells 0 and 3.
+    const std::vector<int> perf_cells = { 0, 3 };
+    const Opm::LinearisedBlackoilResidual residual = {
+        { vars[0]*vars[0] + vars[1], vars[0]*vars[1] },
+        subset(vars[0], perf_cells) + vars[2],
+        ADB::null(),
+        { 1.0, 1.0 },
+        false
+    };
+
+    const Opm::LinearisedBlackoilResidual local = region.restrict(residual);
+    BOOST_REQUIRE_EQUAL(local.material_balance_eq.size(), 2u);
+
+    const ADB& eq0 = local.material_balance_eq[0];
+    BOOST_REQUIRE_EQUAL(eq0.size(), 3);
+    BOOST_REQUIRE_EQUAL(eq0.numBlocks(), 3);
+    const Eigen::MatrixXd d00 = dense(eq0.derivative()[0]);
+    const Eigen::MatrixXd d02 = dense(eq0.derivative()[2]);
+    BOOST_REQUIRE_EQUAL(d00.rows(), 3);
+    BOOST_REQUIRE_EQUAL(d00.cols(), 3);
+    BOOST_REQUIRE_EQUAL(d02.cols(), 2);
+    for (int i = 0; i < 3; ++i) {
+        const int cell = region.cells()[i];
+        BOOST_CHECK_EQUAL(eq0.value()[i], p[cell]*p[cell] + s[cell]);
+        for (int j = 0; j < 3; ++j) {
+            BOOST_CHECK_EQUAL(d00(i, j), i == j ? 2.0*p[cell] : 0.0);
+        }
+    }
+    BOOST_CHECK_EQUAL(d02.norm(), 0.0);
+
+    // The well equations keep their rows, and lose the columns of
+    // cells outside the region.
+    const ADB& weq = local.well_flux_eq;
+    BOOST_REQUIRE_EQUAL(weq.size(), 2);
+    const Eigen::MatrixXd dw0 = dense(weq.derivative()[0]);
+    BOOST_REQUIRE_EQUAL(dw0.rows(), 2);
+    BOOST_REQUIRE_EQUAL(dw0.cols(), 3);
+    BOOST_CHECK_EQUAL(dw0(0, 0) + dw0(0, 1) + dw0(0, 2), 0.0);
+    BOOST_CHECK_EQUAL(dw0(1, 2), 1.0);
+    BOOST_CHECK_EQUAL(weq.value()[1], p[3] + w[1]);
+    BOOST_CHECK_EQUAL(local.sizeNonLinear(), 2*3 + 2);
+
+    // Expand.
+    V dx(2*3 + 2);
+    dx << 1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 9.0, 10.0;
+    const V full = region.expand(dx, 2);
+    V expected(2*nc + 2);
+    expected << 0.0, 1.0, 2.0, 3.0, 0.0,
+                0.0, 4.0, 5.0, 6.0, 0.0,
+                9.0, 10.0;
+    BOOST_CHECK((full == expected).all());
+}
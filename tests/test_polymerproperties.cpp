@@ -0,0 +1,72 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE PolymerPropertiesTest
+
+#include <opm/polymer/PolymerProperties.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+namespace
+{
+    const std::vector<double> c_vals_visc = { 0.0, 1.0, 2.0 };
+    const std::vector<double> visc_mult_vals = { 1.0, 3.0, 7.0 };
+    const std::vector<double> c_vals_ads = { 0.0, 2.0 };
+    const std::vector<double> ads_vals = { 0.0, 1.0e-5 };
+    const std::vector<double> water_vel_vals = { 0.0, 1.0 };
+    const std::vector<double> shear_vrf_vals = { 1.0, 0.5 };
+
+    void checkLookups(const Opm::PolymerProperties& props)
+    {
+        BOOST_CHECK_CLOSE(props.viscMult(0.5), 2.0, 1e-12);
+        BOOST_CHECK_CLOSE(props.viscMult(1.5), 5.0, 1e-12);
+        double der = 0.0;
+        BOOST_CHECK_CLOSE(props.viscMultWithDer(1.5, &der), 5.0, 1e-12);
+        BOOST_CHECK_CLOSE(der, 4.0, 1e-12);
+
+        double c_ads = 0.0;
+        props.adsorption(1.0, 0.0, c_ads);
+        BOOST_CHECK_CLOSE(c_ads, 0.5e-5, 1e-12);
+
+        BOOST_CHECK_CLOSE(props.shearVrf(0.5), 0.75, 1e-12);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ValueConstructor)
+{
+    const Opm::PolymerProperties props(2.0, 0.5, 1000.0, 0.1, 1.2, 1.0e-5,
+                                       Opm::PolymerProperties::Desorption,
+                                       c_vals_visc, visc_mult_vals,
+                                       c_vals_ads, ads_vals,
+                                       water_vel_vals, shear_vrf_vals);
+    checkLookups(props);
+}
+
+BOOST_AUTO_TEST_CASE(Set)
+{
+    Opm::PolymerProperties props;
+    props.set(2.0, 0.5, 1000.0, 0.1, 1.2, 1.0e-5,
+              Opm::PolymerProperties::Desorption,
+              c_vals_visc, visc_mult_vals,
+              c_vals_ads, ads_vals,
+              water_vel_vals, shear_vrf_vals);
+    checkLookups(props);
+}
@@ -0,0 +1,96 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE PreconditionerReusePolicyTest
+
+#include <opm/autodiff/PreconditionerReusePolicy.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+using Opm::PreconditionerReusePolicy;
+
+BOOST_AUTO_TEST_CASE(RebuildEverySolve)
+{
+    PreconditionerReusePolicy policy;
+    for (int i = 0; i < 3; ++i) {
+        BOOST_CHECK(policy.needsSetup(false));
+        policy.setupDone();
+        policy.solveDone(5, true);
+    }
+    BOOST_CHECK_EQUAL(policy.setups(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(ReuseUntilMaxAge)
+{
+    PreconditionerReusePolicy policy(PreconditionerReusePolicy::ReuseAll, 3, 2.0);
+    BOOST_CHECK(policy.needsSetup(false));
+    policy.setupDone();
+    policy.solveDone(10, true);
+    BOOST_CHECK(!policy.needsSetup(false));
+    policy.solveDone(12, true);
+    BOOST_CHECK(!policy.needsSetup(false));
+    // A changed structure always requires a new setup.
+    BOOST_CHECK(policy.needsSetup(true));
+    policy.solveDone(12, true);
+    BOOST_CHECK(policy.needsSetup(false));
+    BOOST_CHECK_EQUAL(policy.setups(), 1);
+    BOOST_CHECK_EQUAL(policy.solves(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(StaleSetup)
+{
+    PreconditionerReusePolicy policy(PreconditionerReusePolicy::ReuseAggregation, 100, 1.5);
+    policy.setupDone();
+    policy.solveDone(10, true);
+    policy.solveDone(15, true);
+    BOOST_CHECK(!policy.needsSetup(false));
+    policy.solveDone(16, true);
+    BOOST_CHECK(policy.needsSetup(false));
+
+    // The iteration count of the first solve after a setup is the new reference.
+    policy.setupDone();
+    policy.solveDone(20, true);
+    policy.solveDone(30, true);
+    BOOST_CHECK(!policy.needsSetup(false));
+    policy.solveDone(3, false);
+    BOOST_CHECK(policy.needsSetup(false));
+
+    policy.setupDone();
+    policy.invalidate();
+    BOOST_CHECK(policy.needsSetup(false));
+}
+
+BOOST_AUTO_TEST_CASE(FromParameters)
+{
+    Opm::ParameterGroup param;
+    PreconditionerReusePolicy defaults(param);
+    BOOST_CHECK_EQUAL(defaults.mode(), PreconditionerReusePolicy::Rebuild);
+    BOOST_CHECK_EQUAL(defaults.maxAge(), 1);
+
+    // Each preconditioner reads its own parameters.
+    param.insertParameter("cpr_reuse_setup", "2");
+    param.insertParameter("linear_solver_mixed_precision_reuse_setup", "1");
+    param.insertParameter("linear_solver_mixed_precision_reuse_max_age", "4");
+    const PreconditionerReusePolicy cpr(param);
+    BOOST_CHECK_EQUAL(cpr.mode(), PreconditionerReusePolicy::ReuseAggregation);
+    BOOST_CHECK_EQUAL(cpr.maxAge(), 10);
+    const PreconditionerReusePolicy mixed(param, "linear_solver_mixed_precision_");
+    BOOST_CHECK_EQUAL(mixed.mode(), PreconditionerReusePolicy::ReuseAll);
+    BOOST_CHECK_EQUAL(mixed.maxAge(), 4);
+}
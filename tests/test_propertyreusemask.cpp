@@ -0,0 +1,132 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE PropertyReuseMaskTest
+
+#include <opm/autodiff/PropertyReuseMask.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+namespace
+{
+    typedef Opm::PropertyReuseMask::ADB ADB;
+
+    struct State
+    {
+        std::vector<double> p = { 100e5, 200e5, 300e5, 400e5 };
+        std::vector<double> s = { 0.2, 0.8, 0.3, 0.7, 0.4, 0.6, 0.5, 0.5 };
+        std::vector<double> rs = { 10.0, 20.0, 0.0, 40.0 };
+        std::vector<int> vars = { 0, 0, 1, 1 };
+    };
+
+    void update(Opm::PropertyReuseMask& mask, const State& x)
+    {
+        mask.update(x.p, x.s, 2, x.rs, std::vector<double>(), x.vars);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(Disabled)
+{
+    Opm::PropertyReuseMask mask;
+    BOOST_CHECK(!mask.enabled());
+    State x;
+    update(mask, x);
+    update(mask, x);
+    BOOST_CHECK(mask.allDirty());
+    BOOST_CHECK_EQUAL(mask.dirtyCells().size(), 4u);
+}
+
+BOOST_AUTO_TEST_CASE(DirtyCells)
+{
+    Opm::PropertyReuseMask mask(1e-3);
+    State x;
+    update(mask, x);
+    BOOST_CHECK(mask.allDirty());
+
+    // Unchanged.
+    update(mask, x);
+    BOOST_CHECK(mask.dirtyCells().empty());
+    BOOST_CHECK_EQUAL(mask.cleanCells().size(), 4u);
+
+    // Below the tolerance everywhere except in cell 1 (pressure),
+    // cell 2 (rs from zero) and cell 3 (choice of variables).
+    x.p[0] *= 1.0 + 0.5e-3;
+    x.s[0] += 0.5e-3;
+    x.p[1] *= 1.0 + 2e-3;
+    x.rs[2] = 1e-6;
+    x.vars[3] = 2;
+    update(mask, x);
+    BOOST_CHECK(mask.dirtyCells() == std::vector<int>({ 1, 2, 3 }));
+    BOOST_CHECK(mask.cleanCells() == std::vector<int>({ 0 }));
+
+    // The comparison is with the state of the last evaluation, so
+    // small changes in cell 0 add up until it is refreshed.
+    x.p[0] *= 1.0 + 0.6e-3;
+    update(mask, x);
+    BOOST_CHECK(mask.dirtyCells() == std::vector<int>({ 0 }));
+    update(mask, x);
+    BOOST_CHECK(mask.dirtyCells().empty());
+
+    // Saturation.
+    x.s[7] -= 2e-3;
+    update(mask, x);
+    BOOST_CHECK(mask.dirtyCells() == std::vector<int>({ 3 }));
+
+    mask.invalidate();
+    update(mask, x);
+    BOOST_CHECK(mask.allDirty());
+}
+
+BOOST_AUTO_TEST_CASE(Merge)
+{
+    Opm::PropertyReuseMask mask(1e-3);
+    State x;
+    update(mask, x);
+    x.p[1] *= 1.1;
+    x.p[3] *= 1.1;
+    update(mask, x);
+    BOOST_REQUIRE(mask.dirtyCells() == std::vector<int>({ 1, 3 }));
+
+    ADB::V v0(4);
+    v0 << 1.0, 2.0, 3.0, 4.0;
+    ADB::V w0(2);
+    w0 << 5.0, 6.0;
+    std::vector<ADB::V> vals = { v0, w0 };
+    const std::vector<ADB> vars = ADB::variables(vals);
+    const ADB cached = vars[0]*vars[0];
+    const ADB fresh = subset(vars[0], mask.dirtyCells())*10.0;
+
+    const ADB merged = mask.merge(cached, fresh);
+    BOOST_REQUIRE_EQUAL(merged.size(), 4);
+    BOOST_REQUIRE_EQUAL(merged.numBlocks(), 2);
+    const double expected_value[] = { 1.0, 20.0, 9.0, 40.0 };
+    const double expected_deriv[] = { 2.0, 10.0, 6.0, 10.0 };
+    Eigen::SparseMatrix<double> jac;
+    merged.derivative()[0].toSparse(jac);
+    const Eigen::MatrixXd dense = jac;
+    for (int c = 0; c < 4; ++c) {
+        BOOST_CHECK_EQUAL(merged.value()[c], expected_value[c]);
+        for (int j = 0; j < 4; ++j) {
+            BOOST_CHECK_EQUAL(dense(c, j), c == j ? expected_deriv[c] : 0.0);
+        }
+    }
+    BOOST_CHECK_EQUAL(merged.derivative()[1].nonZeros(), 0);
+}
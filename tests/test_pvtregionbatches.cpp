@@ -0,0 +1,77 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE PvtRegionBatchesTest
+
+#include <opm/autodiff/PvtRegionBatches.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <utility>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(SingleRegion)
+{
+    const std::vector<int> region_of_cell(10, 2);
+    const std::vector<int> cells = { 7, 3, 5 };
+    const Opm::PvtRegionBatches batches(region_of_cell, cells);
+    BOOST_CHECK_EQUAL(batches.numBatches(), 1);
+    BOOST_CHECK_EQUAL(batches.region(0), 2);
+
+    std::vector<std::pair<int, int>> visited;
+    batches.forEach([&](const int region, const int i) { visited.emplace_back(region, i); });
+    const std::vector<std::pair<int, int>> expected = { {2, 0}, {2, 1}, {2, 2} };
+    BOOST_CHECK(visited == expected);
+}
+
+BOOST_AUTO_TEST_CASE(SeveralRegions)
+{
+    // Cells 0..7 in regions 1, 3, 1, 0, 3, 3, 1, 0; region 2 is unused.
+    const std::vector<int> region_of_cell = { 1, 3, 1, 0, 3, 3, 1, 0 };
+    const std::vector<int> cells = { 4, 0, 3, 6, 1, 7 };
+    const Opm::PvtRegionBatches batches(region_of_cell, cells);
+    BOOST_CHECK_EQUAL(batches.size(), 6);
+    BOOST_REQUIRE_EQUAL(batches.numBatches(), 3);
+    BOOST_CHECK_EQUAL(batches.region(0), 0);
+    BOOST_CHECK_EQUAL(batches.region(1), 1);
+    BOOST_CHECK_EQUAL(batches.region(2), 3);
+
+    // Grouped by region, in the order of the cell array within a region.
+    std::vector<std::pair<int, int>> visited;
+    batches.forEach([&](const int region, const int i) { visited.emplace_back(region, i); });
+    const std::vector<std::pair<int, int>> expected = { {0, 2}, {0, 5}, {1, 1}, {1, 3}, {3, 0}, {3, 4} };
+    BOOST_CHECK(visited == expected);
+}
+
+BOOST_AUTO_TEST_CASE(Empty)
+{
+    const std::vector<int> region_of_cell = { 0, 1 };
+    const Opm::PvtRegionBatches batches(region_of_cell, std::vector<int>());
+    BOOST_CHECK_EQUAL(batches.size(), 0);
+    BOOST_CHECK_EQUAL(batches.numBatches(), 0);
+    int calls = 0;
+    batches.forEach([&](const int, const int) { ++calls; });
+    BOOST_CHECK_EQUAL(calls, 0);
+
+    const Opm::PvtRegionBatches none;
+    BOOST_CHECK_EQUAL(none.size(), 0);
+    BOOST_CHECK_EQUAL(none.numBatches(), 0);
+    none.forEach([&](const int, const int) { ++calls; });
+    BOOST_CHECK_EQUAL(calls, 0);
+}
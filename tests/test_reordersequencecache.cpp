@@ -0,0 +1,188 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE ReorderSequenceCacheTest
+
+#include <opm/common/utility/platform_dependent/disable_warnings.h>
+#include <boost/test/unit_test.hpp>
+#include <opm/common/utility/platform_dependent/reenable_warnings.h>
+
+#include <opm/core/transport/reorder/ReorderSequenceCache.hpp>
+#include <opm/core/transport/reorder/reordersequence.h>
+#include <opm/grid/GridManager.hpp>
+#include <opm/grid/UnstructuredGrid.h>
+
+#include <algorithm>
+#include <vector>
+
+using namespace Opm;
+
+namespace
+{
+    // Flux from the lower to the higher numbered cell over every face.
+    std::vector<double> monotoneFlux(const UnstructuredGrid& grid)
+    {
+        std::vector<double> flux(grid.number_of_faces, 0.0);
+        for (int f = 0; f < grid.number_of_faces; ++f) {
+            const int c0 = grid.face_cells[2*f];
+            const int c1 = grid.face_cells[2*f + 1];
+            if (c0 >= 0 && c1 >= 0) {
+                flux[f] = c0 < c1 ? 1.0 : -1.0;
+            }
+        }
+        return flux;
+    }
+
+    int faceBetween(const UnstructuredGrid& grid, const int a, const int b)
+    {
+        for (int f = 0; f < grid.number_of_faces; ++f) {
+            const int c0 = grid.face_cells[2*f];
+            const int c1 = grid.face_cells[2*f + 1];
+            if ((c0 == a && c1 == b) || (c0 == b && c1 == a)) {
+                return f;
+            }
+        }
+        return -1;
+    }
+
+    // Label every cell by the smallest cell in its component.
+    std::vector<int> componentLabels(const std::vector<int>& sequence,
+                                     const std::vector<int>& components,
+                                     const int ncomp)
+    {
+        std::vector<int> label(sequence.size());
+        for (int k = 0; k < ncomp; ++k) {
+            const int first = *std::min_element(sequence.begin() + components[k],
+                                                sequence.begin() + components[k + 1]);
+            for (int p = components[k]; p < components[k + 1]; ++p) {
+                label[sequence[p]] = first;
+            }
+        }
+        return label;
+    }
+
+    // Check that the cache holds the same components as a fresh
+    // computation, in an order that respects every upwind dependency.
+    void checkAgainstFresh(const UnstructuredGrid& grid,
+                           const std::vector<double>& flux,
+                           const ReorderSequenceCache& cache)
+    {
+        const int nc = grid.number_of_cells;
+        std::vector<int> sequence(nc);
+        std::vector<int> components(nc + 1);
+        int ncomp = 0;
+        compute_sequence(&grid, flux.data(), sequence.data(), components.data(), &ncomp);
+        BOOST_REQUIRE_EQUAL(cache.numComponents(), ncomp);
+        const auto fresh = componentLabels(sequence, components, ncomp);
+        const auto cached = componentLabels(cache.sequence(), cache.components(), ncomp);
+        BOOST_CHECK(fresh == cached);
+
+        std::vector<int> comp_of_cell(nc);
+        for (int k = 0; k < ncomp; ++k) {
+            for (int p = cache.components()[k]; p < cache.components()[k + 1]; ++p) {
+                comp_of_cell[cache.sequence()[p]] = k;
+            }
+        }
+        for (int f = 0; f < grid.number_of_faces; ++f) {
+            const int c0 = grid.face_cells[2*f];
+            const int c1 = grid.face_cells[2*f + 1];
+            if (c0 < 0 || c1 < 0 || flux[f] == 0.0) {
+                continue;
+            }
+            const int up = flux[f] > 0.0 ? c0 : c1;
+            const int down = flux[f] > 0.0 ? c1 : c0;
+            BOOST_CHECK(comp_of_cell[up] <= comp_of_cell[down]);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ReuseAndRepair)
+{
+    const GridManager gm(6, 5);
+    const UnstructuredGrid& grid = *gm.c_grid();
+    ReorderSequenceCache cache(0.5, 0.5);
+
+    std::vector<double> flux = monotoneFlux(grid);
+    BOOST_CHECK_EQUAL(cache.update(grid, flux.data()), ReorderSequenceCache::Computed);
+    checkAgainstFresh(grid, flux, cache);
+    const std::vector<int> first_sequence = cache.sequence();
+
+    // Same signs, different magnitudes: reuse.
+    for (double& v : flux) {
+        v *= 2.0;
+    }
+    BOOST_CHECK_EQUAL(cache.update(grid, flux.data()), ReorderSequenceCache::Reused);
+    BOOST_CHECK(cache.sequence() == first_sequence);
+
+    // Reversing the face between cells 7 and 8 gives 8 -> 7 -> 13 -> 14
+    // and 8 -> 14, which is still acyclic but breaks the order.
+    const int f78 = faceBetween(grid, 7, 8);
+    BOOST_REQUIRE(f78 >= 0);
+    flux[f78] = -flux[f78];
+    BOOST_CHECK_EQUAL(cache.update(grid, flux.data()), ReorderSequenceCache::Repaired);
+    checkAgainstFresh(grid, flux, cache);
+
+    // Reversing the face between 13 and 7 closes the loop 7 -> 8 -> 14 -> 13 -> 7.
+    const int f713 = faceBetween(grid, 7, 13);
+    const int f1314 = faceBetween(grid, 13, 14);
+    BOOST_REQUIRE(f713 >= 0 && f1314 >= 0);
+    flux[f78] = -flux[f78];
+    flux[f713] = -flux[f713];
+    flux[f1314] = -flux[f1314];
+    BOOST_CHECK_EQUAL(cache.update(grid, flux.data()), ReorderSequenceCache::Repaired);
+    checkAgainstFresh(grid, flux, cache);
+    BOOST_CHECK_EQUAL(cache.numComponents(), grid.number_of_cells - 3);
+
+    // Opening the loop again splits the component.
+    flux[f1314] = 0.0;
+    BOOST_CHECK_EQUAL(cache.update(grid, flux.data()), ReorderSequenceCache::Repaired);
+    checkAgainstFresh(grid, flux, cache);
+    BOOST_CHECK_EQUAL(cache.numComponents(), grid.number_of_cells);
+
+    // Reversing everything needs a full computation.
+    for (double& v : flux) {
+        v = -v;
+    }
+    BOOST_CHECK_EQUAL(cache.update(grid, flux.data()), ReorderSequenceCache::Computed);
+    checkAgainstFresh(grid, flux, cache);
+
+    BOOST_CHECK_EQUAL(cache.numComputed(), 2);
+    BOOST_CHECK_EQUAL(cache.numReused(), 1);
+    BOOST_CHECK_EQUAL(cache.numRepaired(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(RandomFlips)
+{
+    const GridManager gm(20, 20);
+    const UnstructuredGrid& grid = *gm.c_grid();
+    ReorderSequenceCache cache(0.5, 1.0);
+    std::vector<double> flux = monotoneFlux(grid);
+    cache.update(grid, flux.data());
+    unsigned int seed = 12345;
+    for (int round = 0; round < 200; ++round) {
+        for (int k = 0; k < 3; ++k) {
+            seed = seed*1103515245u + 12345u;
+            const int f = (seed >> 8) % grid.number_of_faces;
+            flux[f] = -flux[f];
+        }
+        cache.update(grid, flux.data());
+        checkAgainstFresh(grid, flux, cache);
+    }
+    BOOST_CHECK(cache.numRepaired() > 0);
+}
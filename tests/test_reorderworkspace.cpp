@@ -0,0 +1,126 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE ReorderWorkspaceTest
+
+#include <opm/common/utility/platform_dependent/disable_warnings.h>
+#include <boost/test/unit_test.hpp>
+#include <opm/common/utility/platform_dependent/reenable_warnings.h>
+
+#include <opm/core/transport/reorder/ReorderWorkspace.hpp>
+#include <opm/core/transport/reorder/reordersequence.h>
+#include <opm/grid/GridManager.hpp>
+#include <opm/grid/UnstructuredGrid.h>
+
+#include <algorithm>
+#include <vector>
+
+using namespace Opm;
+
+namespace
+{
+    // Flux with pseudo-random signs and some zeros.
+    std::vector<double> randomFlux(const UnstructuredGrid& grid, unsigned int& seed)
+    {
+        std::vector<double> flux(grid.number_of_faces);
+        for (double& v : flux) {
+            seed = seed*1103515245u + 12345u;
+            v = double(int((seed >> 8) % 5) - 2);
+        }
+        return flux;
+    }
+
+    // Component of every cell.
+    std::vector<int> componentOfCell(const std::vector<int>& sequence,
+                                     const std::vector<int>& components)
+    {
+        std::vector<int> comp(sequence.size());
+        for (int k = 0; k + 1 < int(components.size()); ++k) {
+            for (int p = components[k]; p < components[k + 1]; ++p) {
+                comp[sequence[p]] = k;
+            }
+        }
+        return comp;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(SameAsComputeSequence)
+{
+    const GridManager gm(15, 12);
+    const UnstructuredGrid& grid = *gm.c_grid();
+    const int nc = grid.number_of_cells;
+    ReorderWorkspace workspace;
+    unsigned int seed = 42;
+    for (int round = 0; round < 20; ++round) {
+        const std::vector<double> flux = randomFlux(grid, seed);
+        std::vector<int> sequence(nc);
+        std::vector<int> components(nc + 1);
+        int ncomp = 0;
+        compute_sequence(&grid, flux.data(), sequence.data(), components.data(), &ncomp);
+        components.resize(ncomp + 1);
+
+        workspace.compute(grid, flux.data());
+        BOOST_CHECK(workspace.sequence() == sequence);
+        BOOST_CHECK(workspace.components() == components);
+        BOOST_CHECK_EQUAL(workspace.numComponents(), ncomp);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(Renumbered)
+{
+    const GridManager gm(15, 12);
+    const UnstructuredGrid& grid = *gm.c_grid();
+    const int nc = grid.number_of_cells;
+    ReorderWorkspace workspace(true);
+    unsigned int seed = 7;
+    for (int round = 0; round < 20; ++round) {
+        const std::vector<double> flux = randomFlux(grid, seed);
+        std::vector<int> sequence(nc);
+        std::vector<int> components(nc + 1);
+        int ncomp = 0;
+        compute_sequence(&grid, flux.data(), sequence.data(), components.data(), &ncomp);
+        components.resize(ncomp + 1);
+
+        workspace.compute(grid, flux.data());
+        BOOST_REQUIRE_EQUAL(workspace.numComponents(), ncomp);
+        std::vector<int> sorted = workspace.sequence();
+        std::sort(sorted.begin(), sorted.end());
+        for (int c = 0; c < nc; ++c) {
+            BOOST_REQUIRE_EQUAL(sorted[c], c);
+        }
+
+        // Same partition into components ...
+        const std::vector<int> fresh = componentOfCell(sequence, components);
+        const std::vector<int> mine = componentOfCell(workspace.sequence(), workspace.components());
+        for (int f = 0; f < grid.number_of_faces; ++f) {
+            const int c0 = grid.face_cells[2*f];
+            const int c1 = grid.face_cells[2*f + 1];
+            if (c0 < 0 || c1 < 0) {
+                continue;
+            }
+            BOOST_CHECK_EQUAL(fresh[c0] == fresh[c1], mine[c0] == mine[c1]);
+            // ... in an order that respects the upwind dependencies.
+            if (flux[f] != 0.0) {
+                const int up = flux[f] > 0.0 ? c0 : c1;
+                const int down = flux[f] > 0.0 ? c1 : c0;
+                BOOST_CHECK(mine[up] <= mine[down]);
+            }
+        }
+    }
+}
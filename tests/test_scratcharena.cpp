@@ -0,0 +1,142 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE ScratchArenaTest
+
+#include <opm/autodiff/ScratchArena.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstddef>
+
+namespace
+{
+    bool aligned(const void* p)
+    {
+        return reinterpret_cast<std::size_t>(p) % Opm::ScratchArena::alignment == 0;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ScopesRewind)
+{
+    Opm::ScratchArena arena;
+    double* first = nullptr;
+    {
+        const Opm::ScratchArena::Scope scope(arena);
+        first = arena.allocate<double>(100);
+        BOOST_CHECK(aligned(first));
+        int* second = arena.allocate<int>(3);
+        BOOST_CHECK(aligned(second));
+        BOOST_CHECK(reinterpret_cast<char*>(second) >= reinterpret_cast<char*>(first + 100));
+        {
+            const Opm::ScratchArena::Scope inner(arena);
+            double* third = arena.allocate<double>(10);
+            BOOST_CHECK(reinterpret_cast<char*>(third) > reinterpret_cast<char*>(second));
+        }
+        // The inner scope gave its memory back.
+        const Opm::ScratchArena::Scope inner(arena);
+        double* fourth = arena.allocate<double>(10);
+        BOOST_CHECK(reinterpret_cast<char*>(fourth) > reinterpret_cast<char*>(second));
+        BOOST_CHECK(reinterpret_cast<char*>(fourth) < reinterpret_cast<char*>(second) + 2*Opm::ScratchArena::alignment);
+    }
+    // Same memory again in a new scope.
+    const Opm::ScratchArena::Scope scope(arena);
+    BOOST_CHECK_EQUAL(arena.allocate<double>(100), first);
+}
+
+BOOST_AUTO_TEST_CASE(GrowAndMerge)
+{
+    Opm::ScratchArena arena;
+    const std::size_t n = 100000;
+    {
+        const Opm::ScratchArena::Scope scope(arena);
+        for (int k = 0; k < 5; ++k) {
+            double* p = arena.allocate<double>(n);
+            BOOST_CHECK(aligned(p));
+            // Touch all of it, for the address sanitizer.
+            for (std::size_t i = 0; i < n; ++i) {
+                p[i] = k;
+            }
+        }
+        BOOST_CHECK(arena.numChunks() > 1);
+    }
+    // Merged into one chunk with room for everything.
+    BOOST_CHECK_EQUAL(arena.numChunks(), 1u);
+    const std::size_t capacity = arena.capacity();
+    BOOST_CHECK(capacity >= 5*n*sizeof(double));
+    {
+        const Opm::ScratchArena::Scope scope(arena);
+        for (int k = 0; k < 5; ++k) {
+            arena.allocate<double>(n);
+        }
+    }
+    BOOST_CHECK_EQUAL(arena.numChunks(), 1u);
+    BOOST_CHECK_EQUAL(arena.capacity(), capacity);
+
+    arena.release();
+    BOOST_CHECK_EQUAL(arena.capacity(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(RetainedCapacity)
+{
+    Opm::ScratchArena arena;
+    const std::size_t default_max_retained = Opm::ScratchArena::defaultMaxRetained;
+    BOOST_CHECK_EQUAL(arena.maxRetained(), default_max_retained);
+    const std::size_t n = 100000;
+    arena.setMaxRetained(2*n*sizeof(double));
+    {
+        const Opm::ScratchArena::Scope scope(arena);
+        for (int k = 0; k < 5; ++k) {
+            arena.allocate<double>(n);
+        }
+    }
+    // The excess was freed when the outermost scope ended.
+    BOOST_CHECK(arena.capacity() <= arena.maxRetained());
+    BOOST_CHECK(arena.numChunks() <= 1u);
+
+    // A working set below the cap is kept.
+    {
+        const Opm::ScratchArena::Scope scope(arena);
+        arena.allocate<double>(n);
+    }
+    BOOST_CHECK_EQUAL(arena.numChunks(), 1u);
+    const std::size_t kept = arena.capacity();
+    BOOST_CHECK(kept >= n*sizeof(double));
+    {
+        const Opm::ScratchArena::Scope scope(arena);
+        arena.allocate<double>(n);
+    }
+    BOOST_CHECK_EQUAL(arena.capacity(), kept);
+
+    // Explicit shrinking, e.g. at the end of a time step.
+    arena.shrinkTo(kept);
+    BOOST_CHECK_EQUAL(arena.capacity(), kept);
+    arena.shrinkTo(kept - 1);
+    BOOST_CHECK_EQUAL(arena.capacity(), 0u);
+    {
+        const Opm::ScratchArena::Scope scope(arena);
+        BOOST_CHECK(arena.allocate<double>(n) != nullptr);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ThreadLocal)
+{
+    Opm::ScratchArena& arena = Opm::ScratchArena::threadLocal();
+    BOOST_CHECK_EQUAL(&arena, &Opm::ScratchArena::threadLocal());
+}
@@ -0,0 +1,112 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE ThreadHandleTest
+
+#include <opm/autodiff/ThreadHandle.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    struct AppendCall
+    {
+        std::vector<int>* out;
+        int value;
+        void run()
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            out->push_back(value);
+        }
+    };
+
+    struct CountCall
+    {
+        std::atomic<int>* count;
+        void run() { ++(*count); }
+    };
+
+    struct ThrowCall
+    {
+        void run() { throw std::runtime_error("write failed"); }
+    };
+}
+
+BOOST_AUTO_TEST_CASE(RunsInDispatchOrder)
+{
+    std::vector<int> out;
+    {
+        // Queue size 2 forces dispatch to block on back-pressure.
+        Opm::ThreadHandle handle(true, 1, 2);
+        for (int i = 0; i < 20; ++i) {
+            handle.dispatch(AppendCall{ &out, i });
+        }
+        handle.waitForCompletion();
+
+        const Opm::ThreadHandle::Statistics stats = handle.statistics();
+        BOOST_CHECK_EQUAL(stats.dispatched, 20u);
+        BOOST_CHECK_EQUAL(stats.completed, 20u);
+        BOOST_CHECK_EQUAL(stats.queueDepth, 0u);
+        BOOST_CHECK(stats.maxQueueDepth <= 2u);
+    }
+    BOOST_REQUIRE_EQUAL(out.size(), 20u);
+    for (int i = 0; i < 20; ++i) {
+        BOOST_CHECK_EQUAL(out[i], i);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(DestructorRunsQueuedObjects)
+{
+    std::atomic<int> count(0);
+    {
+        Opm::ThreadHandle handle(true, 3, 0);
+        BOOST_CHECK_EQUAL(handle.numThreads(), 3);
+        for (int i = 0; i < 100; ++i) {
+            handle.dispatch(CountCall{ &count });
+        }
+    }
+    BOOST_CHECK_EQUAL(count.load(), 100);
+}
+
+BOOST_AUTO_TEST_CASE(ExceptionsReachFuture)
+{
+    Opm::ThreadHandle handle(true);
+    std::future<void> failed = handle.dispatch(ThrowCall());
+    BOOST_CHECK_THROW(failed.get(), std::runtime_error);
+
+    std::atomic<int> count(0);
+    handle.dispatch(CountCall{ &count }).get();
+    BOOST_CHECK_EQUAL(count.load(), 1);
+    BOOST_CHECK_EQUAL(handle.statistics().failed, 1u);
+}
+
+BOOST_AUTO_TEST_CASE(NoThread)
+{
+    Opm::ThreadHandle handle(false);
+    std::atomic<int> count(0);
+    BOOST_CHECK_THROW(handle.dispatch(CountCall{ &count }), std::logic_error);
+}
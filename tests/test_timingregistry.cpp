@@ -0,0 +1,121 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE TimingRegistryTest
+
+#include <opm/autodiff/TimingRegistry.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Opm::ScopedTiming;
+using Opm::TimingRegistry;
+
+namespace
+{
+    void assembleOnce()
+    {
+        ScopedTiming timing("assemble");
+        ScopedTiming accum("computeAccum");
+    }
+}
+
+BOOST_AUTO_TEST_CASE(DisabledRecordsNothing)
+{
+    TimingRegistry& registry = TimingRegistry::instance();
+    registry.reset();
+    registry.setEnabled(false);
+    assembleOnce();
+    BOOST_CHECK(registry.paths().empty());
+}
+
+BOOST_AUTO_TEST_CASE(Hierarchy)
+{
+    TimingRegistry& registry = TimingRegistry::instance();
+    registry.reset();
+    registry.setEnabled(true);
+
+    registry.setReportStep(0);
+    assembleOnce();
+    registry.setReportStep(1);
+    assembleOnce();
+    assembleOnce();
+    {
+        ScopedTiming timing("output");
+    }
+    registry.setEnabled(false);
+
+    const std::vector<std::string> paths = registry.paths();
+    BOOST_REQUIRE_EQUAL(paths.size(), 3u);
+    BOOST_CHECK_EQUAL(paths[0], "assemble");
+    BOOST_CHECK_EQUAL(paths[1], "assemble/computeAccum");
+    BOOST_CHECK_EQUAL(paths[2], "output");
+    BOOST_CHECK_EQUAL(registry.total("assemble").calls, 3);
+    BOOST_CHECK_EQUAL(registry.total("assemble/computeAccum").calls, 3);
+    BOOST_CHECK_EQUAL(registry.total("computeAccum").calls, 0);
+    BOOST_CHECK(registry.total("assemble").seconds >= registry.total("assemble/computeAccum").seconds);
+
+    std::ostringstream csv;
+    registry.writeCsv(csv);
+    BOOST_CHECK(csv.str().find("0,assemble,1,") != std::string::npos);
+    BOOST_CHECK(csv.str().find("1,assemble,2,") != std::string::npos);
+    BOOST_CHECK(csv.str().find("total,assemble/computeAccum,3,") != std::string::npos);
+
+    std::ostringstream json;
+    registry.writeJson(json);
+    BOOST_CHECK(json.str().find("\"step\": 1") != std::string::npos);
+    BOOST_CHECK(json.str().find("\"path\": \"assemble/computeAccum\"") != std::string::npos);
+
+    std::ostringstream text;
+    registry.print(text);
+    BOOST_CHECK(text.str().find("  computeAccum") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(Threads)
+{
+    TimingRegistry& registry = TimingRegistry::instance();
+    registry.reset();
+    registry.setEnabled(true);
+    {
+        ScopedTiming timing("solve");
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([]() {
+                for (int i = 0; i < 10; ++i) {
+                    ScopedTiming work("worker");
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+    registry.setEnabled(false);
+
+    // Timers opened on other threads do not nest below "solve".
+    BOOST_CHECK_EQUAL(registry.total("worker").calls, 40);
+    BOOST_CHECK_EQUAL(registry.total("solve").calls, 1);
+    std::ostringstream csv;
+    registry.writeCsv(csv);
+    BOOST_CHECK(csv.str().find("total,worker,40,") != std::string::npos);
+}
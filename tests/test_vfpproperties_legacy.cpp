@@ -602,4 +602,69 @@ BOOST_AUTO_TEST_CASE(InterpolateADBAndQs)
 }
 
 
+
+/**
+ * Test that the derivatives of the ADB bhp are correct for an ND plane,
+ * also when evaluating repeatedly (reusing the cached intervals of the
+ * previous evaluation) with points moving through the table.
+ */
+BOOST_AUTO_TEST_CASE(InterpolatePlaneADBDerivatives)
+{
+    fillDataPlane();
+    initProperties();
+
+    const int num_wells = 3;
+    table_ids.assign(num_wells, 1);
+
+    for (int step = 0; step < 20; ++step) {
+        ADB::V aqua_v(num_wells);
+        ADB::V liquid_v(num_wells);
+        ADB::V vapour_v(num_wells);
+        ADB::V thp_v(num_wells);
+        ADB::V alq_v(num_wells);
+        for (int w = 0; w < num_wells; ++w) {
+            // Rates and fractions within the table, thp and alq moving out of it.
+            const double s = (step + 1) / 20.0;
+            aqua_v[w]   = -0.1*s*(w + 1);
+            liquid_v[w] = -0.5 - 0.4*s;
+            vapour_v[w] = -0.2*(1.0 - s);
+            thp_v[w]    = 1.5*s*(w + 1);
+            alq_v[w]    = 0.1*(step % 5);
+        }
+        const std::vector<ADB> vars = ADB::variables(std::vector<ADB::V>{ aqua_v, liquid_v, vapour_v, thp_v, alq_v });
+
+        const ADB bhp = properties->bhp(table_ids, vars[0], vars[1], vars[2], vars[3], vars[4]);
+        BOOST_REQUIRE_EQUAL(bhp.numBlocks(), 5);
+
+        std::vector<Eigen::MatrixXd> jacs(5);
+        for (int block = 0; block < 5; ++block) {
+            Eigen::SparseMatrix<double> jac;
+            bhp.derivative()[block].toSparse(jac);
+            jacs[block] = Eigen::MatrixXd(jac);
+        }
+
+        for (int w = 0; w < num_wells; ++w) {
+            const double a = aqua_v[w];
+            const double l = liquid_v[w];
+            const double g = vapour_v[w];
+            // bhp = thp + 2*a/l + 3*g/l + 4*alq - 5*l
+            const double reference = thp_v[w] + 2*a/l + 3*g/l + 4*alq_v[w] - 5*l;
+            BOOST_CHECK_SMALL(bhp.value()[w] - reference, max_d_tol);
+            BOOST_CHECK_SMALL(jacs[0](w, w) - 2/l, max_d_tol);
+            BOOST_CHECK_SMALL(jacs[1](w, w) - (-2*a/(l*l) - 3*g/(l*l) - 5), max_d_tol);
+            BOOST_CHECK_SMALL(jacs[2](w, w) - 3/l, max_d_tol);
+            BOOST_CHECK_SMALL(jacs[3](w, w) - 1.0, max_d_tol);
+            BOOST_CHECK_SMALL(jacs[4](w, w) - 4.0, max_d_tol);
+        }
+
+        // A fresh object (without cached intervals) gives the same result.
+        const Opm::VFPProdPropertiesLegacy fresh(table.get());
+        const ADB bhp_fresh = fresh.bhp(table_ids, vars[0], vars[1], vars[2], vars[3], vars[4]);
+        for (int w = 0; w < num_wells; ++w) {
+            BOOST_CHECK_EQUAL(bhp.value()[w], bhp_fresh.value()[w]);
+        }
+    }
+}
+
+
 BOOST_AUTO_TEST_SUITE_END() // Trivial tests
@@ -32,6 +32,7 @@
 
 #include <iostream>
 #include <memory>
+#include <string>
 
 using namespace Opm;
 
@@ -113,3 +114,84 @@ BOOST_AUTO_TEST_CASE(TestPressureDeltas)
         BOOST_CHECK_CLOSE(dp[i], answer[i], 1e-8);
     }
 }
+
+
+
+BOOST_AUTO_TEST_CASE(TestManyWells)
+{
+    // Many wells, with different numbers of perforations, processed
+    // in batches. Each well is a water injector over a column of
+    // perforations, with one unit of water injected at each, so that
+    // the pressure deltas only depend on the position in the well.
+    const int np = 3;
+    const int nw = 500;
+    const double ref_depth = 0.0;
+    const double comp_frac_w[np] = { 1.0, 0.0, 0.0 };
+    const bool allow_crossflow = true;
+    const int max_perf = 7;
+    int nperf = 0;
+    for (int w = 0; w < nw; ++w) {
+        nperf += 1 + w % max_perf;
+    }
+    std::shared_ptr<Wells> wells(create_wells(np, nw, nperf), destroy_wells);
+    BOOST_REQUIRE(wells);
+    std::vector<int> cells(max_perf);
+    std::vector<double> WI(max_perf, 1.0);
+    for (int w = 0; w < nw; ++w) {
+        const int n = 1 + w % max_perf;
+        for (int i = 0; i < n; ++i) {
+            cells[i] = i;
+        }
+        const std::string name = "INJ" + std::to_string(w);
+        const int ok = add_well(INJECTOR, ref_depth, n, comp_frac_w, cells.data(), WI.data(), 0,
+                                name.c_str(), allow_crossflow, wells.get());
+        BOOST_REQUIRE(ok);
+    }
+    PhaseUsage pu;
+    pu.num_phases = 3;
+    pu.phase_used[0] = true;
+    pu.phase_used[1] = true;
+    pu.phase_used[2] = true;
+    pu.phase_pos[0] = 0;
+    pu.phase_pos[1] = 1;
+    pu.phase_pos[2] = 2;
+
+    std::vector<double> rates(nperf*np, 0.0);
+    std::vector<double> b_perf(nperf*np);
+    std::vector<double> z_perf(nperf);
+    std::vector<double> surf_dens(nperf*np);
+    for (int w = 0; w < nw; ++w) {
+        for (int perf = wells->well_connpos[w]; perf < wells->well_connpos[w+1]; ++perf) {
+            const int i = perf - wells->well_connpos[w];
+            rates[perf*np] = 1.0;
+            b_perf[perf*np] = 2.0;
+            b_perf[perf*np + 1] = 3.0;
+            b_perf[perf*np + 2] = 100.0;
+            z_perf[perf] = 10.0 + 20.0*i;
+            surf_dens[perf*np] = 1000.0;
+            surf_dens[perf*np + 1] = 800.0;
+            surf_dens[perf*np + 2] = 10.0;
+        }
+    }
+    const std::vector<double> rsmax_perf(nperf, 50.0);
+    const std::vector<double> rvmax_perf(nperf, 0.01);
+    const double gravity = Opm::unit::gravity;
+
+    const std::vector<double> cd =
+            WellDensitySegmented::computeConnectionDensities(
+                    *wells, pu, rates,
+                    b_perf, rsmax_perf, rvmax_perf, surf_dens);
+    const std::vector<double> dp =
+            WellDensitySegmented::computeConnectionPressureDelta(
+                    *wells, z_perf, cd, gravity);
+
+    BOOST_REQUIRE_EQUAL(dp.size(), std::size_t(nperf));
+    for (int w = 0; w < nw; ++w) {
+        for (int perf = wells->well_connpos[w]; perf < wells->well_connpos[w+1]; ++perf) {
+            // Water only, with density 1000*b = 2000 everywhere.
+            const int i = perf - wells->well_connpos[w];
+            BOOST_CHECK_CLOSE(cd[perf], 2000.0, 1e-8);
+            BOOST_CHECK_CLOSE(dp[perf], (10.0 + 20.0*i)*2000.0*gravity, 1e-8);
+        }
+    }
+}